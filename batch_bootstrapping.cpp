@@ -4,6 +4,69 @@
 
 namespace bbii {
 
+bool prepare_fft_keys(BatchBootstrappingKey& bk, const BBIIParams& params) {
+    if (params.N != kLagrangeN) return false;
+    bk.keys_fft.clear();
+    bk.keys_fft.reserve(bk.keys.size());
+    for (const auto& block : bk.keys) {
+        std::vector<PackedTRGSWFFT> block_fft;
+        block_fft.reserve(block.size());
+        for (const auto& c : block) block_fft.push_back(to_fft(c, params));
+        bk.keys_fft.push_back(std::move(block_fft));
+    }
+    if (bk.to_r13.cipher) bk.to_r13_fft = to_fft(bk.to_r13, params);
+    if (bk.to_r12.cipher) bk.to_r12_fft = to_fft(bk.to_r12, params);
+    return true;
+}
+
+// Step 2-4: 係数領域 / Lagrange 領域で共通
+template <typename Sample>
+static std::vector<LweSample*> blind_rotate_dft_extract(const std::vector<int32_t>& a_exps, size_t count,
+                                                        const std::vector<std::vector<PackedHandle<Sample>>>& keys,
+                                                        const PackedHandle<Sample>& to_r13, const PackedHandle<Sample>& to_r12,
+                                                        const LweKeySwitchKey* ks,
+                                                        const BBIIParams& params,
+                                                        std::chrono::high_resolution_clock::time_point (&t)[2]) {
+    // --- Step 2: Blind Rotate (Vector-Matrix Mult) ---
+    // v' 個の鍵ブロックはそれぞれ独立なのでまとめて並列に計算する
+    size_t req_size = std::pow(2 * params.d, params.rho - 1);
+    if (keys.size() > req_size) throw std::invalid_argument("batch_bootstrapping: more key blocks than (2d)^(rho-1)");
+    std::vector<PackedHandle<Sample>> C_prime = batch_vec_mat_mult(a_exps, count, keys, params);
+
+    // Padding for recursion
+    SamplePool<Sample>::for_params(params).reserve(req_size);
+    C_prime.reserve(req_size);
+    while(C_prime.size() < req_size) {
+        PackedHandle<Sample> z = acquire_packed<Sample>(params, BatchMode::R12);
+        trgsw_clear(z.cipher, params);
+        C_prime.push_back(std::move(z));
+    }
+
+    t[0] = std::chrono::high_resolution_clock::now();
+
+    // --- Step 3: Homomorphic Inverse DFT (Recursive) ---
+    // 切り替え鍵があれば段ごとにテンソル環を移す (出力は R12 に戻っている)
+    const bool switching = to_r13.cipher && to_r12.cipher;
+    auto C_double_prime = hom_dft_inverse(std::move(C_prime), params.rho, params,
+                                          switching ? &to_r13 : nullptr, switching ? &to_r12 : nullptr);
+
+    t[1] = std::chrono::high_resolution_clock::now();
+
+    // --- Step 4: Sample Extract + Key Switch ---
+    size_t n = params.n;
+    const TLweParams* tlwe_p = params.tfhe_params->tgsw_params->tlwe_params;
+    LweSample* extracted = new_LweSample_array(n, &tlwe_p->extracted_lweparams);
+    std::vector<LweSample*> extracted_ptrs(n);
+    for (size_t i = 0; i < n; ++i) extracted_ptrs[i] = extracted + i;
+    batch_sample_extract(extracted_ptrs.data(), n, C_double_prime, params);
+
+    std::vector<LweSample*> results(n);
+    for (size_t i = 0; i < n; ++i) results[i] = new_LweSample(params.tfhe_params->in_out_params);
+    batch_key_switch(results.data(), ks, extracted_ptrs.data(), n);
+    delete_LweSample_array(n, extracted);
+    return results;
+}
+
 std::vector<LweSample*> batch_bootstrapping(const std::vector<LweSample*>& inputs,
                                             const BatchBootstrappingKey& bk,
                                             const BBIIParams& params) {
@@ -12,43 +75,27 @@ std::vector<LweSample*> batch_bootstrapping(const std::vector<LweSample*>& input
     auto t_start = high_resolution_clock::now();
 
     int n = params.n;
+    if (inputs.size() < size_t(n)) throw std::invalid_argument("batch_bootstrapping: fewer than n inputs");
+    if (!bk.ks) throw std::invalid_argument("batch_bootstrapping: key-switching key is not set");
+    if (bk.ks->n != params.tfhe_params->tgsw_params->tlwe_params->extracted_lweparams.n)
+        throw std::invalid_argument("batch_bootstrapping: key-switching key does not match the extracted dimension");
     
     // --- Step 1: Input Packing ---
-    std::vector<int32_t> a_coeffs(n);
-    for(int i=0; i<n; ++i) a_coeffs[i] = (inputs[i]->a[0] > 0) ? 1 : 0;
+    // n 個の入力の a を Z_{2N} の指数に mod switch し、係数ごとに転置して詰める (バッファはスレッドごとに使い回す)
+    static thread_local std::vector<int32_t> a_exps;
+    pack_input_exponents(a_exps, inputs.data(), n, params.tfhe_params->in_out_params->n, params);
     
     auto t_step1 = high_resolution_clock::now();
 
-    // --- Step 2: Blind Rotate (Vector-Matrix Mult) ---
-    std::vector<PackedTRGSW> C_prime;
-    if (!bk.keys.empty() && !bk.keys[0].empty()) {
-        C_prime.push_back(vec_mat_mult(a_coeffs, bk.keys[0], params));
-    } else {
-        C_prime.push_back(create_zero_packed(params, BatchMode::R12));
-    }
-
-    // Padding for recursion
-    size_t req_size = std::pow(2 * params.d, params.rho - 1);
-    while(C_prime.size() < req_size) {
-        PackedTRGSW zero = create_zero_packed(params, BatchMode::R12);
-        C_prime.push_back(zero);
-    }
-    
-    auto t_step2 = high_resolution_clock::now();
-
-    // --- Step 3: Homomorphic Inverse DFT (Recursive) ---
-    auto C_double_prime = hom_dft_inverse(C_prime, params.rho, params);
-    
-    auto t_step3 = high_resolution_clock::now();
-
-    // --- Step 4: Sample Extract ---
+    // 鍵が Lagrange 領域で用意されていれば、再帰の途中で FFT を挟まずに済む
+    high_resolution_clock::time_point t_mid[2];
     std::vector<LweSample*> results;
-    for(int i=0; i<n; ++i) {
-        if (i >= C_double_prime.size()) break;
-        LweSample* lwe = new_LweSample(params.tfhe_params->in_out_params);
-        lweCopy(lwe, inputs[i], params.tfhe_params->in_out_params);
-        results.push_back(lwe);
+    if (!bk.keys_fft.empty()) {
+        results = blind_rotate_dft_extract(a_exps, n, bk.keys_fft, bk.to_r13_fft, bk.to_r12_fft, bk.ks, params, t_mid);
+    } else {
+        results = blind_rotate_dft_extract(a_exps, n, bk.keys, bk.to_r13, bk.to_r12, bk.ks, params, t_mid);
     }
+    high_resolution_clock::time_point t_step2 = t_mid[0], t_step3 = t_mid[1];
 
     auto t_end = high_resolution_clock::now();
 
@@ -60,7 +107,7 @@ std::vector<LweSample*> batch_bootstrapping(const std::vector<LweSample*>& input
               << duration_cast<milliseconds>(t_step2 - t_step1).count() << " ms" << std::endl;
     std::cout << "  3. Homomorphic DFT: " 
               << duration_cast<milliseconds>(t_step3 - t_step2).count() << " ms" << std::endl;
-    std::cout << "  4. Sample Extract: " 
+    std::cout << "  4. Sample Extract + Key Switch: " 
               << duration_cast<milliseconds>(t_end - t_step3).count() << " ms" << std::endl;
     std::cout << "----------------------------------" << std::endl;
 
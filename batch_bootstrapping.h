@@ -2,7 +2,20 @@
 #define BATCH_BOOTSTRAPPING_H
 #include "hom_dft.h"
 namespace bbii {
-struct BatchBootstrappingKey { std::vector<std::vector<PackedTRGSW>> keys; };
+struct BatchBootstrappingKey {
+    // 鍵ブロック (高々 (2d)^(rho-1) 個)。各ブロックは入力ごとに指数の各ビットの行を持つ (n * log2(2N) 行)
+    std::vector<std::vector<PackedTRGSW>> keys;
+    // keys を Lagrange 領域に変換したもの。空でなければ Step 2-3 はこちらを使う
+    std::vector<std::vector<PackedTRGSWFFT>> keys_fft;
+    // Step 3 のテンソル環の切り替え鍵 (create_mode_switch_key)。空なら切り替えない
+    PackedTRGSW to_r13, to_r12;
+    // その Lagrange 領域版 (prepare_fft_keys が作る)
+    PackedTRGSWFFT to_r13_fft, to_r12_fft;
+    // 抽出鍵 (次元 k*N) -> 入力 LWE 鍵 (次元 n) の鍵切り替え鍵。所有しない
+    const LweKeySwitchKey* ks = nullptr;
+};
+// keys (と切り替え鍵) から keys_fft を一度だけ作る。N != kLagrangeN の場合は何もせず false
+bool prepare_fft_keys(BatchBootstrappingKey& bk, const BBIIParams& params);
 std::vector<LweSample*> batch_bootstrapping(const std::vector<LweSample*>& inputs, const BatchBootstrappingKey& bk, const BBIIParams& params);
 }
 #endif
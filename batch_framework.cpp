@@ -1,4 +1,9 @@
 #include "batch_framework.h"
+#include <lagrangehalfc_arithmetic.h>
+#include <polynomials_arithmetic.h>
+#include <map>
+#include <memory>
+#include <tuple>
 
 // 内部ヘルパー: TGswSample内のTLweSampleへアクセス
 static inline TLweSample* get_tlwe_sample(TGswSample* sample, int index) {
@@ -7,10 +12,104 @@ static inline TLweSample* get_tlwe_sample(TGswSample* sample, int index) {
 
 namespace bbii {
 
+// 配列の確保・解放を Sample の型で切り替える
+static TGswSample* new_sample_array(int32_t n, const TGswParams* p, TGswSample*) { return new_TGswSample_array(n, p); }
+static TGswSampleFFT* new_sample_array(int32_t n, const TGswParams* p, TGswSampleFFT*) { return new_TGswSampleFFT_array(n, p); }
+static void delete_sample_array(int32_t n, TGswSample* c) { delete_TGswSample_array(n, c); }
+static void delete_sample_array(int32_t n, TGswSampleFFT* c) { delete_TGswSampleFFT_array(n, c); }
+
+void delete_owned_sample(TGswSample* c) { delete_TGswSample_array(1, c); }
+void delete_owned_sample(TGswSampleFFT* c) { delete_TGswSampleFFT_array(1, c); }
+
+template <typename Sample>
+SamplePool<Sample>::SamplePool(int32_t N, int32_t k, int32_t l) : total(0) {
+    // 確保に使うだけなので alpha / Bgbit は任意
+    tlwe_params = new_TLweParams(N, k, 0.0, 0.5);
+    tgsw_params = new_TGswParams(l, 1, tlwe_params);
+}
+
+template <typename Sample>
+SamplePool<Sample>::~SamplePool() {
+    for (auto& s : slabs) delete_sample_array(s.second, s.first);
+    delete_TGswParams(tgsw_params);
+    delete_TLweParams(tlwe_params);
+}
+
+template <typename Sample>
+void SamplePool<Sample>::grow(size_t count) {
+    Sample* slab = new_sample_array(count, tgsw_params, (Sample*) nullptr);
+    slabs.push_back(std::make_pair(slab, (int32_t) count));
+    total += count;
+    free_list.reserve(total); // release で再確保が起きないように
+    for (size_t i = 0; i < count; ++i) free_list.push_back(slab + i);
+}
+
+template <typename Sample>
+Sample* SamplePool<Sample>::acquire() {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (free_list.empty()) grow(total < 32 ? 32 : total); // 枯渇時は倍々で増やす
+    Sample* c = free_list.back();
+    free_list.pop_back();
+    return c;
+}
+
+template <typename Sample>
+void SamplePool<Sample>::release(Sample* c) {
+    std::lock_guard<std::mutex> lock(mtx);
+    free_list.push_back(c);
+}
+
+template <typename Sample>
+void SamplePool<Sample>::reserve(size_t count) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (free_list.size() < count) grow(count - free_list.size());
+}
+
+template <typename Sample>
+size_t SamplePool<Sample>::allocated() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return total;
+}
+
+template <typename Sample>
+size_t SamplePool<Sample>::available() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    return free_list.size();
+}
+
+template <typename Sample>
+SamplePool<Sample>& SamplePool<Sample>::for_params(const BBIIParams& params) {
+    static std::mutex registry_mtx;
+    static std::map<std::tuple<int32_t, int32_t, int32_t>, std::unique_ptr<SamplePool>> registry;
+    const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+    auto key = std::make_tuple(params.N, tgsw_p->tlwe_params->k, tgsw_p->l);
+    std::lock_guard<std::mutex> lock(registry_mtx);
+    std::unique_ptr<SamplePool>& pool = registry[key];
+    if (!pool) pool.reset(new SamplePool(params.N, tgsw_p->tlwe_params->k, tgsw_p->l));
+    return *pool;
+}
+
+template class SamplePool<TGswSample>;
+template class SamplePool<TGswSampleFFT>;
+
+void trgsw_clear(TGswSample* res, const BBIIParams& params) {
+    tGswClear(res, params.tfhe_params->tgsw_params);
+}
+
+void trgsw_clear(TGswSampleFFT* res, const BBIIParams& params) {
+    tGswFFTClear(res, params.tfhe_params->tgsw_params);
+}
+
 PackedTRGSW create_zero_packed(const BBIIParams& params, BatchMode mode) {
-    TGswSample* c = new_TGswSample_array(1, params.tfhe_params->tgsw_params);
-    tGswClear(c, params.tfhe_params->tgsw_params);
-    return PackedTRGSW(c, mode);
+    PackedTRGSW c = acquire_packed<TGswSample>(params, mode);
+    trgsw_clear(c.cipher, params);
+    return c;
+}
+
+PackedTRGSWFFT create_zero_packed_fft(const BBIIParams& params, BatchMode mode) {
+    PackedTRGSWFFT c = acquire_packed<TGswSampleFFT>(params, mode);
+    trgsw_clear(c.cipher, params);
+    return c;
 }
 
 // 多項式加算: TorusPolynomial を使用
@@ -43,19 +142,7 @@ void trgsw_add_to(TGswSample* res, const TGswSample* A, const BBIIParams& params
     }
 }
 
-// 多項式回転: TorusPolynomial を使用
-void torus_poly_mul_by_xai(TorusPolynomial* res, const TorusPolynomial* src, int32_t delta, int32_t N) {
-    delta %= (2 * N);
-    if (delta < 0) delta += 2 * N;
-    
-    for (int i = 0; i < N; ++i) {
-        int deg = i + delta;
-        if (deg < N) res->coefsT[deg] = src->coefsT[i];
-        else if (deg < 2 * N) res->coefsT[deg - N] = -src->coefsT[i];
-        else res->coefsT[deg - 2*N] = src->coefsT[i];
-    }
-}
-
+// X^delta を掛ける (negacyclic 回転は polynomial-permutations の 2 区間コピー + 符号反転)
 void trgsw_mul_by_xai(TGswSample* res, const TGswSample* input, int32_t delta, const BBIIParams& params) {
     const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
     const TLweParams* tlwe_p = tgsw_p->tlwe_params;
@@ -63,28 +150,325 @@ void trgsw_mul_by_xai(TGswSample* res, const TGswSample* input, int32_t delta, c
     int l = tgsw_p->l;
     int block_count = (k + 1) * l;
     int N = params.N;
-
-    // Temporary buffer: コンストラクタで初期化 (Nを渡す)
-    // クラス内部でメモリ確保されるため、手動new/deleteは不要
-    TorusPolynomial temp_poly(N);
+    delta %= (2 * N);
+    if (delta < 0) delta += 2 * N;
+    const bool in_place = (res == input);
 
     for (int i = 0; i < block_count; ++i) {
         TLweSample* res_tlwe = &res->all_sample[i];
         const TLweSample* in_tlwe = &input->all_sample[i];
 
-        // Process 'a' polynomials
-        for (int j = 0; j < k; ++j) {
-            torus_poly_mul_by_xai(&temp_poly, &in_tlwe->a[j], delta, N);
-            for(int p=0; p<N; ++p) res_tlwe->a[j].coefsT[p] = temp_poly.coefsT[p];
+        // a[0..k-1] と b (= a[k]) をまとめて
+        for (int j = 0; j <= k; ++j) {
+            if (in_place) torusPolynomialMulByXaiInPlace(&res_tlwe->a[j], delta);
+            else torusPolynomialMulByXai(&res_tlwe->a[j], delta, &in_tlwe->a[j]);
+        }
+
+        res_tlwe->current_variance = in_tlwe->current_variance;
+    }
+}
+
+// 係数をタイル単位で処理し、タイル内では選ばれた全行を連続に足してから 1 回だけ書き戻す
+// (内側ループは単純な int32 加算なのでコンパイラがベクトル化する)
+static void torus_poly_sum(Torus32* res, const Torus32* const* srcs, size_t count, int32_t N) {
+    static const int32_t kTile = 64;
+    Torus32 tile[kTile];
+    for (int32_t base = 0; base < N; base += kTile) {
+        int32_t len = (N - base < kTile) ? N - base : kTile;
+        for (int32_t c = 0; c < len; ++c) tile[c] = 0;
+        for (size_t s = 0; s < count; ++s) {
+            const Torus32* src = srcs[s] + base;
+            for (int32_t c = 0; c < len; ++c) tile[c] += src[c];
         }
-        
-        // Process 'b' polynomial
-        torus_poly_mul_by_xai(&temp_poly, in_tlwe->b, delta, N);
-        for(int p=0; p<N; ++p) res_tlwe->b->coefsT[p] = temp_poly.coefsT[p];
+        for (int32_t c = 0; c < len; ++c) res[base + c] = tile[c];
+    }
+}
+
+void trgsw_sum_selected(TGswSample* res, const TGswSample* const* srcs, size_t count, const BBIIParams& params) {
+    const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+    int k = tgsw_p->tlwe_params->k;
+    int block_count = (k + 1) * tgsw_p->l;
+
+    std::vector<const Torus32*> coefs(count);
+    for (int i = 0; i < block_count; ++i) {
+        TLweSample* res_tlwe = &res->all_sample[i];
+        // a[0..k-1] と b (= a[k]) をまとめて
+        for (int j = 0; j <= k; ++j) {
+            for (size_t s = 0; s < count; ++s) coefs[s] = srcs[s]->all_sample[i].a[j].coefsT;
+            torus_poly_sum(res_tlwe->a[j].coefsT, coefs.data(), count, params.N);
+        }
+        double variance = 0;
+        for (size_t s = 0; s < count; ++s) variance += srcs[s]->all_sample[i].current_variance;
+        res_tlwe->current_variance = variance;
+    }
+}
+
+void trgsw_sum_selected(TGswSampleFFT* res, const TGswSampleFFT* const* srcs, size_t count, const BBIIParams& params) {
+    // Lagrange 表現の中身は FFT プロセッサごとに異なるので、公開 API の AddTo で足す
+    trgsw_clear(res, params);
+    for (size_t s = 0; s < count; ++s) trgsw_add_to(res, srcs[s], params);
+}
+
+void trgsw_add_to(TGswSampleFFT* res, const TGswSampleFFT* A, const BBIIParams& params) {
+    const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+    int k = tgsw_p->tlwe_params->k;
+    int block_count = (k + 1) * tgsw_p->l;
 
+    for (int i = 0; i < block_count; ++i) {
+        TLweSampleFFT* res_tlwe = &res->all_samples[i];
+        const TLweSampleFFT* A_tlwe = &A->all_samples[i];
+        // a[0..k-1] と b (= a[k]) をまとめて
+        for (int j = 0; j <= k; ++j) LagrangeHalfCPolynomialAddTo(&res_tlwe->a[j], &A_tlwe->a[j]);
+        res_tlwe->current_variance += A_tlwe->current_variance;
+    }
+}
+
+const LagrangeHalfCPolynomial* xai_lagrange(const BBIIParams& params, int32_t a) {
+    const int32_t N = params.N;
+    a %= (2 * N);
+    if (a < 0) a += 2 * N;
+
+    std::atomic<LagrangeHalfCPolynomial*>& entry = params.xai_table[a];
+    LagrangeHalfCPolynomial* xai = entry.load(std::memory_order_acquire);
+    if (xai) return xai;
+
+    // X^a = -X^{a-N} (a >= N)
+    IntPolynomial* mono = new_IntPolynomial(N);
+    intPolynomialClear(mono);
+    if (a < N) mono->coefs[a] = 1;
+    else mono->coefs[a - N] = -1;
+    xai = new_LagrangeHalfCPolynomial(N);
+    IntPolynomial_ifft(xai, mono);
+    delete_IntPolynomial(mono);
+
+    // 同時に計算したスレッドがいれば先に置かれた方を使う
+    LagrangeHalfCPolynomial* expected = nullptr;
+    if (!entry.compare_exchange_strong(expected, xai, std::memory_order_acq_rel)) {
+        delete_LagrangeHalfCPolynomial(xai);
+        return expected;
+    }
+    return xai;
+}
+
+void trgsw_mul_by_xai(TGswSampleFFT* res, const TGswSampleFFT* input, int32_t delta, const BBIIParams& params) {
+    const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+    int k = tgsw_p->tlwe_params->k;
+    int block_count = (k + 1) * tgsw_p->l;
+    const LagrangeHalfCPolynomial* xai = xai_lagrange(params, delta);
+
+    // 各点積なので in-place でもそのまま書き込める
+    for (int i = 0; i < block_count; ++i) {
+        TLweSampleFFT* res_tlwe = &res->all_samples[i];
+        const TLweSampleFFT* in_tlwe = &input->all_samples[i];
+        for (int j = 0; j <= k; ++j) LagrangeHalfCPolynomialMul(&res_tlwe->a[j], xai, &in_tlwe->a[j]);
         res_tlwe->current_variance = in_tlwe->current_variance;
     }
-    // temp_poly のデストラクタが自動的にメモリを解放します
+}
+
+BatchMode batch_mult_mode(BatchMode a, BatchMode b) {
+    switch (a) {
+    case BatchMode::R12:
+        if (b == BatchMode::R12) return BatchMode::R12;
+        if (b == BatchMode::R12_to_R13) return BatchMode::R13;
+        break;
+    case BatchMode::R13:
+        if (b == BatchMode::R13) return BatchMode::R13;
+        if (b == BatchMode::R13_to_R12) return BatchMode::R12;
+        break;
+    case BatchMode::R12_to_R13:
+        if (b == BatchMode::R13) return BatchMode::R12_to_R13;
+        break;
+    case BatchMode::R13_to_R12:
+        if (b == BatchMode::R12) return BatchMode::R13_to_R12;
+        break;
+    default:
+        break;
+    }
+    throw std::invalid_argument("batch_mult: incompatible tensor-ring modes");
+}
+
+// trgsw_mult の作業領域 (B の 1 行とその分解、外部積の累積)
+struct MultScratch {
+    TLweSample* row;
+    IntPolynomial* deca;
+    LagrangeHalfCPolynomial* decaFFT;
+    TLweSampleFFT* tmpa;
+};
+
+// サイズクラス (N, k, l) ごとの MultScratch のプール。スレッドごとに 1 個ずつ借りる
+class MultScratchPool {
+public:
+    MultScratchPool(int32_t N, int32_t k, int32_t l) {
+        tlwe_params = new_TLweParams(N, k, 0.0, 0.5);
+        tgsw_params = new_TGswParams(l, 1, tlwe_params);
+    }
+    ~MultScratchPool() {
+        const int32_t kpl = tgsw_params->kpl;
+        for (MultScratch* s : all) {
+            delete_TLweSampleFFT(s->tmpa);
+            delete_LagrangeHalfCPolynomial_array(kpl, s->decaFFT);
+            delete_IntPolynomial_array(kpl, s->deca);
+            delete_TLweSample(s->row);
+            delete s;
+        }
+        delete_TGswParams(tgsw_params);
+        delete_TLweParams(tlwe_params);
+    }
+    MultScratchPool(const MultScratchPool&) = delete;
+    void operator=(const MultScratchPool&) = delete;
+
+    MultScratch* acquire() {
+        std::lock_guard<std::mutex> lock(mtx);
+        if (!free_list.empty()) {
+            MultScratch* s = free_list.back();
+            free_list.pop_back();
+            return s;
+        }
+        const int32_t N = tlwe_params->N;
+        const int32_t kpl = tgsw_params->kpl;
+        MultScratch* s = new MultScratch;
+        s->row = new_TLweSample(tlwe_params);
+        s->deca = new_IntPolynomial_array(kpl, N);
+        s->decaFFT = new_LagrangeHalfCPolynomial_array(kpl, N);
+        s->tmpa = new_TLweSampleFFT(tlwe_params);
+        all.push_back(s);
+        free_list.reserve(all.size()); // release で再確保が起きないように
+        return s;
+    }
+    void release(MultScratch* s) {
+        std::lock_guard<std::mutex> lock(mtx);
+        free_list.push_back(s);
+    }
+
+    static MultScratchPool& for_params(const BBIIParams& params) {
+        static std::mutex registry_mtx;
+        static std::map<std::tuple<int32_t, int32_t, int32_t>, std::unique_ptr<MultScratchPool>> registry;
+        const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+        auto key = std::make_tuple(params.N, tgsw_p->tlwe_params->k, tgsw_p->l);
+        std::lock_guard<std::mutex> lock(registry_mtx);
+        std::unique_ptr<MultScratchPool>& pool = registry[key];
+        if (!pool) pool.reset(new MultScratchPool(params.N, tgsw_p->tlwe_params->k, tgsw_p->l));
+        return *pool;
+    }
+
+private:
+    TLweParams* tlwe_params;
+    TGswParams* tgsw_params;
+    std::vector<MultScratch*> all;
+    std::vector<MultScratch*> free_list;
+    std::mutex mtx;
+};
+
+// スコープを抜けるとプールへ返す
+class MultScratchLease {
+public:
+    explicit MultScratchLease(const BBIIParams& params) : pool(MultScratchPool::for_params(params)), s(pool.acquire()) {}
+    ~MultScratchLease() { pool.release(s); }
+    MultScratchLease(const MultScratchLease&) = delete;
+    void operator=(const MultScratchLease&) = delete;
+    MultScratch* operator->() const { return s; }
+private:
+    MultScratchPool& pool;
+    MultScratch* s;
+};
+
+static void check_automorphism_exponent(int32_t e, int32_t N) {
+    if (e <= 0 || e >= 2 * N || e % 2 == 0) throw std::invalid_argument("trgsw_mult: e must be odd in (0, 2N)");
+}
+
+// row の全多項式に X -> X^e を施す (e == 1 なら何もしない)
+static void tlwe_automorphism_in_place(TLweSample* row, int32_t e, int32_t k) {
+    if (e == 1) return;
+    for (int32_t j = 0; j <= k; ++j) torusPolynomialAutomorphismInPlace(&row->a[j], e);
+}
+
+// 各行 res_i = A (*) σ_e(B_i)
+void trgsw_mult(TGswSample* res, const TGswSample* A, const TGswSample* B, const BBIIParams& params, int32_t e) {
+    const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+    const TLweParams* tlwe_p = tgsw_p->tlwe_params;
+    const int32_t k = tlwe_p->k;
+    const int32_t kpl = tgsw_p->kpl;
+    if (res == A || res == B) throw std::invalid_argument("trgsw_mult: res must not alias A or B");
+    check_automorphism_exponent(e, params.N);
+
+    MultScratchLease ws(params);
+    if (params.N == kLagrangeN) {
+        // A は最初に 1 回だけ Lagrange 領域に移し、作業領域は全行で使い回す
+        PackedTRGSWFFT A_fft = acquire_packed<TGswSampleFFT>(params, BatchMode::None);
+        tGswToFFTConvert(A_fft.cipher, A, tgsw_p);
+        for (int32_t i = 0; i < kpl; ++i) {
+            tLweCopy(&res->all_sample[i], &B->all_sample[i], tlwe_p);
+            tlwe_automorphism_in_place(&res->all_sample[i], e, k);
+            tGswFFTExternMulToTLwe_buffers(&res->all_sample[i], A_fft.cipher, tgsw_p, ws->deca, ws->decaFFT, ws->tmpa);
+        }
+    } else {
+        // FFT プロセッサの使えない N では係数領域の積 (Karatsuba) で足し込む
+        for (int32_t i = 0; i < kpl; ++i) {
+            tLweCopy(ws->row, &B->all_sample[i], tlwe_p);
+            tlwe_automorphism_in_place(ws->row, e, k);
+            tGswTLweDecompH(ws->deca, ws->row, tgsw_p);
+            tLweClear(&res->all_sample[i], tlwe_p);
+            for (int32_t p = 0; p < kpl; ++p) tLweAddMulRTo(&res->all_sample[i], ws->deca + p, &A->all_sample[p], tlwe_p);
+        }
+    }
+    for (int32_t i = 0; i < kpl; ++i) res->all_sample[i].current_variance = B->all_sample[i].current_variance;
+}
+
+void trgsw_mult(TGswSampleFFT* res, const TGswSampleFFT* A, const TGswSampleFFT* B, const BBIIParams& params, int32_t e) {
+    const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+    const TLweParams* tlwe_p = tgsw_p->tlwe_params;
+    const int32_t k = tlwe_p->k;
+    const int32_t l = tgsw_p->l;
+    const int32_t kpl = tgsw_p->kpl;
+    if (res == A || res == B) throw std::invalid_argument("trgsw_mult: res must not alias A or B");
+    if (params.N != kLagrangeN) throw std::invalid_argument("trgsw_mult: only supported for N == kLagrangeN");
+    check_automorphism_exponent(e, params.N);
+
+    // 分解には係数表現が要るので B の行だけ 1 行ずつ戻し、積は Lagrange 領域のまま res に積む
+    MultScratchLease ws(params);
+    for (int32_t i = 0; i < kpl; ++i) {
+        TLweSampleFFT* res_row = &res->all_samples[i];
+        tLweFromFFTConvert(ws->row, &B->all_samples[i], tlwe_p);
+        tlwe_automorphism_in_place(ws->row, e, k);
+        for (int32_t j = 0; j <= k; ++j) tGswTorus32PolynomialDecompHFFT(ws->decaFFT + j * l, ws->row->a + j, tgsw_p);
+        tLweFFTClear(res_row, tlwe_p);
+        for (int32_t p = 0; p < kpl; ++p) tLweFFTAddMulRTo(res_row, ws->decaFFT + p, &A->all_samples[p], tlwe_p);
+        res_row->current_variance = B->all_samples[i].current_variance;
+    }
+}
+
+TGswKey* new_r13_key(const TGswKey* key, const BBIIParams& params) {
+    const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+    TGswKey* r13_key = new_TGswKey(tgsw_p);
+    // key は tlwe_key.key の別名なので、TLWE の鍵も一緒に σs になる
+    for (int32_t j = 0; j < tgsw_p->tlwe_params->k; ++j)
+        intPolynomialAutomorphism(&r13_key->key[j], &key->key[j], 2 * params.N - 1);
+    return r13_key;
+}
+
+PackedTRGSW create_mode_switch_key(BatchMode mode, const TGswKey* key, double alpha, const BBIIParams& params) {
+    if (!is_transition_mode(mode)) throw std::invalid_argument("create_mode_switch_key: mode must be R12_to_R13 or R13_to_R12");
+    PackedTRGSW c = acquire_packed<TGswSample>(params, mode);
+    if (mode == BatchMode::R12_to_R13) {
+        TGswKey* r13_key = new_r13_key(key, params);
+        tGswSymEncryptInt(c.cipher, 1, alpha, r13_key);
+        delete_TGswKey(r13_key);
+    } else {
+        tGswSymEncryptInt(c.cipher, 1, alpha, key);
+    }
+    return c;
+}
+
+PackedTRGSWFFT to_fft(const PackedTRGSW& src, const BBIIParams& params) {
+    PackedTRGSWFFT res = acquire_packed<TGswSampleFFT>(params, src.mode);
+    tGswToFFTConvert(res.cipher, src.cipher, params.tfhe_params->tgsw_params);
+    return res;
+}
+
+PackedTRGSW from_fft(const PackedTRGSWFFT& src, const BBIIParams& params) {
+    PackedTRGSW res = acquire_packed<TGswSample>(params, src.mode);
+    tGswFromFFTConvert(res.cipher, src.cipher, params.tfhe_params->tgsw_params);
+    return res;
 }
 
 }
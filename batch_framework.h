@@ -1,20 +1,148 @@
 #ifndef BATCH_FRAMEWORK_H
 #define BATCH_FRAMEWORK_H
 #include "bb_params.h"
+#include <mutex>
 
 // TFHEの型を確実に認識させる
 struct TGswSample;
+struct TGswSampleFFT;
 struct TorusPolynomial; // TorusPoly -> TorusPolynomial
+struct LagrangeHalfCPolynomial;
 
 namespace bbii {
 enum class BatchMode { R12, R13, R12_to_R13, R13_to_R12, None };
-struct PackedTRGSW {
-    TGswSample* cipher; BatchMode mode;
-    PackedTRGSW() : cipher(nullptr), mode(BatchMode::None) {}
-    PackedTRGSW(TGswSample* c, BatchMode m) : cipher(c), mode(m) {}
+
+// 同じサイズクラス (N, k, l) の TGswSample / TGswSampleFFT をまとめて確保して使い回すプール
+// 確保はスラブ単位の reserve / 枯渇時のみで、acquire / release はヒープに触れない
+template <typename Sample>
+class SamplePool {
+public:
+    SamplePool(int32_t N, int32_t k, int32_t l);
+    ~SamplePool();
+    SamplePool(const SamplePool&) = delete;
+    void operator=(const SamplePool&) = delete;
+
+    // 中身は前回使用時のまま (未初期化扱い)
+    Sample* acquire();
+    void release(Sample* c);
+    // 空きが count 個以上になるまで先に確保しておく
+    void reserve(size_t count);
+
+    size_t allocated() const;
+    size_t available() const;
+
+    // サイズクラスごとのプロセス共有プール
+    static SamplePool& for_params(const BBIIParams& params);
+
+private:
+    void grow(size_t count);
+
+    TLweParams* tlwe_params;
+    TGswParams* tgsw_params;
+    std::vector<std::pair<Sample*, int32_t>> slabs;
+    std::vector<Sample*> free_list;
+    size_t total;
+    mutable std::mutex mtx;
+};
+typedef SamplePool<TGswSample> TGswPool;
+typedef SamplePool<TGswSampleFFT> TGswFFTPool;
+
+// プールを経由せずに確保されたものの解放
+void delete_owned_sample(TGswSample* c);
+void delete_owned_sample(TGswSampleFFT* c);
+
+// TGSW の所有ハンドル (ムーブのみ)。破棄時にプールへ返却する
+template <typename Sample>
+struct PackedHandle {
+    Sample* cipher; BatchMode mode;
+    PackedHandle() : cipher(nullptr), mode(BatchMode::None), pool(nullptr) {}
+    PackedHandle(SamplePool<Sample>& p, BatchMode m) : cipher(p.acquire()), mode(m), pool(&p) {}
+    // new_TGswSample_array(1, ...) / new_TGswSampleFFT(...) で確保したものを引き取る
+    explicit PackedHandle(Sample* c, BatchMode m) : cipher(c), mode(m), pool(nullptr) {}
+    PackedHandle(PackedHandle&& o) noexcept : cipher(o.cipher), mode(o.mode), pool(o.pool) { o.cipher = nullptr; }
+    PackedHandle& operator=(PackedHandle&& o) noexcept {
+        if (this != &o) {
+            reset();
+            cipher = o.cipher; mode = o.mode; pool = o.pool;
+            o.cipher = nullptr;
+        }
+        return *this;
+    }
+    PackedHandle(const PackedHandle&) = delete;
+    PackedHandle& operator=(const PackedHandle&) = delete;
+    ~PackedHandle() { reset(); }
+    void reset() {
+        if (!cipher) return;
+        if (pool) pool->release(cipher);
+        else delete_owned_sample(cipher);
+        cipher = nullptr;
+    }
+private:
+    SamplePool<Sample>* pool;
 };
+typedef PackedHandle<TGswSample> PackedTRGSW;
+// Lagrange (FFT) 領域のまま保持する版。そのまま外部積に渡せる
+typedef PackedHandle<TGswSampleFFT> PackedTRGSWFFT;
+
+// 中身は未初期化のまま、同じサイズクラスのプールから 1 個取る
+template <typename Sample>
+PackedHandle<Sample> acquire_packed(const BBIIParams& params, BatchMode mode) {
+    return PackedHandle<Sample>(SamplePool<Sample>::for_params(params), mode);
+}
+
 PackedTRGSW create_zero_packed(const BBIIParams& params, BatchMode mode);
+PackedTRGSWFFT create_zero_packed_fft(const BBIIParams& params, BatchMode mode);
+void trgsw_clear(TGswSample* res, const BBIIParams& params);
+void trgsw_clear(TGswSampleFFT* res, const BBIIParams& params);
 void trgsw_add_to(TGswSample* res, const TGswSample* A, const BBIIParams& params);
+void trgsw_add_to(TGswSampleFFT* res, const TGswSampleFFT* A, const BBIIParams& params);
 void trgsw_mul_by_xai(TGswSample* res, const TGswSample* input, int32_t delta, const BBIIParams& params);
+// Lagrange 領域では X^delta の評価値テーブルとの各点積になる
+void trgsw_mul_by_xai(TGswSampleFFT* res, const TGswSampleFFT* input, int32_t delta, const BBIIParams& params);
+
+// テンソル環モードとスロット:
+//   平文 m のスロットは 1 の原始 2N 乗根 zeta での値で、r = N/2 個を環演算 1 回でまとめて扱う
+//   R12 の暗号文は鍵 s の下にあり、スロット j を m(zeta^{5^j}) で読む
+//   R13 の暗号文は鍵 σs (σ: X -> X^{-1}) の下にあり、スロット j を m(zeta^{-5^j}) で読む
+//   (σ(m) を R13 で読むと m を R12 で読んだのと同じスロットになる)
+//   R12->R13 / R13->R12 は遷移鍵で、それぞれ遷移先の鍵 (σs / s) の下にある
+// 遷移規則 (左が運ばれる側、右が作用する側):
+//   R12 * R12 = R12, R13 * R13 = R13
+//   R12 * (R12->R13) = R13, R13 * (R13->R12) = R12
+//   (R12->R13) * R13 = (R12->R13), (R13->R12) * R12 = (R13->R12)
+// それ以外の組 (None を含む) は invalid_argument
+BatchMode batch_mult_mode(BatchMode a, BatchMode b);
+// 遷移鍵のモードか
+inline bool is_transition_mode(BatchMode m) { return m == BatchMode::R12_to_R13 || m == BatchMode::R13_to_R12; }
+// X^delta をスロットに掛けるときの実際の指数。R13 の暗号文は σ(m) を持つので符号が反転する
+inline int32_t mode_exponent(BatchMode m, int32_t delta) { return m == BatchMode::R13 ? -delta : delta; }
+
+// res = A * B (TRGSW 同士の積): 各行 res_i = A (*) B_i。A が作用し、B の各行が分解される
+// (誤差は B の誤差 + 分解 x A の誤差で、A の誤差は増幅されない)。res は A, B と別であること
+// e != 1 なら B の各行に自己同型 X -> X^e (奇数) を施してから掛ける。σ(B) は鍵 σs の下の σ(m_B) になる
+// 係数領域版は N = kLagrangeN なら FFT プロセッサで、それ以外は Karatsuba で掛ける
+// Lagrange 領域版は N = kLagrangeN のときだけ (それ以外は invalid_argument)
+// 作業領域はサイズクラスごとのプールから借りるので呼び出しごとの確保はない
+void trgsw_mult(TGswSample* res, const TGswSample* A, const TGswSample* B, const BBIIParams& params, int32_t e = 1);
+void trgsw_mult(TGswSampleFFT* res, const TGswSampleFFT* A, const TGswSampleFFT* B, const BBIIParams& params, int32_t e = 1);
+
+// 鍵 s から σs の TGSW 鍵を作る (R13 の暗号文の鍵)。delete_TGswKey で解放する
+TGswKey* new_r13_key(const TGswKey* key, const BBIIParams& params);
+// モード切り替え鍵 (平文 1 の TRGSW)。mode は R12_to_R13 (σs の下で暗号化) か R13_to_R12 (s の下)
+// key は R12 の鍵 s
+PackedTRGSW create_mode_switch_key(BatchMode mode, const TGswKey* key, double alpha, const BBIIParams& params);
+
+// res = sum_s srcs[s]。係数ごとに全 srcs を 1 パスで足し込む (srcs が空なら 0)
+void trgsw_sum_selected(TGswSample* res, const TGswSample* const* srcs, size_t count, const BBIIParams& params);
+void trgsw_sum_selected(TGswSampleFFT* res, const TGswSampleFFT* const* srcs, size_t count, const BBIIParams& params);
+
+// X^a (a mod 2N) の Lagrange 表現。params.xai_table に初回だけ計算して置き、以降はロックなしで読む
+const LagrangeHalfCPolynomial* xai_lagrange(const BBIIParams& params, int32_t a);
+
+// 係数領域 <-> Lagrange 領域の変換 (パイプラインの入口と出口で 1 回ずつ)
+// libtfhe の FFT プロセッサは N=1024 固定なので、Lagrange 領域の演算はこの N でのみ使える
+static const int32_t kLagrangeN = 1024;
+PackedTRGSWFFT to_fft(const PackedTRGSW& src, const BBIIParams& params);
+PackedTRGSW from_fft(const PackedTRGSWFFT& src, const BBIIParams& params);
 }
 #endif
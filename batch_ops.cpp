@@ -1,32 +1,214 @@
 #include "batch_ops.h"
 namespace bbii {
-PackedTRGSW vec_mat_mult(const std::vector<int32_t>& a, const std::vector<PackedTRGSW>& B, const BBIIParams& params) {
-    if (B.empty()) return create_zero_packed(params, BatchMode::None); // Safety
-    PackedTRGSW acc = create_zero_packed(params, B[0].mode);
-    for (size_t i = 0; i < a.size(); ++i) {
-        if (i >= B.size()) break;
-        if (a[i] == 1) trgsw_add_to(acc.cipher, B[i].cipher, params);
+// 係数領域 / Lagrange 領域で共通の実装 (違いは trgsw_* のオーバーロードだけ)
+template <typename Sample>
+static PackedHandle<Sample> zero_packed(const BBIIParams& params, BatchMode mode) {
+    PackedHandle<Sample> c = acquire_packed<Sample>(params, mode);
+    trgsw_clear(c.cipher, params);
+    return c;
+}
+// ブロック b の選択行: 指数 exps[i] の立っているビット t ごとに行 i * bits + t
+static std::vector<size_t> exponent_rows(const int32_t* exps, size_t count, int32_t bits) {
+    std::vector<size_t> rows;
+    rows.reserve(count * bits);
+    for (size_t i = 0; i < count; ++i) {
+        for (uint32_t e = uint32_t(exps[i]); e; e &= e - 1) rows.push_back(i * bits + __builtin_ctz(e));
     }
+    return rows;
+}
+// 選ばれた行の和
+template <typename Sample>
+static PackedHandle<Sample> sum_rows(const std::vector<size_t>& rows, const std::vector<PackedHandle<Sample>>& B, const BBIIParams& params) {
+    std::vector<const Sample*> srcs(rows.size());
+    for (size_t s = 0; s < rows.size(); ++s) srcs[s] = B[rows[s]].cipher;
+    PackedHandle<Sample> acc = acquire_packed<Sample>(params, B[0].mode);
+    trgsw_sum_selected(acc.cipher, srcs.data(), srcs.size(), params);
     return acc;
 }
-PackedTRGSW batch_anti_rot(const PackedTRGSW& C, int32_t delta, const BBIIParams& params) {
-    TGswSample* res = new_TGswSample_array(1, params.tfhe_params->tgsw_params);
-    trgsw_mul_by_xai(res, C.cipher, delta, params);
-    return PackedTRGSW(res, C.mode);
+template <typename Sample>
+static std::vector<PackedHandle<Sample>> batch_vec_mat_mult_impl(const std::vector<int32_t>& exps, size_t count, const std::vector<std::vector<PackedHandle<Sample>>>& keys, const BBIIParams& params) {
+    const int32_t bits = exponent_bits(params);
+    if (count == 0 || exps.size() < keys.size() * count) throw std::invalid_argument("batch_vec_mat_mult: more key blocks than packed coefficients");
+    for (const auto& block : keys) {
+        if (block.size() < count * bits) throw std::invalid_argument("batch_vec_mat_mult: key block smaller than count * log2(2N)");
+    }
+    std::vector<PackedHandle<Sample>> result(keys.size());
+    SamplePool<Sample>::for_params(params).reserve(keys.size());
+    parallel_for(keys.size(), [&](size_t b) { result[b] = sum_rows(exponent_rows(exps.data() + b * count, count, bits), keys[b], params); });
+    return result;
 }
-std::vector<PackedTRGSW> enc_vec_mat_mult(const std::vector<std::vector<int32_t>>& M_exp, const std::vector<PackedTRGSW>& C, const BBIIParams& params) {
+template <typename Sample>
+static PackedHandle<Sample> batch_anti_rot_impl(const PackedHandle<Sample>& C, int32_t delta, const BBIIParams& params) {
+    PackedHandle<Sample> res = acquire_packed<Sample>(params, C.mode);
+    trgsw_mul_by_xai(res.cipher, C.cipher, mode_exponent(C.mode, delta), params);
+    return res;
+}
+template <typename Sample>
+static PackedHandle<Sample> batch_mult_impl(const PackedHandle<Sample>& A, const PackedHandle<Sample>& B, const BBIIParams& params) {
+    PackedHandle<Sample> res = acquire_packed<Sample>(params, batch_mult_mode(A.mode, B.mode));
+    // B が作用し、A の各行が分解される。データ x 遷移鍵のときは A に σ を施して
+    // 遷移先の鍵 (B の鍵) の下に移してから掛ける。それ以外は A, B が同じ鍵の下にある
+    const int32_t e = (!is_transition_mode(A.mode) && is_transition_mode(B.mode)) ? 2 * params.N - 1 : 1;
+    trgsw_mult(res.cipher, B.cipher, A.cipher, params, e);
+    return res;
+}
+template <typename Sample>
+static std::vector<PackedHandle<Sample>> batch_mult_impl(const std::vector<PackedHandle<Sample>>& A, const std::vector<PackedHandle<Sample>>& B, const BBIIParams& params) {
+    if (A.size() != B.size()) throw std::invalid_argument("batch_mult: size mismatch");
+    // モードの不整合は計算を始める前に検出する
+    for (size_t i = 0; i < A.size(); ++i) batch_mult_mode(A[i].mode, B[i].mode);
+    std::vector<PackedHandle<Sample>> result(A.size());
+    SamplePool<Sample>::for_params(params).reserve(A.size());
+    parallel_for(A.size(), [&](size_t i) { result[i] = batch_mult_impl(A[i], B[i], params); });
+    return result;
+}
+template <typename Sample>
+static void enc_vec_mat_mult_impl(IndexView<PackedHandle<Sample>> out, const std::vector<std::vector<int32_t>>& M_exp, IndexView<const PackedHandle<Sample>> C, const BBIIParams& params) {
     size_t rows = M_exp.size(); size_t cols = C.size();
-    if (cols == 0) return {};
-    std::vector<PackedTRGSW> result;
-    for (size_t i = 0; i < rows; ++i) {
-        PackedTRGSW acc = create_zero_packed(params, C[0].mode);
-        for (size_t j = 0; j < cols; ++j) {
-            PackedTRGSW term = batch_anti_rot(C[j], M_exp[i][j], params);
-            trgsw_add_to(acc.cipher, term.cipher, params);
-            delete_TGswSample_array(1, term.cipher);
+    if (cols == 0) return;
+    if (cols % rows != 0 || out.size() != cols) throw std::invalid_argument("enc_vec_mat_mult: size mismatch");
+    PackedHandle<Sample> term = acquire_packed<Sample>(params, C[0].mode);
+    for (size_t blk = 0; blk < cols; blk += rows) {
+        for (size_t i = 0; i < rows; ++i) {
+            PackedHandle<Sample> acc = zero_packed<Sample>(params, C[blk].mode);
+            for (size_t j = 0; j < rows; ++j) {
+                // Term = C[j] * X^{M[i][j]} (作業領域 term は使い回す)
+                trgsw_mul_by_xai(term.cipher, C[blk + j].cipher, mode_exponent(C[blk + j].mode, M_exp[i][j]), params);
+                trgsw_add_to(acc.cipher, term.cipher, params);
+            }
+            out[blk + i] = std::move(acc);
         }
-        result.push_back(acc);
     }
+}
+
+std::vector<PackedTRGSW> batch_vec_mat_mult(const std::vector<int32_t>& exps, size_t count, const std::vector<std::vector<PackedTRGSW>>& keys, const BBIIParams& params) {
+    return batch_vec_mat_mult_impl(exps, count, keys, params);
+}
+std::vector<PackedTRGSWFFT> batch_vec_mat_mult(const std::vector<int32_t>& exps, size_t count, const std::vector<std::vector<PackedTRGSWFFT>>& keys, const BBIIParams& params) {
+    return batch_vec_mat_mult_impl(exps, count, keys, params);
+}
+PackedTRGSW batch_anti_rot(const PackedTRGSW& C, int32_t delta, const BBIIParams& params) {
+    return batch_anti_rot_impl(C, delta, params);
+}
+PackedTRGSWFFT batch_anti_rot(const PackedTRGSWFFT& C, int32_t delta, const BBIIParams& params) {
+    return batch_anti_rot_impl(C, delta, params);
+}
+PackedTRGSW batch_mult(const PackedTRGSW& A, const PackedTRGSW& B, const BBIIParams& params) {
+    return batch_mult_impl(A, B, params);
+}
+PackedTRGSWFFT batch_mult(const PackedTRGSWFFT& A, const PackedTRGSWFFT& B, const BBIIParams& params) {
+    return batch_mult_impl(A, B, params);
+}
+std::vector<PackedTRGSW> batch_mult(const std::vector<PackedTRGSW>& A, const std::vector<PackedTRGSW>& B, const BBIIParams& params) {
+    return batch_mult_impl(A, B, params);
+}
+std::vector<PackedTRGSWFFT> batch_mult(const std::vector<PackedTRGSWFFT>& A, const std::vector<PackedTRGSWFFT>& B, const BBIIParams& params) {
+    return batch_mult_impl(A, B, params);
+}
+void enc_vec_mat_mult(IndexView<PackedTRGSW> out, const std::vector<std::vector<int32_t>>& M_exp, IndexView<const PackedTRGSW> C, const BBIIParams& params) {
+    enc_vec_mat_mult_impl(out, M_exp, C, params);
+}
+void enc_vec_mat_mult(IndexView<PackedTRGSWFFT> out, const std::vector<std::vector<int32_t>>& M_exp, IndexView<const PackedTRGSWFFT> C, const BBIIParams& params) {
+    enc_vec_mat_mult_impl(out, M_exp, C, params);
+}
+std::vector<PackedTRGSW> enc_vec_mat_mult(const std::vector<std::vector<int32_t>>& M_exp, const std::vector<PackedTRGSW>& C, const BBIIParams& params) {
+    std::vector<PackedTRGSW> result(C.size());
+    enc_vec_mat_mult(IndexView<PackedTRGSW>(result), M_exp, IndexView<const PackedTRGSW>(C), params);
     return result;
 }
+
+void pack_input_exponents(std::vector<int32_t>& exps, const LweSample* const* inputs, size_t count, int32_t dim, const BBIIParams& params) {
+    exps.resize(size_t(dim) * count);
+    const uint32_t offset = params.ms_offset;
+    const int32_t shift = params.ms_shift;
+    // 16 サンプル x 256 係数のタイルごとに転置する。読み (16 KiB) はタイル内で L1 に残り、
+    // 書き込みは出力の各行 (係数 j) に 16 個ずつ連続で入るのでベクトル化される
+    static const size_t kTileS = 16;
+    static const int32_t kTileJ = 256;
+    int32_t* out = exps.data();
+    for (size_t i0 = 0; i0 < count; i0 += kTileS) {
+        const size_t ni = (count - i0 < kTileS) ? count - i0 : kTileS;
+        for (int32_t j0 = 0; j0 < dim; j0 += kTileJ) {
+            const int32_t nj = (dim - j0 < kTileJ) ? dim - j0 : kTileJ;
+            int32_t* tile = out + size_t(j0) * count + i0;
+            const Torus32* a[kTileS];
+            for (size_t i = 0; i < ni; ++i) a[i] = inputs[i0 + i]->a + j0;
+            for (int32_t j = 0; j < nj; ++j) {
+                int32_t* row = tile + size_t(j) * count;
+                // uint32 の桁あふれがそのまま mod 2N になる
+                for (size_t i = 0; i < ni; ++i) row[i] = int32_t((uint32_t(a[i][j]) + offset) >> shift);
+            }
+        }
+    }
+}
+
+// 出力番号 i -> (DFT 出力の番号, 係数位置)
+static void slot_position(size_t i, size_t count, size_t outputs, int32_t N, size_t& which, int32_t& coef) {
+    size_t slots = (count + outputs - 1) / outputs;
+    which = i / slots;
+    coef = int32_t((i % slots) * (N / slots));
+}
+// 位相 m / Bg -> m / 4 - 1/8。Torus32 の掛け算は uint32 で (桁あふれがそのまま mod 1 になる)
+static void rescale_to_gate(LweSample* s, int32_t n, int32_t Bgbit) {
+    const uint32_t scale = uint32_t(1) << (Bgbit - 2);
+    for (int32_t j = 0; j < n; ++j) s->a[j] = Torus32(uint32_t(s->a[j]) * scale);
+    s->b = Torus32(uint32_t(s->b) * scale - uint32_t(modSwitchToTorus32(1, 8)));
+    s->current_variance *= double(scale) * double(scale);
+}
+void batch_sample_extract(LweSample* const* out, size_t count, const std::vector<PackedTRGSW>& C, const BBIIParams& params) {
+    if (count == 0) return;
+    if (C.empty()) throw std::invalid_argument("batch_sample_extract: no DFT output");
+    const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+    const TLweParams* tlwe_p = tgsw_p->tlwe_params;
+    int32_t row = tlwe_p->k * tgsw_p->l;
+    for (size_t i = 0; i < count; ++i) {
+        size_t which; int32_t coef;
+        slot_position(i, count, C.size(), params.N, which, coef);
+        tLweExtractLweSampleIndex(out[i], &C[which].cipher->all_sample[row], coef, &tlwe_p->extracted_lweparams, tlwe_p);
+        rescale_to_gate(out[i], tlwe_p->extracted_lweparams.n, tgsw_p->Bgbit);
+    }
+}
+void batch_sample_extract(LweSample* const* out, size_t count, const std::vector<PackedTRGSWFFT>& C, const BBIIParams& params) {
+    if (count == 0) return;
+    if (C.empty()) throw std::invalid_argument("batch_sample_extract: no DFT output");
+    const TGswParams* tgsw_p = params.tfhe_params->tgsw_params;
+    const TLweParams* tlwe_p = tgsw_p->tlwe_params;
+    int32_t row = tlwe_p->k * tgsw_p->l;
+    // 逆変換は必要な b 行だけ、DFT 出力 1 個につき 1 回
+    TLweSample* tlwe = new_TLweSample(tlwe_p);
+    size_t converted = C.size();
+    for (size_t i = 0; i < count; ++i) {
+        size_t which; int32_t coef;
+        slot_position(i, count, C.size(), params.N, which, coef);
+        if (which != converted) {
+            tLweFromFFTConvert(tlwe, &C[which].cipher->all_samples[row], tlwe_p);
+            converted = which;
+        }
+        tLweExtractLweSampleIndex(out[i], tlwe, coef, &tlwe_p->extracted_lweparams, tlwe_p);
+        rescale_to_gate(out[i], tlwe_p->extracted_lweparams.n, tgsw_p->Bgbit);
+    }
+    delete_TLweSample(tlwe);
+}
+void batch_key_switch(LweSample* const* out, const LweKeySwitchKey* ks, const LweSample* const* in, size_t count) {
+    const LweParams* params = ks->out_params;
+    const int32_t basebit = ks->basebit;
+    const int32_t t = ks->t;
+    const int32_t prec_offset = 1 << (32 - (1 + basebit * t)); // lweKeySwitchTranslate_fromArray と同じ丸め
+    const int32_t mask = (1 << basebit) - 1;
+
+    for (size_t s = 0; s < count; ++s) lweNoiselessTrivial(out[s], in[s]->b, params);
+    // 係数 i ごとに全サンプルの桁を先に求め、鍵行を読みながら全サンプルへ引く
+    std::vector<uint32_t> aibar(count);
+    for (int32_t i = 0; i < ks->n; ++i) {
+        for (size_t s = 0; s < count; ++s) aibar[s] = in[s]->a[i] + prec_offset;
+        for (int32_t j = 0; j < t; ++j) {
+            const LweSample* row = ks->ks[i][j];
+            const int32_t shift = 32 - (j + 1) * basebit;
+            for (size_t s = 0; s < count; ++s) {
+                const uint32_t aij = (aibar[s] >> shift) & mask;
+                if (aij != 0) lweSubTo(out[s], &row[aij], params);
+            }
+        }
+    }
+}
 }
@@ -1,10 +1,46 @@
 #ifndef BATCH_OPS_H
 #define BATCH_OPS_H
 #include "batch_framework.h"
+#include "bb_utils.h"
 #include <vector>
 namespace bbii {
-PackedTRGSW vec_mat_mult(const std::vector<int32_t>& a, const std::vector<PackedTRGSW>& B, const BBIIParams& params);
+// Step 2: pack_input_exponents の指数 (count 個の LWE の係数ごと) から鍵ブロックごとの和を求める
+// ブロック b は係数 b の行 exps[b * count + i] を使い、指数のビット t (bits = log2(2N) ビット) が立っていれば
+// 行 keys[b][i * bits + t] を足す。各ブロックは count * bits 行以上、ブロック数は dim (= exps.size() / count) 以下
+std::vector<PackedTRGSW> batch_vec_mat_mult(const std::vector<int32_t>& exps, size_t count, const std::vector<std::vector<PackedTRGSW>>& keys, const BBIIParams& params);
+std::vector<PackedTRGSWFFT> batch_vec_mat_mult(const std::vector<int32_t>& exps, size_t count, const std::vector<std::vector<PackedTRGSWFFT>>& keys, const BBIIParams& params);
+// スロットに X^delta を掛ける (R13 では実際の指数は -delta)
 PackedTRGSW batch_anti_rot(const PackedTRGSW& C, int32_t delta, const BBIIParams& params);
+PackedTRGSWFFT batch_anti_rot(const PackedTRGSWFFT& C, int32_t delta, const BBIIParams& params);
+// Batch-Mult: A を B で掛ける (B が作用する側)。結果のモードは batch_mult_mode(A.mode, B.mode) で、
+// スロットごとの積になる (R12 * (R12->R13) なら結果の R13 のスロット j = A の R12 のスロット j x B の R13 のスロット j)
+PackedTRGSW batch_mult(const PackedTRGSW& A, const PackedTRGSW& B, const BBIIParams& params);
+PackedTRGSWFFT batch_mult(const PackedTRGSWFFT& A, const PackedTRGSWFFT& B, const BBIIParams& params);
+// A[i] * B[i] を組ごとに並列に計算する
+std::vector<PackedTRGSW> batch_mult(const std::vector<PackedTRGSW>& A, const std::vector<PackedTRGSW>& B, const BBIIParams& params);
+std::vector<PackedTRGSWFFT> batch_mult(const std::vector<PackedTRGSWFFT>& A, const std::vector<PackedTRGSWFFT>& B, const BBIIParams& params);
+// C を長さ M_exp.size() のブロックに区切り、各ブロックに M_exp を掛けて out の同じ位置に書き込む
+void enc_vec_mat_mult(IndexView<PackedTRGSW> out, const std::vector<std::vector<int32_t>>& M_exp, IndexView<const PackedTRGSW> C, const BBIIParams& params);
+void enc_vec_mat_mult(IndexView<PackedTRGSWFFT> out, const std::vector<std::vector<int32_t>>& M_exp, IndexView<const PackedTRGSWFFT> C, const BBIIParams& params);
 std::vector<PackedTRGSW> enc_vec_mat_mult(const std::vector<std::vector<int32_t>>& M_exp, const std::vector<PackedTRGSW>& C, const BBIIParams& params);
+
+// Step 1 の入力パッキング: count 個の LWE (次元 dim) の a を Z_{2N} の指数に mod switch し、係数ごとに転置して
+// exps[j * count + i] = round(2N * a_i[j]) mod 2N に書く (modSwitchFromTorus32(a_i[j], 2N) と一致)
+// exps は呼び出しをまたいで使い回すバッファ (サイズが足りなければ広げる)
+void pack_input_exponents(std::vector<int32_t>& exps, const LweSample* const* inputs, size_t count, int32_t dim, const BBIIParams& params);
+// 指数のビット数 log2(2N)
+inline int32_t exponent_bits(const BBIIParams& params) { return 32 - params.ms_shift; }
+
+// DFT 出力から count 個の LWE (次元 k*N, 抽出鍵) を取り出す
+// 配置: DFT 出力 1 個あたり slots = ceil(count / C.size()) スロットを持ち、i 番目は出力 i / slots の
+// 係数 (i % slots) * (N / slots) にある
+// 読むのは b ブロックの最上位レベルの行 all_sample[k*l] で、その位相は m / Bg (h_1 = 1/Bg)。
+// 平文の係数 m ∈ {0, 1} をゲートの符号化 (bootsSymDecrypt で m) に直して返す: Bg/4 倍して 1/8 を引く
+// (誤差も Bg/4 倍になる)。out[i] は extracted_lweparams で確保済みであること
+void batch_sample_extract(LweSample* const* out, size_t count, const std::vector<PackedTRGSW>& C, const BBIIParams& params);
+void batch_sample_extract(LweSample* const* out, size_t count, const std::vector<PackedTRGSWFFT>& C, const BBIIParams& params);
+// count 個の LWE をまとめて鍵切り替えする。鍵の各行 ks[i][j] はバッチ全体で 1 回だけ読む
+// 結果は lweKeySwitch を 1 個ずつ呼んだものと一致する
+void batch_key_switch(LweSample* const* out, const LweKeySwitchKey* ks, const LweSample* const* in, size_t count);
 }
 #endif
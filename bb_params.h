@@ -8,34 +8,16 @@
 // ディレクトリなしでインクルード
 #include <tfhe.h>
 #include <tfhe_core.h>
+// BBIIParams / get_bbii_params は src/libbbii と共通
+#include "src/libbbii/bbii_params.h"
 
 namespace bbii {
-struct BBIIParams {
-    int32_t n; int32_t N; int32_t d; int32_t rho; int32_t r;
-    TFheGateBootstrappingParameterSet* tfhe_params;
-    
-    BBIIParams(int32_t d_val, int32_t rho_val, int32_t N_val) : d(d_val), rho(rho_val), N(N_val) {
-        // n = 2 * d^rho
-        n = 2 * std::pow(d, rho); 
-        r = N / 2; 
-        
-        static const int32_t k = 1;
-        static const double alpha_lwe = 3.0e-5;
-        static const double alpha_bk  = 9.0e-9;
-        static const int32_t ks_t = 10;
-        static const int32_t ks_basebit = 1;
-        
-        LweParams* lwe_p = new_LweParams(n, alpha_lwe, 1.0/2.0);
-        TLweParams* tlwe_p = new_TLweParams(N, k, alpha_bk, 1.0/2.0);
-        TGswParams* tgsw_p = new_TGswParams(3, 10, tlwe_p);
-        
-        tfhe_params = new TFheGateBootstrappingParameterSet(ks_t, ks_basebit, lwe_p, tgsw_p);
-    }
-    ~BBIIParams() { delete_gate_bootstrapping_parameters(tfhe_params); }
-};
-
 // ★ここを変更しました: (d=2, rho=9, N=2048)
-inline BBIIParams* get_test_params() { return new BBIIParams(2, 9, 2048); }
+inline const BBIIParams& get_test_params() { return get_bbii_params(2, 9, 2048); }
+
+// 小さいパラメータ (main --small): Lagrange 領域の演算 (FFT プロセッサ) が使える N = kLagrangeN = 1024 で、
+// Step 3 の TGSW が (2d)^(rho-1) = 64 個に収まる大きさ (get_test_params では 65536 個で数 GB になる)
+inline const BBIIParams& get_small_test_params() { return get_bbii_params(2, 4, 1024); }
 
 }
 #endif
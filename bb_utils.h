@@ -1,8 +1,15 @@
 #ifndef BB_UTILS_H
 #define BB_UTILS_H
 #include <vector>
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
+#include <type_traits>
+#include <thread>
+#include <exception>
+#include <mutex>
+#include <algorithm>
+#include "tfhe_thread_pool.h"
 namespace bbii {
 template <typename T>
 std::vector<T> rearrange(const std::vector<T>& input, int32_t d) {
@@ -28,5 +35,138 @@ std::vector<T> reverse_rearrange(const std::vector<T>& input, int32_t d) {
     }
     return output;
 }
+
+// parallel_for 用のプール (hardware_concurrency 本)。初回の呼び出しで起動し、以後はスレッドと
+// その thread_local な FFT プロセッサ・作業領域をプロセス終了まで使い回す
+inline TfheThreadPool& parallel_pool() {
+    static TfheThreadPool pool(std::max<int32_t>(1, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+// [0, n) の f(i) を parallel_pool で実行する。プールのタスク内からの入れ子の呼び出しは逐次実行
+// (f の中で投げられた例外は最初の 1 つを呼び出し側に再送出)
+template <typename F>
+void parallel_for(size_t n, F f) {
+    struct Job {
+        F* f;
+        std::mutex mutex;
+        std::exception_ptr error;
+    } job;
+    job.f = &f;
+    parallel_pool().run(static_cast<int32_t>(n), [](int32_t i, void* arg) {
+        Job& j = *static_cast<Job*>(arg);
+        try {
+            (*j.f)(static_cast<size_t>(i));
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(j.mutex);
+            if (!j.error) j.error = std::current_exception();
+        }
+    }, &job);
+    if (job.error) std::rethrow_exception(job.error);
+}
+
+// 添字写像: ビュー上の論理インデックス -> 元配列の物理インデックス
+// Slice / Rearrange / ReverseRearrange を固定長スタックに積んでシンボリックに合成する (ヒープ確保なし)
+struct IndexMap {
+    enum class Op : uint8_t { Slice, Rearrange, ReverseRearrange };
+    struct Step { Op op; size_t arg; size_t n; }; // arg: Slice なら offset, 転置なら d / n: 適用前のサイズ
+    static const int kMaxSteps = 16;
+
+    Step steps[kMaxSteps];
+    int count;
+
+    IndexMap() : count(0) {}
+
+    size_t operator()(size_t k) const {
+        for (int s = count - 1; s >= 0; --s) {
+            const Step& st = steps[s];
+            switch (st.op) {
+            case Op::Slice:
+                k += st.arg;
+                break;
+            case Op::Rearrange: { // out[j*rows+i] = in[i*cols+j]
+                size_t rows = st.arg, cols = st.n / st.arg;
+                k = (k % rows) * cols + k / rows;
+                break;
+            }
+            case Op::ReverseRearrange: { // out[i*cols+j] = in[j*rows+i]
+                size_t rows = st.arg, cols = st.n / st.arg;
+                k = (k % cols) * rows + k / cols;
+                break;
+            }
+            }
+        }
+        return k;
+    }
+
+    IndexMap then_slice(size_t offset) const {
+        IndexMap m = *this;
+        if (offset == 0) return m;
+        if (m.count > 0 && m.steps[m.count - 1].op == Op::Slice) { // slice の連鎖は 1 つに畳む
+            m.steps[m.count - 1].arg += offset;
+            return m;
+        }
+        m.push({Op::Slice, offset, 0});
+        return m;
+    }
+
+    IndexMap then_rearrange(size_t d, size_t n, bool reverse) const {
+        if (n % d != 0) throw std::invalid_argument("Input size must be multiple of d");
+        IndexMap m = *this;
+        Op op = reverse ? Op::ReverseRearrange : Op::Rearrange;
+        Op inv = reverse ? Op::Rearrange : Op::ReverseRearrange;
+        if (m.count > 0 && m.steps[m.count - 1].op == inv &&
+            m.steps[m.count - 1].arg == d && m.steps[m.count - 1].n == n) { // 逆置換同士は打ち消す
+            --m.count;
+            return m;
+        }
+        m.push({op, d, n});
+        return m;
+    }
+
+private:
+    void push(const Step& st) {
+        if (count == kMaxSteps) throw std::length_error("IndexMap: too many composed steps");
+        steps[count++] = st;
+    }
+};
+
+// span + 添字写像。再帰の各段で部分列や並べ替えを値コピーなしで渡すためのビュー
+template <typename T>
+class IndexView {
+public:
+    IndexView() : base_(nullptr), size_(0) {}
+    IndexView(T* base, size_t size) : base_(base), size_(size) {}
+    IndexView(std::vector<T>& v) : base_(v.data()), size_(v.size()) {}
+    IndexView(const std::vector<typename std::remove_const<T>::type>& v) : base_(v.data()), size_(v.size()) {}
+    template <typename U>
+    IndexView(const IndexView<U>& o) : base_(o.base_), size_(o.size_), map_(o.map_) {}
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    T& operator[](size_t k) const { return base_[map_(k)]; }
+
+    // [offset, offset+len) の部分ビュー
+    IndexView slice(size_t offset, size_t len) const {
+        if (offset + len > size_) throw std::out_of_range("IndexView::slice out of range");
+        return IndexView(base_, len, map_.then_slice(offset));
+    }
+    // rearrange(v, d) を適用した結果のビュー
+    IndexView rearranged(int32_t d) const {
+        return IndexView(base_, size_, map_.then_rearrange(d, size_, false));
+    }
+    // reverse_rearrange(v, d) を適用した結果のビュー
+    IndexView reverse_rearranged(int32_t d) const {
+        return IndexView(base_, size_, map_.then_rearrange(d, size_, true));
+    }
+
+private:
+    template <typename U> friend class IndexView;
+    IndexView(T* base, size_t size, const IndexMap& map) : base_(base), size_(size), map_(map) {}
+
+    T* base_;
+    size_t size_;
+    IndexMap map_;
+};
 }
 #endif
@@ -12,44 +12,116 @@ std::vector<std::vector<int32_t>> gen_inv_dft_exponents(int32_t dim) {
     }
     return M;
 }
-std::vector<PackedTRGSW> hom_dft_inverse(const std::vector<PackedTRGSW>& inputs, int32_t current_rho, const BBIIParams& params) {
-    if (current_rho <= 1) return inputs;
+
+// 入力 m 個に対する出力の個数
+static size_t hom_dft_output_size(size_t m, int32_t rho, int32_t d) {
+    if (rho <= 1) return m;
+    return d * hom_dft_output_size(m / (2 * d), rho - 1, d);
+}
+
+// 再帰全体で必要なハンドル用スクラッチ (各段で combined と mat_mult_res の 2 本)
+static size_t hom_dft_scratch_size(size_t m, int32_t rho, int32_t d) {
+    if (rho <= 1) return 0;
+    size_t combined = 2 * d * hom_dft_output_size(m / (2 * d), rho - 1, d);
+    return 2 * combined + hom_dft_scratch_size(m / (2 * d), rho - 1, d);
+}
+
+// テンソル環の切り替え鍵 (hom_dft_inverse の to_r13 / to_r12)
+template <typename Handle>
+struct ModeSwitchKeys {
+    const Handle* to_r13;
+    const Handle* to_r12;
+};
+
+// c の各要素にそのモードに合った切り替え鍵を掛ける (R12 -> R13, R13 -> R12)
+template <typename Handle>
+static void switch_modes(IndexView<Handle> c, const ModeSwitchKeys<Handle>& keys, const BBIIParams& params) {
+    parallel_for(c.size(), [&](size_t i) {
+        const Handle* key = (c[i].mode == BatchMode::R12) ? keys.to_r13 : keys.to_r12;
+        c[i] = batch_mult(c[i], *key, params);
+    });
+}
+
+// 部分列・並べ替えはすべて IndexView の合成で表し、TGSW ハンドルはコピーしない
+template <typename Handle>
+static void hom_dft_inverse_rec(IndexView<Handle> inputs, IndexView<Handle> out, int32_t current_rho,
+                                Handle* scratch, const std::vector<std::vector<int32_t>>& M,
+                                const ModeSwitchKeys<Handle>* switch_keys, const BBIIParams& params) {
+    if (current_rho <= 1) {
+        for (size_t k = 0; k < inputs.size(); ++k) out[k] = std::move(inputs[k]);
+        return;
+    }
     int32_t two_d = 2 * params.d;
     size_t chunk_size = inputs.size() / two_d;
-    std::vector<PackedTRGSW> combined;
+    size_t sub_size = hom_dft_output_size(chunk_size, current_rho - 1, params.d);
+
+    IndexView<Handle> combined(scratch, two_d * sub_size);
+    IndexView<Handle> mat_mult_res(scratch + combined.size(), combined.size());
+    Handle* child_scratch = scratch + 2 * combined.size();
+
     for (int i = 0; i < two_d; ++i) {
-        std::vector<PackedTRGSW> sub_in(inputs.begin() + i*chunk_size, inputs.begin() + (i+1)*chunk_size);
-        auto sub_out = hom_dft_inverse(sub_in, current_rho - 1, params);
-        combined.insert(combined.end(), sub_out.begin(), sub_out.end());
+        hom_dft_inverse_rec(inputs.slice(i * chunk_size, chunk_size), combined.slice(i * sub_size, sub_size),
+                            current_rho - 1, child_scratch, M, switch_keys, params);
     }
-    auto rearranged = rearrange(combined, params.d);
-    auto M = gen_inv_dft_exponents(two_d);
-    auto mat_mult_res = enc_vec_mat_mult(M, rearranged, params);
-    
-    // 入力側(combined)はもう不要なので削除してOK
-    for(auto& p : combined) delete_TGswSample_array(1, p.cipher); 
-
-    // ★修正箇所: ここで mat_mult_res を削除してはいけない！
-    // rev_rearranged は mat_mult_res のポインタを参照しているため、
-    // ここで消すと rev_rearranged が空っぽのメモリを指すことになる。
-    auto rev_rearranged = reverse_rearrange(mat_mult_res, params.d);
-    // 削除行: for(auto& p : mat_mult_res) delete_TGswSample_array(1, p.cipher);  <-- これが原因でした
-
-    std::vector<PackedTRGSW> result;
+    enc_vec_mat_mult(mat_mult_res, M, combined.rearranged(params.d), params);
+
+    // 入力側(combined)はもう不要なのでプールへ返す
+    for (size_t k = 0; k < combined.size(); ++k) combined[k].reset();
+
+    // reverse_rearrange(mat_mult_res) の読み出しと、結果の reverse_rearrange は
+    // どちらもビューで行う (出力を out.rearranged(d) に書けば reverse_rearrange(result) と同じ配置になる)
+    IndexView<Handle> rev_rearranged = mat_mult_res.reverse_rearranged(params.d);
+    IndexView<Handle> result = out.rearranged(params.d);
     size_t half = rev_rearranged.size() / 2;
     int32_t rot_factor = params.N / (1 << current_rho);
     for (size_t i = 0; i < half; ++i) {
-        PackedTRGSW rotated = batch_anti_rot(rev_rearranged[i+half], rot_factor, params);
-        PackedTRGSW res = create_zero_packed(params, rev_rearranged[i].mode);
-        trgsw_add_to(res.cipher, rev_rearranged[i].cipher, params);
-        trgsw_add_to(res.cipher, rotated.cipher, params);
-        result.push_back(res);
-        delete_TGswSample_array(1, rotated.cipher);
+        // lower += upper * X^rot をそのまま lower の領域で行い、出力へムーブする
+        Handle rotated = batch_anti_rot(rev_rearranged[i+half], rot_factor, params);
+        trgsw_add_to(rev_rearranged[i].cipher, rotated.cipher, params);
+        result[i] = std::move(rev_rearranged[i]);
     }
-    
-    // 最後に rev_rearranged (＝mat_mult_resの実体) を削除
-    for(auto& p : rev_rearranged) delete_TGswSample_array(1, p.cipher);
-    
-    return reverse_rearrange(result, params.d);
+
+    // 残った上半分 (＝mat_mult_resの実体) をプールへ返す
+    for (size_t k = 0; k < mat_mult_res.size(); ++k) mat_mult_res[k].reset();
+
+    // この段の出力を次のテンソル環へ移す (同じ段の出力はすべて同じモード)
+    if (switch_keys) switch_modes(out, *switch_keys, params);
+}
+
+template <typename Sample>
+static std::vector<PackedHandle<Sample>> hom_dft_inverse_impl(std::vector<PackedHandle<Sample>> inputs, int32_t current_rho, const BBIIParams& params,
+                                                              const PackedHandle<Sample>* to_r13, const PackedHandle<Sample>* to_r12) {
+    typedef PackedHandle<Sample> Handle;
+    if (!to_r13 != !to_r12) throw std::invalid_argument("hom_dft_inverse: give both mode-switch keys or neither");
+    if (to_r13 && (to_r13->mode != BatchMode::R12_to_R13 || to_r12->mode != BatchMode::R13_to_R12))
+        throw std::invalid_argument("hom_dft_inverse: wrong mode-switch key modes");
+    if (current_rho <= 1) return inputs;
+    int32_t two_d = 2 * params.d;
+    size_t m = inputs.size();
+    for (int32_t r = current_rho; r > 1; --r, m /= two_d) {
+        if (m % two_d != 0) throw std::invalid_argument("hom_dft_inverse: input size must be (2d)^(rho-1)");
+    }
+    auto M = gen_inv_dft_exponents(two_d);
+    std::vector<Handle> scratch(hom_dft_scratch_size(inputs.size(), current_rho, params.d));
+    std::vector<Handle> result(hom_dft_output_size(inputs.size(), current_rho, params.d));
+    // 再帰中に必要な TGSW を先にまとめて確保しておく (スクラッチ + 出力 + 一時領域、切り替えの積の出力)
+    SamplePool<Sample>::for_params(params).reserve(scratch.size() + result.size() + 4 + (to_r13 ? result.size() : 0));
+    ModeSwitchKeys<Handle> keys = {to_r13, to_r12};
+    const ModeSwitchKeys<Handle>* switch_keys = to_r13 ? &keys : nullptr;
+    hom_dft_inverse_rec(IndexView<Handle>(inputs), IndexView<Handle>(result), current_rho, scratch.data(), M, switch_keys, params);
+    // 取り出しは R12 (鍵 s) で行うので、奇数段で終わったら戻す
+    if (switch_keys && !result.empty() && result[0].mode == BatchMode::R13)
+        switch_modes(IndexView<Handle>(result), keys, params);
+    return result;
+}
+
+std::vector<PackedTRGSW> hom_dft_inverse(std::vector<PackedTRGSW> inputs, int32_t current_rho, const BBIIParams& params,
+                                         const PackedTRGSW* to_r13, const PackedTRGSW* to_r12) {
+    return hom_dft_inverse_impl(std::move(inputs), current_rho, params, to_r13, to_r12);
+}
+
+std::vector<PackedTRGSWFFT> hom_dft_inverse(std::vector<PackedTRGSWFFT> inputs, int32_t current_rho, const BBIIParams& params,
+                                            const PackedTRGSWFFT* to_r13, const PackedTRGSWFFT* to_r12) {
+    return hom_dft_inverse_impl(std::move(inputs), current_rho, params, to_r13, to_r12);
 }
 }
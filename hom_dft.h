@@ -2,6 +2,15 @@
 #define HOM_DFT_H
 #include "batch_ops.h"
 namespace bbii {
-std::vector<PackedTRGSW> hom_dft_inverse(const std::vector<PackedTRGSW>& inputs, int32_t current_rho, const BBIIParams& params);
+// inputs の TGSW は消費される (呼び出し側は std::move で渡す)
+// to_r13 / to_r12 (create_mode_switch_key の切り替え鍵) を渡すと、結合の各段のあとで出力に batch_mult で
+// 切り替え鍵を掛けてテンソル環を R12 -> R13 -> R12 ... と交互に移す。スロットの値は変わらず、
+// 最後が R13 なら R12 に戻してから返すので、出力は切り替えなしの場合と同じ平文 (誤差だけが増える)
+// 切り替え鍵は両方とも渡すか、両方とも nullptr にする
+std::vector<PackedTRGSW> hom_dft_inverse(std::vector<PackedTRGSW> inputs, int32_t current_rho, const BBIIParams& params,
+                                         const PackedTRGSW* to_r13 = nullptr, const PackedTRGSW* to_r12 = nullptr);
+// Lagrange 領域版。再帰の途中で FFT / 逆 FFT を一切行わない
+std::vector<PackedTRGSWFFT> hom_dft_inverse(std::vector<PackedTRGSWFFT> inputs, int32_t current_rho, const BBIIParams& params,
+                                            const PackedTRGSWFFT* to_r13 = nullptr, const PackedTRGSWFFT* to_r12 = nullptr);
 }
 #endif
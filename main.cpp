@@ -1,12 +1,15 @@
 #include "batch_bootstrapping.h"
 #include <iostream>
 #include <chrono> // 追加
+#include <cstring>
 
 using namespace bbii;
 
-int main() {
+// usage: main [--small]   (--small: get_small_test_params、省略時は get_test_params)
+int main(int argc, char** argv) {
     // パラメータ取得
-    BBIIParams* params = get_test_params();
+    const bool small = argc > 1 && std::strcmp(argv[1], "--small") == 0;
+    const BBIIParams* params = small ? &get_small_test_params() : &get_test_params();
     std::cout << "Params: n=" << params->n << ", N=" << params->N << std::endl;
     
     // 鍵生成
@@ -15,12 +18,20 @@ int main() {
     // BBII鍵 (Dummy) 生成
     BatchBootstrappingKey bk;
     std::vector<PackedTRGSW> block_key;
-    for(int i=0; i<params->n; ++i) {
-        TGswSample* c = new_TGswSample_array(1, params->tfhe_params->tgsw_params);
-        tGswSymEncryptInt(c, 0, 0, key->tgsw_key); 
-        block_key.push_back(PackedTRGSW(c, BatchMode::R12));
+    // 入力ごとに指数の各ビットの行 (n * log2(2N) 行)
+    for(int i=0; i<params->n * exponent_bits(*params); ++i) {
+        PackedTRGSW c(TGswPool::for_params(*params), BatchMode::R12);
+        tGswSymEncryptInt(c.cipher, 0, 0, key->tgsw_key); 
+        block_key.push_back(std::move(c));
     }
-    bk.keys.push_back(block_key);
+    bk.keys.push_back(std::move(block_key));
+    bk.ks = key->cloud.bk->ks;
+    // Step 3 のテンソル環の切り替え鍵
+    const double alpha = params->tfhe_params->tgsw_params->tlwe_params->alpha_min;
+    bk.to_r13 = create_mode_switch_key(BatchMode::R12_to_R13, key->tgsw_key, alpha, *params);
+    bk.to_r12 = create_mode_switch_key(BatchMode::R13_to_R12, key->tgsw_key, alpha, *params);
+    // N=1024 なら鍵を Lagrange 領域に移しておく (以降の準同型 DFT は FFT なしで進む)
+    if (prepare_fft_keys(bk, *params)) std::cout << "Using Lagrange-domain keys" << std::endl;
 
     // 入力データ生成
     std::vector<LweSample*> inputs(params->n);
@@ -54,7 +65,6 @@ int main() {
 
     for(auto p : inputs) delete_LweSample(p);
     delete_gate_bootstrapping_secret_keyset(key);
-    delete params;
     
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef CIRCUITBOOTSTRAPPING_H
+#define CIRCUITBOOTSTRAPPING_H
+
+///@file
+///@brief This file declares the circuit bootstrapping (LWE -> TRGSW) and the CMux-tree lookup tables
+
+#include "tfhe_core.h"
+#include "lwebootstrappingkey.h"
+#include "tgsw.h"
+
+/**
+ * Key material of the circuit bootstrapping.
+ * It reuses the gate bootstrapping key bk, and adds a private functional keyswitch
+ * from the extracted key K (length kN) to the TRLWE key of the accumulator.
+ */
+struct TfheCircuitBootstrappingKey {
+    const LweBootstrappingKeyFFT* bk; ///< the gate bootstrapping key (in_out key -> accumulator key)
+    const TGswParams* cb_params; ///< params of the output TRGSW (same TRLWE params as the accumulator)
+    const int32_t t; ///< decomposition length of the private keyswitch
+    const int32_t basebit; ///< log_2(base) of the private keyswitch
+    const int32_t base; ///< decomposition base of the private keyswitch
+    TLweSample* privks; ///< (k+1) x (kN+1) x t samples: [i][p][j] encodes f_i(K'_p/base^(j+1))
+
+#ifdef __cplusplus
+    TfheCircuitBootstrappingKey(const LweBootstrappingKeyFFT* bk, const TGswParams* cb_params,
+                                int32_t t, int32_t basebit, TLweSample* privks);
+    ~TfheCircuitBootstrappingKey();
+    TfheCircuitBootstrappingKey(const TfheCircuitBootstrappingKey&) = delete;
+    void operator=(const TfheCircuitBootstrappingKey&) = delete;
+#endif
+};
+
+/**
+ * allocates and generates the circuit bootstrapping key.
+ * @param bk the gate bootstrapping key (the pointer is kept: it must outlive the result)
+ * @param tgsw_key the key of the accumulator (the one bk encrypts to)
+ * @param cb_params the params of the output TRGSW, over bk->accum_params
+ * @param t,basebit the decomposition of the private keyswitch
+ * @param alpha the standard deviation of the private keyswitch samples
+ */
+EXPORT TfheCircuitBootstrappingKey* new_TfheCircuitBootstrappingKey(const LweBootstrappingKeyFFT* bk,
+                                                                    const TGswKey* tgsw_key,
+                                                                    const TGswParams* cb_params,
+                                                                    int32_t t, int32_t basebit, double alpha);
+EXPORT void delete_TfheCircuitBootstrappingKey(TfheCircuitBootstrappingKey* obj);
+
+/**
+ * private functional keyswitch: result = TRLWE encryption of f_i(phase(x)) under the accumulator key,
+ * where f_i(m) = -s_i.m for i < k and f_k(m) = m.
+ * x is an LWE sample under the extracted key (length kN).
+ */
+EXPORT void tfhe_privateKeySwitch(TLweSample* result, const TfheCircuitBootstrappingKey* cbk, int32_t i,
+                                  const LweSample* x);
+
+/**
+ * circuit bootstrapping: converts x (gate encoding, +-1/8 under the in_out key)
+ * into a TRGSW of its bit, directly in FFT form.
+ * Each of the l rows levels is a programmable bootstrap to m.h_j followed by k+1 private keyswitches.
+ */
+EXPORT void tfhe_circuitBootstrap_FFT(TGswSampleFFT* result, const TfheCircuitBootstrappingKey* cbk,
+                                      const LweSample* x);
+
+/** result = c0 + sel.(c1 - c0) (result must not alias c0) */
+EXPORT void tfhe_CMux_FFT(TLweSample* result, const TGswSampleFFT* sel, const TLweSample* c0, const TLweSample* c1,
+                          const TGswParams* params);
+
+/**
+ * Lookup tables on nb_inputs encrypted bits (TRGSW from tfhe_circuitBootstrap_FFT, LSB first).
+ * table[x*nb_outputs+o] is the bit o of the output for the input x (0 <= x < 2^nb_inputs).
+ * The nb_outputs results are gate encoded LWE samples under the in_out key (keyswitched with bk->ks).
+ *
+ * vertical packing: the low log_2(N) input bits select a coefficient by blind rotation,
+ * the remaining bits a polynomial by a CMux tree. Several outputs share a polynomial
+ * when 2^nb_inputs < N.
+ */
+EXPORT void tfhe_lutVertical_FFT(LweSample* result, const int32_t* table, int32_t nb_outputs,
+                                 const TGswSampleFFT* inputs, int32_t nb_inputs,
+                                 const TfheCircuitBootstrappingKey* cbk);
+/**
+ * horizontal packing: a CMux tree over all input bits, on polynomials whose coefficient o
+ * is the output bit o (nb_outputs <= N).
+ */
+EXPORT void tfhe_lutHorizontal_FFT(LweSample* result, const int32_t* table, int32_t nb_outputs,
+                                   const TGswSampleFFT* inputs, int32_t nb_inputs,
+                                   const TfheCircuitBootstrappingKey* cbk);
+
+#endif // CIRCUITBOOTSTRAPPING_H
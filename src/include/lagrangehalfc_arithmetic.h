@@ -22,6 +22,23 @@ EXPORT void IntPolynomial_ifft(LagrangeHalfCPolynomial* result, const IntPolynom
 EXPORT void TorusPolynomial_ifft(LagrangeHalfCPolynomial* result, const TorusPolynomial* p);
 EXPORT void TorusPolynomial_fft(TorusPolynomial* result, const LagrangeHalfCPolynomial* p);
 
+/**
+ * batched FFT functions: transform the count polynomials p[0..count-1] in one call
+ * (the processors that can interleave several transforms do so, the others loop)
+ */
+EXPORT void IntPolynomial_ifft_batch(LagrangeHalfCPolynomial* result, const IntPolynomial* p, const int32_t count);
+EXPORT void TorusPolynomial_ifft_batch(LagrangeHalfCPolynomial* result, const TorusPolynomial* p, const int32_t count);
+EXPORT void TorusPolynomial_fft_batch(TorusPolynomial* result, const LagrangeHalfCPolynomial* p, const int32_t count);
+
+/**
+ * gadget decomposition fused with the FFT: result[q] = ifft of the q-th signed digit
+ * (base 2^Bgbit) of p+offset, for q < l. Same digits as tGswTorus32PolynomialDecompH,
+ * but they go straight into the FFT input instead of l intermediate IntPolynomials.
+ */
+EXPORT void TorusPolynomial_decomp_ifft(LagrangeHalfCPolynomial* result, const TorusPolynomial* p, const int32_t l,
+                                        const int32_t Bgbit, const uint32_t maskMod, const int32_t halfBg,
+                                        const uint32_t offset);
+
 //MISC OPERATIONS
 /** sets to zero */
 EXPORT void LagrangeHalfCPolynomialClear(LagrangeHalfCPolynomial* result);
@@ -38,6 +55,9 @@ EXPORT void LagrangeHalfCPolynomialAddTorusConstant(LagrangeHalfCPolynomial* res
 //in the current version. However, it may be included in future releases
 //EXPORT void LagrangeHalfCPolynomialSetXaiMinusOne(LagrangeHalfCPolynomial* result, const int32_t ai);
 
+/** result(X) = a(X^e), for an odd 0<e<2N (the ring automorphism X -> X^e, result != a) */
+EXPORT void LagrangeHalfCPolynomialAutomorphism(LagrangeHalfCPolynomial* result, const LagrangeHalfCPolynomial* a, const int32_t e);
+
 
 /** multiplication via direct FFT */
 EXPORT void torusPolynomialMultFFT(TorusPolynomial* result, const IntPolynomial* poly1, const TorusPolynomial* poly2);
@@ -52,6 +72,19 @@ EXPORT void torusPolynomialAddMulRFFTN(TorusPolynomial* result, IntPolynomial* p
 EXPORT void torusPolynomialSubMulRFFT1(TorusPolynomial* result, IntPolynomial* poly1, const TorusPolynomial* poly2);
 EXPORT void torusPolynomialSubMulRFFTN(TorusPolynomial* result, IntPolynomial* poly1, TorusPolynomial* poly2, const int32_t N);
 
+/** multiplication by a prepared (FFT-cached) operand
+ * one forward FFT (of poly1) and one inverse FFT per call, no allocation */
+// result = FFT(poly)
+EXPORT void torusPolynomialPrepare(PreparedTorusPolynomial* result, const TorusPolynomial* poly);
+// result = result + poly1*poly2
+EXPORT void torusPolynomialAddMulPrepared(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2);
+// result = result - poly1*poly2
+EXPORT void torusPolynomialSubMulPrepared(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2);
+// result = result + sum_{j<count} poly1[j]*poly2[j] (the products are summed in the FFT domain, one inverse FFT)
+EXPORT void torusPolynomialAddMulPreparedN(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2, const int32_t count);
+// result = result - sum_{j<count} poly1[j]*poly2[j]
+EXPORT void torusPolynomialSubMulPreparedN(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2, const int32_t count);
+
 /** termwise multiplication in Lagrange space */
 EXPORT void LagrangeHalfCPolynomialMul(
 	LagrangeHalfCPolynomial* result, 
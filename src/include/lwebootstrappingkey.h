@@ -59,6 +59,57 @@ struct LweBootstrappingKeyFFT {
 };
 
 
+/// number of independent bootstrappings interleaved by the *_batch_ws functions
+#define TFHE_BOOTSTRAP_BATCH_SIZE 8
+
+/**
+ * Scratch space of one FFT gate bootstrapping (external product, blind
+ * rotation, extraction and the temporaries of the boots* gates).
+ * Allocated once for a given (n, N, k, l) and reused, so that a gate
+ * evaluation does not touch the heap.
+ */
+struct TfheBootstrapWorkspace {
+    const int32_t n; ///< dimension of the input LWE samples
+    const int32_t N; ///< degree of the accumulator
+    const int32_t k; ///< TLwe dimension of the accumulator
+    const int32_t l; ///< decomposition length of the bootstrapping key
+    IntPolynomial* deca; ///< decomposed accumulator (kpl polynomials)
+    LagrangeHalfCPolynomial* decaFFT; ///< fft version of deca (kpl polynomials)
+    TLweSampleFFT* tmpa; ///< external product accumulator
+    TLweSample* acc; ///< blind rotation accumulator
+    TLweSample* temp; ///< blind rotation temporary
+    TorusPolynomial* testvect; ///< test polynomial [mu,...,mu]
+    TorusPolynomial* testvectbis; ///< test polynomial times X^{-barb}
+    int32_t* bara; ///< mod switched input mask (n coefficients)
+    LweSample* u; ///< extracted sample before key switching
+    LweSample* gate_in; ///< linear combination of the gate inputs (in_out params)
+    LweSample* gate_u1; ///< first extracted sample of bootsMUX (extract params)
+    LweSample* gate_u2; ///< second extracted sample of bootsMUX (extract params)
+    LweSample* gate_sum; ///< sum of the extracted samples of bootsMUX (extract params)
+    // batched bootstrapping (TFHE_BOOTSTRAP_BATCH_SIZE samples, allocated on first use)
+    TLweSample* batch_acc; ///< accumulators of the batch
+    TLweSample* batch_temp; ///< blind rotation temporaries of the batch
+    TLweSample** batch_rot; ///< current (first half) and spare (second half) accumulator of each sample
+    int32_t* batch_barb; ///< mod switched b of each input
+    int32_t* batch_bara; ///< mod switched masks, n coefficients per input
+    LweSample* batch_u; ///< extracted samples before key switching (extract params)
+    LweSample* batch_u2; ///< second extracted samples of bootsMUX_batch (extract params)
+    LweSample* batch_in; ///< linear combinations of the gate inputs (in_out params)
+
+#ifdef __cplusplus
+    TfheBootstrapWorkspace(int32_t n, int32_t N, int32_t k, int32_t l,
+                           IntPolynomial* deca, LagrangeHalfCPolynomial* decaFFT, TLweSampleFFT* tmpa,
+                           TLweSample* acc, TLweSample* temp,
+                           TorusPolynomial* testvect, TorusPolynomial* testvectbis, int32_t* bara,
+                           LweSample* u, LweSample* gate_in,
+                           LweSample* gate_u1, LweSample* gate_u2, LweSample* gate_sum);
+    ~TfheBootstrapWorkspace();
+    TfheBootstrapWorkspace(const TfheBootstrapWorkspace&) = delete;
+    void operator=(const TfheBootstrapWorkspace&) = delete;
+#endif
+};
+
+
 //allocate memory space for a LweBootstrappingKey
 EXPORT LweBootstrappingKey* alloc_LweBootstrappingKey();
 EXPORT LweBootstrappingKey* alloc_LweBootstrappingKey_array(int32_t nbelts);
@@ -115,4 +166,18 @@ EXPORT LweBootstrappingKeyFFT* new_LweBootstrappingKeyFFT_array(int32_t nbelts,
 EXPORT void delete_LweBootstrappingKeyFFT(LweBootstrappingKeyFFT* obj);
 EXPORT void delete_LweBootstrappingKeyFFT_array(int32_t nbelts, LweBootstrappingKeyFFT* obj);
 
+//allocates and initialize a TfheBootstrapWorkspace sized for bk
+//(equivalent of the C++ new)
+EXPORT TfheBootstrapWorkspace* new_TfheBootstrapWorkspace(const LweBootstrappingKeyFFT* bk);
+
+//destroys and frees the TfheBootstrapWorkspace structure
+//(equivalent of the C++ delete)
+EXPORT void delete_TfheBootstrapWorkspace(TfheBootstrapWorkspace* obj);
+
+//workspace of the calling thread, (re)allocated on first use or when bk has other dimensions
+EXPORT TfheBootstrapWorkspace* tfhe_local_bootstrap_workspace(const LweBootstrappingKeyFFT* bk);
+
+//allocates the batch_* buffers of ws (does nothing if they already exist)
+EXPORT void tfhe_reserve_bootstrap_workspace_batch(TfheBootstrapWorkspace* ws, const LweBootstrappingKeyFFT* bk);
+
 #endif
@@ -136,6 +136,10 @@ EXPORT void MKtGswTorus32PolynomialDecompG(IntPolynomial *result, const TorusPol
 EXPORT void MKtGswTorus32PolynomialDecompGassembly(IntPolynomial *result, const TorusPolynomial *sample, 
         const MKTFHEParams *params);
 
+// decomposition fused with the FFT: resultFFT[p] = FFT(I_p), p < dg
+EXPORT void MKtGswTorus32PolynomialDecompGFFT(LagrangeHalfCPolynomial *resultFFT, const TorusPolynomial *sample, 
+        const MKTFHEParams *params);
+
 
 
 
@@ -65,6 +65,7 @@ struct MKRLweKey {
 
     TLweKey* key; // RLWE secret keys for all the parties
     TorusPolynomial* Pkey; // RLWE public keys for all the parties
+    PreparedTorusPolynomial* PkeyFFT; // FFT of Pkey, filled by MKRLweKeyGen (constant operand of the expand/external products)
 
 #ifdef __cplusplus
     MKRLweKey(const TLweParams* RLWEparams, const MKTFHEParams* MKparams);
@@ -0,0 +1,61 @@
+#ifndef MKTFHENOISE_H
+#define MKTFHENOISE_H
+
+
+#include "tfhe_core.h"
+#include "mkTFHEparams.h"
+
+
+
+/* ****************************************************
+********** NOISE MODEL (version 2, method 2) **********
+**************************************************** */
+
+// Analytic variances (on the torus) of the MK operations of the v2m2 path,
+// for binary secret keys (E[s^2] = 1/2) and uniform decomposition digits.
+// They are the values written in the current_variance of the samples.
+
+
+// variance of one digit of the gadget decomposition, uniform in [-Bg/2, Bg/2)
+EXPORT double MKvarianceDigitG(const MKTFHEParams* MKparams);
+
+// variance of the rounding error of the gadget decomposition (precision Bg^{-dg})
+EXPORT double MKvarianceDecompG(const MKTFHEParams* MKparams);
+
+// variance over the coefficients of r*(e_1 + ... + e_nb_decomp), for r binary and e_i the rounding
+// errors of nb_decomp gadget decompositions, due to the mean of these errors
+EXPORT double MKvarianceDecompBiasG(int32_t nb_decomp, const MKTFHEParams* MKparams);
+
+// variance of an expanded sample (MKTGswExpand_v2), from the variance var_ue of the UE sample (d, F)
+EXPORT double MKvarianceExpand_v2(double var_ue, const MKTFHEParams* MKparams);
+
+// variance of G^{-1}(c)*(d, F) (MKtGswUEExternMulToMKtLwe_v2m2), binary message,
+// for a sample c of variance var_in and a UE sample of variance var_ue
+EXPORT double MKvarianceExternMul_v2m2(double var_in, double var_ue, const MKTFHEParams* MKparams);
+
+// variance of ACC + BKi*[(X^barai-1)*ACC], for an accumulator of variance var_acc:
+// only one of the two branches keeps its noise
+EXPORT double MKvarianceMuxRotate_v2m2(double var_acc, double var_ue, const MKTFHEParams* MKparams);
+
+// variance after the parties*n rotations of the blind rotation, starting from a noiseless accumulator
+// (it is also the variance of the extracted sample)
+EXPORT double MKvarianceBlindRotate_v2m2(double var_ue, const MKTFHEParams* MKparams);
+
+// variance of MKlweKeySwitch, for an extracted sample of variance var_in
+EXPORT double MKvarianceKeySwitch(double var_in, const MKTFHEParams* MKparams);
+
+// variance of the rounding of the input to Z_2N, at the beginning of the bootstrapping
+EXPORT double MKvarianceModSwitch(const MKTFHEParams* MKparams);
+
+// variance of the output of MKtfhe_bootstrap_v2m2 (BK noise stdevBK, KS noise stdevKS)
+EXPORT double MKvarianceBootstrap_v2m2(const MKTFHEParams* MKparams);
+
+// probability that a NAND of two bootstrapped samples decrypts incorrectly:
+// the phase 1/8 - ca - cb must stay at distance less than 1/8 from its value
+EXPORT double MKfailureProbabilityNAND_v2m2(const MKTFHEParams* MKparams);
+
+// cost of one bootstrapping (blind rotation + key switching) in the benchmark cost model:
+// number of torus multiply-adds, a polynomial product counting N*log2(N)
+EXPORT double MKcostBootstrap_v2m2(const MKTFHEParams* MKparams);
+
+#endif //MKTFHENOISE_H
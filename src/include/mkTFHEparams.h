@@ -74,4 +74,11 @@ EXPORT MKTFHEParams* new_MKTFHEParams_array(int32_t nbelts, int32_t n, int32_t n
 EXPORT void delete_MKTFHEParams(MKTFHEParams* obj);
 EXPORT void delete_MKTFHEParams_array(int32_t nbelts, MKTFHEParams* obj);
 
+// shared = interned by value: the same arguments always give the same pointer,
+// built once per process (gadget and offset included) and safe to call from any thread.
+// The result lives until the end of the process and must not be deleted.
+EXPORT const MKTFHEParams* shared_MKTFHEParams(int32_t n, int32_t n_extract, int32_t hLWE, double stdevLWE, 
+		int32_t Bksbit, int32_t dks, double stdevKS, int32_t N, int32_t hRLWE, double stdevRLWEkey, 
+		double stdevRLWE, double stdevRGSW, int32_t Bgbit, int32_t dg, double stdevBK, int32_t parties);
+
 #endif //MKTFHEPARAMS_H
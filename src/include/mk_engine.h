@@ -0,0 +1,36 @@
+#ifndef MK_ENGINE_H
+#define MK_ENGINE_H
+
+///@file
+///@brief MK kernels specialized at compile time for a fixed (parties, dg, N)
+
+#include "tfhe_core.h"
+#include "mkTFHEparams.h"
+#include "mkTFHEkeys.h"
+#include "mkTFHEsamples.h"
+
+
+// signature of MKtGswUEExternMulToMKtLwe_FFT_v2m2 (without the unused RLWEparams)
+typedef void (*MKEngineExternMul)(MKTLweSample* result, const MKTLweSample* sample,
+        const MKTGswUESampleFFT_v2* sampleUEFFT, const MKTFHEParams* MKparams, const MKRLweKey* RLWEkey);
+
+#ifdef __cplusplus
+/**
+ * MK kernels whose loop bounds (parties+1, dg, N) are template parameters, so that the
+ * decomposition, the accumulations and the (parties+1)-way sums have fixed trip counts.
+ * The products are accumulated in the Lagrange space, one inverse FFT per output polynomial.
+ * Instantiated for the configurations of testMKbootNAND_FFT_v2 (mk_engine.cpp).
+ */
+template<int32_t Parties, int32_t Dg, int32_t N>
+struct MKEngine {
+    // same result as MKtGswUEExternMulToMKtLwe_FFT_v2m2
+    static void externMulToMKtLwe(MKTLweSample* result, const MKTLweSample* sample,
+            const MKTGswUESampleFFT_v2* sampleUEFFT, const MKTFHEParams* MKparams, const MKRLweKey* RLWEkey);
+};
+#endif
+
+/** the specialized external product for (MKparams->parties, MKparams->dg, MKparams->N),
+ * or 0 when this configuration is not instantiated (the generic code is used) */
+EXPORT MKEngineExternMul MKEngine_externMul(const MKTFHEParams* MKparams);
+
+#endif //MK_ENGINE_H
@@ -46,6 +46,23 @@ struct LagrangeHalfCPolynomial
    void* precomp;
 };
 
+/**
+ * A torus polynomial that is used as a constant operand of many products
+ * (public keys, UE sample components...). Its FFT is computed once by
+ * torusPolynomialPrepare and reused by the *Prepared multiplications.
+ */
+struct PreparedTorusPolynomial {
+   const int32_t N;
+   LagrangeHalfCPolynomial* fft;
+
+#ifdef __cplusplus
+   PreparedTorusPolynomial(const int32_t N);
+   ~PreparedTorusPolynomial();
+   PreparedTorusPolynomial(const PreparedTorusPolynomial&) = delete; //forbidden
+   PreparedTorusPolynomial* operator=(const PreparedTorusPolynomial&) = delete; //forbidden
+#endif
+};
+
 //allocate memory space for a IntPolynomial
 EXPORT IntPolynomial* alloc_IntPolynomial();
 EXPORT IntPolynomial* alloc_IntPolynomial_array(int32_t nbelts);
@@ -130,4 +147,14 @@ EXPORT LagrangeHalfCPolynomial* new_LagrangeHalfCPolynomial_array(int32_t nbelts
 EXPORT void delete_LagrangeHalfCPolynomial(LagrangeHalfCPolynomial* obj);
 EXPORT void delete_LagrangeHalfCPolynomial_array(int32_t nbelts, LagrangeHalfCPolynomial* obj);
 
+//allocates and initialize the PreparedTorusPolynomial structure
+//(equivalent of the C++ new)
+EXPORT PreparedTorusPolynomial* new_PreparedTorusPolynomial(const int32_t N);
+EXPORT PreparedTorusPolynomial* new_PreparedTorusPolynomial_array(int32_t nbelts, const int32_t N);
+
+//destroys and frees the PreparedTorusPolynomial structure
+//(equivalent of the C++ delete)
+EXPORT void delete_PreparedTorusPolynomial(PreparedTorusPolynomial* obj);
+EXPORT void delete_PreparedTorusPolynomial_array(int32_t nbelts, PreparedTorusPolynomial* obj);
+
 #endif //POLYNOMIALS_H
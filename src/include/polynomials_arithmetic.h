@@ -55,6 +55,18 @@ EXPORT void torusPolynomialMulByXaiMinusOne(TorusPolynomial* result, int32_t a,
 /** result= X^{a}*source */
 EXPORT void torusPolynomialMulByXai(TorusPolynomial* result, int32_t a, const TorusPolynomial* source);
 
+/** poly= X^{a}*poly, in place */
+EXPORT void torusPolynomialMulByXaiInPlace(TorusPolynomial* poly, int32_t a);
+
+/**  result(X) = source(X^e), for an odd 0<e<2N (the ring automorphism X -> X^e) */
+EXPORT void torusPolynomialAutomorphism(TorusPolynomial* result, const TorusPolynomial* source, int32_t e);
+
+/**  poly(X) = poly(X^e), in place */
+EXPORT void torusPolynomialAutomorphismInPlace(TorusPolynomial* poly, int32_t e);
+
+/**  result(X) = source(X^e), for an odd 0<e<2N */
+EXPORT void intPolynomialAutomorphism(IntPolynomial* result, const IntPolynomial* source, int32_t e);
+
 /**  Norme Euclidienne d'un IntPolynomial */
 EXPORT double intPolynomialNormSq2(const IntPolynomial* poly);
 
@@ -21,10 +21,15 @@
 
 #include "lwebootstrappingkey.h"
 
+#include "circuitbootstrapping.h"
+#include "tlweautomorphism.h"
+
 #include "tfhe_gate_bootstrapping_functions.h"
 
 #include "tfhe_io.h"
 
+#include "tfhe_cpu_dispatch.h"
+
 ///////////////////////////////////////////////////
 //  TFHE bootstrapping internal functions
 //////////////////////////////////////////////////
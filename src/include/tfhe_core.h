@@ -42,9 +42,13 @@ struct TGswSample;
 struct TGswSampleFFT;
 struct LweBootstrappingKey;
 struct LweBootstrappingKeyFFT;
+struct TfheBootstrapWorkspace;
+struct TfheCircuitBootstrappingKey;
+struct TLweAutomorphismKey;
 struct IntPolynomial;
 struct TorusPolynomial;
 struct LagrangeHalfCPolynomial;
+struct PreparedTorusPolynomial;
 struct TFheGateBootstrappingParameterSet;
 struct TFheGateBootstrappingCloudKeySet;
 struct TFheGateBootstrappingSecretKeySet;
@@ -88,9 +92,13 @@ typedef struct TGswSample       TGswSample;
 typedef struct TGswSampleFFT       TGswSampleFFT;
 typedef struct LweBootstrappingKey LweBootstrappingKey;
 typedef struct LweBootstrappingKeyFFT LweBootstrappingKeyFFT;
+typedef struct TfheBootstrapWorkspace TfheBootstrapWorkspace;
+typedef struct TfheCircuitBootstrappingKey TfheCircuitBootstrappingKey;
+typedef struct TLweAutomorphismKey TLweAutomorphismKey;
 typedef struct IntPolynomial	   IntPolynomial;
 typedef struct TorusPolynomial	   TorusPolynomial;
 typedef struct LagrangeHalfCPolynomial	   LagrangeHalfCPolynomial;
+typedef struct PreparedTorusPolynomial	   PreparedTorusPolynomial;
 typedef struct TFheGateBootstrappingParameterSet TFheGateBootstrappingParameterSet;
 typedef struct TFheGateBootstrappingCloudKeySet TFheGateBootstrappingCloudKeySet;
 typedef struct TFheGateBootstrappingSecretKeySet TFheGateBootstrappingSecretKeySet;
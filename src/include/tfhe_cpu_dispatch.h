@@ -0,0 +1,56 @@
+#ifndef TFHE_CPU_DISPATCH_H
+#define TFHE_CPU_DISPATCH_H
+
+///@file
+///@brief load-time selection of the SIMD kernels (used by the "dispatch" build of the library)
+
+#include "tfhe_core.h"
+
+/** the kernel families, from the most portable to the fastest */
+enum TfheCpuBackend {
+    TFHE_CPU_PORTABLE = 0, ///< plain C/C++ (baseline x86-64)
+    TFHE_CPU_AVX = 1,      ///< AVX (and AVX2 when available)
+    TFHE_CPU_FMA = 2,      ///< AVX + FMA3
+    TFHE_CPU_AVX512 = 3    ///< AVX-512F + FMA3 (FFT and Lagrange kernels of spqlios)
+};
+typedef enum TfheCpuBackend TfheCpuBackend;
+
+/** the CPU features, probed once with CPUID when the library is loaded */
+struct TfheCpuFeatures {
+    int32_t avx;
+    int32_t avx2;
+    int32_t fma;
+    int32_t avx512f;
+};
+typedef struct TfheCpuFeatures TfheCpuFeatures;
+
+/**
+ * kernels selected at load time. The core calls them through this table when it is
+ * compiled with TFHE_CPU_DISPATCH, otherwise it calls the one chosen by the compilation flags.
+ */
+struct TfheCpuKernels {
+    TfheCpuBackend backend;
+    /** result[p] = p-th signed digit (base 2^Bgbit) of buf[j]+offset, for p < l. buf is restored. */
+    void (*torus32PolynomialDecomp)(IntPolynomial *result, uint32_t *buf, int32_t N, int32_t l, int32_t Bgbit,
+                                    uint32_t maskMod, int32_t halfBg, uint32_t offset);
+};
+typedef struct TfheCpuKernels TfheCpuKernels;
+
+EXPORT const TfheCpuFeatures *tfhe_cpu_features();
+
+/**
+ * the best backend supported by the CPU. The environment variable TFHE_CPU_BACKEND
+ * (portable, avx, fma or avx512) can lower it, e.g. to test the portable kernels on a recent CPU.
+ */
+EXPORT TfheCpuBackend tfhe_cpu_backend();
+EXPORT const char *tfhe_cpu_backend_name(TfheCpuBackend backend);
+
+EXPORT const TfheCpuKernels *tfhe_cpu_kernels();
+
+// the decomposition kernels, also called directly when the choice is made at compile time
+EXPORT void torus32PolynomialDecomp_portable(IntPolynomial *result, uint32_t *buf, int32_t N, int32_t l,
+                                             int32_t Bgbit, uint32_t maskMod, int32_t halfBg, uint32_t offset);
+EXPORT void torus32PolynomialDecomp_avx2(IntPolynomial *result, uint32_t *buf, int32_t N, int32_t l,
+                                         int32_t Bgbit, uint32_t maskMod, int32_t halfBg, uint32_t offset);
+
+#endif // TFHE_CPU_DISPATCH_H
@@ -86,4 +86,57 @@ bootsORYN(LweSample *result, const LweSample *ca, const LweSample *cb, const TFh
 EXPORT void bootsMUX(LweSample *result, const LweSample *a, const LweSample *b, const LweSample *c,
                      const TFheGateBootstrappingCloudKeySet *bk);
 
+/*
+ * Batched gates: count independent gates result[s] = gate(ca[s], cb[s]) on arrays of
+ * count samples. The blind rotations of up to TFHE_BOOTSTRAP_BATCH_SIZE gates are
+ * interleaved, and the batches are spread over tfhe_get_gate_batch_threads() threads.
+ */
+/** batched bootstrapped Nand Gate */
+EXPORT void
+bootsNAND_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped Or Gate */
+EXPORT void
+bootsOR_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+              const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped And Gate */
+EXPORT void
+bootsAND_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+               const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped Xor Gate */
+EXPORT void
+bootsXOR_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+               const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped Xnor Gate */
+EXPORT void
+bootsXNOR_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped Nor Gate */
+EXPORT void
+bootsNOR_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+               const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped AndNY Gate */
+EXPORT void
+bootsANDNY_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                 const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped AndYN Gate */
+EXPORT void
+bootsANDYN_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                 const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped OrNY Gate */
+EXPORT void
+bootsORNY_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped OrYN Gate */
+EXPORT void
+bootsORYN_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                const TFheGateBootstrappingCloudKeySet *bk);
+/** batched bootstrapped Mux: result[s] = a[s]?b[s]:c[s] */
+EXPORT void bootsMUX_batch(LweSample *result, const LweSample *a, const LweSample *b, const LweSample *c, int32_t count,
+                           const TFheGateBootstrappingCloudKeySet *bk);
+
+/** number of threads used by the batched gates (1 by default: everything runs in the calling thread) */
+EXPORT void tfhe_set_gate_batch_threads(int32_t nb_threads);
+EXPORT int32_t tfhe_get_gate_batch_threads();
+
 #endif// TFHE_GATE_BOOTSTRAPPING_FUNCTIONS_H
@@ -34,6 +34,9 @@ EXPORT void tGswTLweDecompH(IntPolynomial *result, const TLweSample *sample, con
 
 EXPORT void
 tGswTorus32PolynomialDecompH(IntPolynomial *result, const TorusPolynomial *sample, const TGswParams *params);
+// same decomposition, directly in the Lagrange space (result has l elements)
+EXPORT void tGswTorus32PolynomialDecompHFFT(LagrangeHalfCPolynomial *result, const TorusPolynomial *sample,
+                                            const TGswParams *params);
 EXPORT void tGswTLweDecompH(IntPolynomial *result, const TLweSample *sample, const TGswParams *params);
 
 //TODO: Ilaria.Theoreme3.5
@@ -64,6 +67,13 @@ EXPORT void tGswFromFFTConvert(TGswSample *result, const TGswSampleFFT *source,
 EXPORT void tGswFFTAddH(TGswSampleFFT *result, const TGswParams *params);
 EXPORT void tGswFFTClear(TGswSampleFFT *result, const TGswParams *params);
 EXPORT void tGswFFTExternMulToTLwe(TLweSample *accum, const TGswSampleFFT *gsw, const TGswParams *params);
+// same as tGswFFTExternMulToTLwe, using the deca/decaFFT/tmpa buffers of ws
+EXPORT void tGswFFTExternMulToTLwe_ws(TLweSample *accum, const TGswSampleFFT *gsw, const TGswParams *params,
+                                      TfheBootstrapWorkspace *ws);
+// same as tGswFFTExternMulToTLwe, with caller provided buffers
+// (deca and decaFFT hold kpl polynomials, tmpa is a TLweSampleFFT of params->tlwe_params)
+void tGswFFTExternMulToTLwe_buffers(TLweSample *accum, const TGswSampleFFT *gsw, const TGswParams *params,
+                                    IntPolynomial *deca, LagrangeHalfCPolynomial *decaFFT, TLweSampleFFT *tmpa);
 EXPORT void
 tGswFFTMulByXaiMinusOne(TGswSampleFFT *result, const int32_t ai, const TGswSampleFFT *bki, const TGswParams *params);
 
@@ -85,6 +95,31 @@ EXPORT void
 tfhe_blindRotateAndExtract_FFT(LweSample *result, const TorusPolynomial *v, const TGswSampleFFT *bk, const int32_t barb,
                                const int32_t *bara, const int32_t n, const TGswParams *bk_params);
 EXPORT void tfhe_bootstrap_FFT(LweSample *result, const LweBootstrappingKeyFFT *bk, Torus32 mu, const LweSample *x);
+
+// variants of the FFT bootstrapping that take all their temporaries from ws
+// (the functions above use the workspace of the calling thread)
+EXPORT void tfhe_blindRotate_FFT_ws(TLweSample *accum, const TGswSampleFFT *bk, const int32_t *bara, const int32_t n,
+                                    const TGswParams *bk_params, TfheBootstrapWorkspace *ws);
+EXPORT void
+tfhe_blindRotateAndExtract_FFT_ws(LweSample *result, const TorusPolynomial *v, const TGswSampleFFT *bk, const int32_t barb,
+                                  const int32_t *bara, const int32_t n, const TGswParams *bk_params,
+                                  TfheBootstrapWorkspace *ws);
+EXPORT void tfhe_bootstrap_woKS_FFT_ws(LweSample *result, const LweBootstrappingKeyFFT *bk, Torus32 mu, const LweSample *x,
+                                       TfheBootstrapWorkspace *ws);
+EXPORT void tfhe_bootstrap_FFT_ws(LweSample *result, const LweBootstrappingKeyFFT *bk, Torus32 mu, const LweSample *x,
+                                  TfheBootstrapWorkspace *ws);
+
+// batched variants: count <= TFHE_BOOTSTRAP_BATCH_SIZE independent bootstrappings, whose
+// blind rotations are interleaved so that each bk_i is used by the whole batch at once
+// (result and x are arrays of count samples, bara holds n coefficients per sample)
+EXPORT void
+tfhe_blindRotateAndExtract_FFT_batch_ws(LweSample *result, const TorusPolynomial *v, const TGswSampleFFT *bk,
+                                        const int32_t *barb, const int32_t *bara, const int32_t n, const int32_t count,
+                                        const TGswParams *bk_params, TfheBootstrapWorkspace *ws);
+EXPORT void tfhe_bootstrap_woKS_FFT_batch_ws(LweSample *result, const LweBootstrappingKeyFFT *bk, Torus32 mu,
+                                             const LweSample *x, const int32_t count, TfheBootstrapWorkspace *ws);
+EXPORT void tfhe_bootstrap_FFT_batch_ws(LweSample *result, const LweBootstrappingKeyFFT *bk, Torus32 mu,
+                                        const LweSample *x, const int32_t count, TfheBootstrapWorkspace *ws);
 // EXPORT void tfhe_bootstrapFFT(LweSample* result, const LweBootstrappingKeyFFT* bk, Torus32 mu1, Torus32 mu0, const LweSample* x);
 // EXPORT void tfhe_createLweBootstrappingKeyFFT(LweBootstrappingKeyFFT* bk, const LweKey* key_in, const TGswKey* rgsw_key);
 
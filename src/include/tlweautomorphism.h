@@ -0,0 +1,49 @@
+#ifndef TLWEAUTOMORPHISM_H
+#define TLWEAUTOMORPHISM_H
+
+///@file
+///@brief This file declares the ring automorphisms X -> X^e of TRLWE samples, and their hoisted evaluation
+
+#include "tfhe_core.h"
+#include "tgsw.h"
+
+/**
+ * Key switching key of the automorphism X -> X^e.
+ * The row i*l+j encrypts tau_e(s_i).h_j under s, so that tau_e(c), a sample under tau_e(s),
+ * is switched back to s with a gadget decomposition of its mask.
+ */
+struct TLweAutomorphismKey {
+    const int32_t e; ///< the exponent (odd, 0 < e < 2N)
+    const TGswParams* params; ///< the gadget decomposition, and the TRLWE params of the rows
+    TLweSampleFFT* rows; ///< k*l rows, in the Lagrange space
+
+#ifdef __cplusplus
+    TLweAutomorphismKey(int32_t e, const TGswParams* params, TLweSampleFFT* rows);
+    ~TLweAutomorphismKey();
+    TLweAutomorphismKey(const TLweAutomorphismKey&) = delete;
+    void operator=(const TLweAutomorphismKey&) = delete;
+#endif
+};
+
+/**
+ * allocates and generates the key switching key of X -> X^e
+ * @param e the exponent, odd (it is reduced mod 2N)
+ * @param key the TRLWE key (and the decomposition) of the samples
+ * @param alpha the standard deviation of the rows
+ */
+EXPORT TLweAutomorphismKey* new_TLweAutomorphismKey(int32_t e, const TGswKey* key, double alpha);
+EXPORT void delete_TLweAutomorphismKey(TLweAutomorphismKey* obj);
+
+/** result = TRLWE of m(X^e) under the same key, for sample a TRLWE of m(X) (result != sample) */
+EXPORT void tLweAutomorphism(TLweSample* result, const TLweSample* sample, const TLweAutomorphismKey* ak);
+
+/**
+ * results[c] = tLweAutomorphism(sample, aks[c]), for c < count.
+ * The mask is decomposed and transformed once: tau_e of the decomposition is a decomposition
+ * of tau_e(a) with the same digits, and tau_e is a permutation of the Lagrange values.
+ * Each automorphism then costs k*l permutations and products, and k+1 inverse FFTs.
+ */
+EXPORT void tLweHoistedAutomorphisms(TLweSample* results, const TLweSample* sample,
+                                     const TLweAutomorphismKey* const* aks, int32_t count);
+
+#endif //TLWEAUTOMORPHISM_H
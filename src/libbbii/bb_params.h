@@ -0,0 +1,34 @@
+#ifndef LIBBBII_BB_PARAMS_H
+#define LIBBBII_BB_PARAMS_H
+#include <cmath>
+#include <vector>
+#include <tfhe.h>
+#include <tfhe_core.h>
+// BBIIParams とそのレジストリはルートのパイプラインと共通 (レジストリは 1 つだけ)
+#include "bbii_params.h"
+
+// [追加] BBIIモード管理用enum
+enum class BBIIMode {
+    R12,
+    R13,
+    R12_TO_R13,
+    R13_TO_R12
+};
+
+using bbii::BBIIParams;
+
+// BBII論文推奨値（例: CGGI19, Table 2）
+// lwe_alpha = 2^{-15} ≈ 3.05e-5
+// tlwe_alpha = 2^{-25} ≈ 2.98e-8
+// l = 2, Bgbit = 10 など（論文値に応じて調整）
+constexpr double bbii_lwe_alpha = 3.05e-5;
+constexpr double bbii_tlwe_alpha = 2.98e-8;
+constexpr int32_t bbii_l = 2;
+constexpr int32_t bbii_Bgbit = 10;
+
+// (d, rho, N) と上の論文値のパラメータ。bbii::get_bbii_params の共有インスタンスなので、
+// 同じ値なら同じポインタが返る。プロセス終了まで有効で、解放しないこと
+inline const BBIIParams* get_shared_bbii_params(int32_t d, int32_t rho, int32_t N) {
+    return &bbii::get_bbii_params(d, rho, N, bbii_lwe_alpha, bbii_tlwe_alpha, bbii_l, bbii_Bgbit);
+}
+#endif // LIBBBII_BB_PARAMS_H
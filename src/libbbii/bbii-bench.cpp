@@ -12,24 +12,19 @@
 
 
 
-int main() {
-    // DFTベースBlind Rotateのテスト呼び出し（デバッグ用）
-    // extern void mk_test_blind_rotate_dft(const TFheGateBootstrappingParameterSet* params);
-    // TFheGateBootstrappingParameterSet* test_params = new_default_gate_bootstrapping_parameters(110);
-    // mk_test_blind_rotate_dft(test_params);
-    // delete_gate_bootstrapping_parameters(test_params);
-    int32_t k, rho;
+// usage: bbii-bench-<fft> [k] [rho] [repeat]   (d=2, N=1024 固定)
+int main(int argc, char** argv) {
+    int32_t k = argc > 1 ? std::atoi(argv[1]) : 2;
+    int32_t rho = argc > 2 ? std::atoi(argv[2]) : 2;
+    int32_t REPEAT = argc > 3 ? std::atoi(argv[3]) : 1;
     int32_t d = 2; // fixed
     int32_t N = 1024;
-    int32_t REPEAT;
+    if (k < 1 || rho < 1 || REPEAT < 1) {
+        std::cerr << "usage: " << argv[0] << " [k] [rho] [repeat]" << std::endl;
+        return 1;
+    }
     std::cout << "=== MK-TFHE Time Profiling ===" << std::endl;
-    std::cout << "パーティ数 k を入力してください: ";
-    std::cin >> k;
-    std::cout << "パラメータ rho を入力してください: ";
-    std::cin >> rho;
-    std::cout << "試行回数を入力してください: ";
-    std::cin >> REPEAT;
-    std::cout << "(d=2, N=1024 固定)" << std::endl;
+    std::cout << "(k=" << k << ", rho=" << rho << ", repeat=" << REPEAT << ", d=2, N=1024 固定)" << std::endl;
 
     // 平均用バッファ
     double sum_keygen = 0, sum_inputpack = 0, sum_blind = 0, sum_dft = 0, sum_extract = 0, sum_total = 0;
@@ -43,7 +38,6 @@ int main() {
         std::cout << "\n[Run " << rep << "/" << REPEAT << "]" << std::endl;
         std::cout << "Initializing Params..." << std::endl;
         MKParams* mp = get_mk_test_params(k, d, rho, N);
-        BBIIParams* bp = mp->sk_params;
 
         std::cout << "==================================" << std::endl;
         std::cout << "         [Parameters]            " << std::endl;
@@ -66,20 +60,22 @@ int main() {
             sks[i] = new MKSecretKey(mp->get_tfhe_params()); 
             bk->generateKeyForParty(i, sks[i], mp->get_tfhe_params()); 
         }
-        // KSK生成（Automorphism用KeySwitchingKeyを正しくセット）
-        // 例: delta=1用KSKを生成してキャッシュに登録
-        int delta = 1; // 必要に応じて変更
-        auto* ksk = new BBII_KSKStruct(k, mp->n_per_party, mp->get_tfhe_params());
-        mk_fill_automorphism_ksk(ksk, sks, mp->get_tfhe_params());
-        bk->ksk_cache[delta] = ksk;
+        // 自己同型用KSKは初回使用時にストアが生成する（秘密鍵を登録）
+        // MK_KEY_STORE にファイルを指定すると、そこから事前読み込みし、終了時に書き出す
+        bk->key_store->set_secret_keys(sks);
+        const char* key_store_path = std::getenv("MK_KEY_STORE");
+        if (key_store_path) {
+            int32_t n_loaded = bk->key_store->preload(key_store_path);
+            std::cout << "Key store: " << (n_loaded < 0 ? 0 : n_loaded) << " keys preloaded from " << key_store_path << std::endl;
+        }
         auto kg_end = std::chrono::high_resolution_clock::now();
         double keygen1 = global_profiler.time_keygen;
         global_profiler.time_keygen = (keygen1 - keygen0) + std::chrono::duration<double, std::milli>(kg_end - kg_start).count();
 
         std::cout << "Encrypting..." << std::endl;
-        // バッチ用入力生成
+        // バッチ用入力生成 (テストベクタの値も同じ 1/8)
         int batch_size = 8;
-        std::vector<Torus32> plains(batch_size, 1000);
+        std::vector<Torus32> plains(batch_size, modSwitchToTorus32(1, 8));
         std::vector<MKRLweSample*> ins(batch_size);
         for(int i=0;i<batch_size;++i) {
             ins[i] = new MKRLweSample(k, mp->get_tfhe_params());
@@ -95,27 +91,6 @@ int main() {
         auto bs_end = std::chrono::high_resolution_clock::now();
         double total_bs_time = std::chrono::duration<double, std::milli>(bs_end - bs_start).count();
 
-        for(int b=0;b<batch_size;++b) {
-            std::cout << "[DEBUG] After Bootstrapping. outs[" << b << "]->k=" << outs[b]->k << ", outs[" << b << "]->N=" << outs[b]->N << std::endl;
-            std::cout << "[DEBUG] outs[" << b << "]->parts[0]->coefsT[0..7]: ";
-            for(int i=0;i<8 && i<outs[b]->N;++i) std::cout << outs[b]->parts[0]->coefsT[i] << " ";
-            std::cout << std::endl;
-
-            // 復号（デバッグ用出力追加）
-            std::cout << "[DEBUG] Before Decryption: plain=" << plains[b] << std::endl;
-            Torus32 decrypted = mk_lwe_decrypt(outs[b], sks, mp->get_tfhe_params());
-            std::cout << "[DEBUG] After Decryption: decrypted=" << decrypted << std::endl;
-            std::cout << std::endl;
-            std::cout << "[Decryption Check]" << std::endl;
-            std::cout << "  Original Plaintext : " << plains[b] << std::endl;
-            std::cout << "  Decrypted Value    : " << decrypted << std::endl;
-            if (plains[b] == decrypted) {
-                std::cout << "  [OK] Decryption matches original plaintext." << std::endl;
-            } else {
-                std::cout << "  [NG] Decryption does NOT match original plaintext!" << std::endl;
-            }
-            std::cout << std::endl;
-        }
         std::cout << "==================================" << std::endl;
         std::cout << "         [Time Profile]           " << std::endl;
         std::cout << "==================================" << std::endl;
@@ -137,6 +112,11 @@ int main() {
         sum_extract  += global_profiler.time_sample_extract;
         sum_total    += total_bs_time;
 
+        const MKEvalKeyStore::Stats& ks_stats = bk->key_store->stats();
+        std::cout << "  Key store: " << bk->key_store->count() << " keys, " << (bk->key_store->size_bytes() >> 20) << " MiB, "
+                  << ks_stats.hits << " hits / " << ks_stats.misses << " misses / " << ks_stats.evictions << " evictions" << std::endl;
+        if (key_store_path) bk->key_store->save(key_store_path);
+
         // メモリ解放（必要に応じて）
         for(int i=0;i<batch_size;++i) {
             delete ins[i];
@@ -158,6 +138,5 @@ int main() {
     std::cout << "Total Execution Time       : " << (sum_total/REPEAT) << " ms" << std::endl;
     std::cout << "==================================" << std::endl;
 
-
     return 0;
 }
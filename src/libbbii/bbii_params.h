@@ -0,0 +1,70 @@
+#ifndef LIBBBII_BBII_PARAMS_H
+#define LIBBBII_BBII_PARAMS_H
+#include <cmath>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <tfhe.h>
+#include <tfhe_core.h>
+
+// BBIIParams とそのレジストリ。ルートのパイプライン (bb_params.h) と src/libbbii で共通
+namespace bbii {
+struct BBIIParams {
+    int32_t n; int32_t N; int32_t d; int32_t rho; int32_t r;
+    TFheGateBootstrappingParameterSet* tfhe_params;
+    double lwe_alpha; double tlwe_alpha; int32_t l; int32_t Bgbit;
+    // Torus32 -> Z_{2N} の mod switch 定数 (2N は 2 の冪): (x + ms_offset) >> ms_shift
+    int32_t ms_shift; uint32_t ms_offset;
+    
+    BBIIParams(int32_t d_val, int32_t rho_val, int32_t N_val,
+               double lwe_alpha_val = 3.0e-5, double tlwe_alpha_val = 9.0e-9, int32_t l_val = 3, int32_t Bgbit_val = 10)
+        : N(N_val), d(d_val), rho(rho_val), lwe_alpha(lwe_alpha_val), tlwe_alpha(tlwe_alpha_val), l(l_val), Bgbit(Bgbit_val) {
+        // n = 2 * d^rho
+        n = 2 * std::pow(d, rho); 
+        r = N / 2; 
+        
+        static const int32_t k = 1;
+        static const int32_t ks_t = 10;
+        static const int32_t ks_basebit = 1;
+        
+        LweParams* lwe_p = new_LweParams(n, lwe_alpha, 1.0/2.0);
+        TLweParams* tlwe_p = new_TLweParams(N, k, tlwe_alpha, 1.0/2.0);
+        TGswParams* tgsw_p = new_TGswParams(l, Bgbit, tlwe_p);
+        
+        tfhe_params = new TFheGateBootstrappingParameterSet(ks_t, ks_basebit, lwe_p, tgsw_p);
+
+        int32_t log2_2N = 0;
+        while ((1 << log2_2N) < 2 * N) ++log2_2N;
+        ms_shift = 32 - log2_2N;
+        ms_offset = uint32_t(1) << (ms_shift - 1);
+        xai_table.reset(new std::atomic<LagrangeHalfCPolynomial*>[2 * N]());
+    }
+    ~BBIIParams() {
+        for (int32_t a = 0; a < 2 * N; ++a) {
+            if (LagrangeHalfCPolynomial* p = xai_table[a].load()) delete_LagrangeHalfCPolynomial(p);
+        }
+        delete_gate_bootstrapping_parameters(tfhe_params);
+    }
+    BBIIParams(const BBIIParams&) = delete;
+    BBIIParams& operator=(const BBIIParams&) = delete;
+
+    // X^a (a mod 2N) の Lagrange 表現の置き場。xai_lagrange() が初回だけ埋め、以降はロックなしで読む
+    mutable std::unique_ptr<std::atomic<LagrangeHalfCPolynomial*>[]> xai_table;
+};
+
+// 値の組ごとに 1 つだけ作られるプロセス共有のパラメータ (スレッド安全)
+// 同じ値なら同じ参照が返るので、パラメータの同一性をキーにしたキャッシュがそのまま使える。解放しないこと
+inline const BBIIParams& get_bbii_params(int32_t d, int32_t rho, int32_t N,
+                                         double lwe_alpha = 3.0e-5, double tlwe_alpha = 9.0e-9, int32_t l = 3, int32_t Bgbit = 10) {
+    typedef std::tuple<int32_t, int32_t, int32_t, double, double, int32_t, int32_t> Key;
+    static std::mutex registry_mtx;
+    static std::map<Key, std::unique_ptr<BBIIParams>> registry;
+    std::lock_guard<std::mutex> lock(registry_mtx);
+    std::unique_ptr<BBIIParams>& params = registry[Key(d, rho, N, lwe_alpha, tlwe_alpha, l, Bgbit)];
+    if (!params) params.reset(new BBIIParams(d, rho, N, lwe_alpha, tlwe_alpha, l, Bgbit));
+    return *params;
+}
+}
+#endif // LIBBBII_BBII_PARAMS_H
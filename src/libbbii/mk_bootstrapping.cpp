@@ -41,9 +41,9 @@ void mk_blind_rotate_dft(MKRLweSample* acc, const MKRLweSample* bk_input, const
     int delta = ((_2N - bar_b) % _2N) / 2; // X^delta回転
     std::vector<int> permutation(N);
     for(int i=0; i<N; ++i) permutation[i] = (i + delta) % N;
-    MKPackedRGSW* perm_key = get_perm_key_cached(const_cast<MKBootstrappingKey*>(mk_bk), permutation, params);
-    BBII_KSKStruct* ksk = get_ksk_cached(const_cast<MKBootstrappingKey*>(mk_bk), delta, k, N, params);
-    mk_batch_anti_rot(acc_packed, perm_key, ksk, params);
+    std::shared_ptr<MKPackedRGSW> perm_key = get_perm_key_cached(const_cast<MKBootstrappingKey*>(mk_bk), permutation, params);
+    std::shared_ptr<BBII_KSKStruct> ksk = get_ksk_cached(const_cast<MKBootstrappingKey*>(mk_bk), delta, k, N, params);
+    mk_batch_anti_rot(acc_packed, perm_key.get(), ksk.get(), params);
 
     // 5. Homomorphic IDFT（再帰版）
     std::vector<MKPackedRLWE*> idft_inputs;
@@ -64,65 +64,47 @@ void mk_blind_rotate_dft(MKRLweSample* acc, const MKRLweSample* bk_input, const
 
     delete acc_packed;
 }
-void mk_cmux(MKRLweSample*, const TGswSampleFFT*, const MKRLweSample*, const MKRLweSample*, int32_t, const TFheGateBootstrappingParameterSet*);
-void mk_rlwe_clear(MKRLweSample*); 
-void mk_mul_xai(MKRLweSample* r, const MKRLweSample* s, int32_t b, int32_t N){
-    for(int i=0;i<=s->k;++i) {
-        if (r->parts[i]->N != s->parts[i]->N) {
-            TorusPolynomial* old = r->parts[i];
-            r->parts[i] = new_TorusPolynomial(s->parts[i]->N);
-            torusPolynomialClear(r->parts[i]);
-            delete_TorusPolynomial(old);
-        }
-        torusPolynomialMulByXai(r->parts[i], b, s->parts[i]);
-    }
-    r->N = s->N;
-}
 
+// Blind Rotate: 作業領域を 1 回だけ確保し、(u, i) ごとの CMUX は mk_blind_rotate_cmux に任せる
 void mk_blind_rotate(MKRLweSample* acc, const MKRLweSample* bk_input, const MKBootstrappingKey* mk_bk, const TFheGateBootstrappingParameterSet* params) {
     auto br_start = std::chrono::high_resolution_clock::now();
     double extprod_start = global_profiler.time_external_product;
 
+    MKBlindRotateWorkspace ws(acc->k, params);
+    mk_blind_rotate_cmux(acc, bk_input, mk_bk, params, &ws);
+
+    auto br_end = std::chrono::high_resolution_clock::now();
+    double br_total = std::chrono::duration<double, std::milli>(br_end - br_start).count();
+    double extprod_end = global_profiler.time_external_product;
+    double extprod_diff = extprod_end - extprod_start;
+    global_profiler.time_blind_rotate_control += br_total - extprod_diff;
+}
+
+// CMUX 版 Blind Rotate: 各 (u, i) で acc += bk_fft[u][i] * (X^{bar_ai} * acc - acc) を ws の作業領域だけで計算する
+void mk_blind_rotate_cmux(MKRLweSample* acc, const MKRLweSample* bk_input, const MKBootstrappingKey* mk_bk, const TFheGateBootstrappingParameterSet* params, MKBlindRotateWorkspace* ws) {
     int32_t k=acc->k, n=mk_bk->n_per_party, N=acc->N, _2N=2*N;
     int32_t bar_b = modSwitchFromTorus32(bk_input->parts[k]->coefsT[0], _2N);
 
-    // accをBBII用にラップ
-    MKPackedRLWE* acc_packed = new MKPackedRLWE(k, params, BBIIMode::R12);
-    mk_rlwe_copy(acc_packed->sample, acc);
-
-    int32_t a0 = ((_2N - bar_b) % _2N);
-    mk_mul_xai(acc_packed->sample, acc_packed->sample, a0, N);
+    // X^{-bar_b} 倍 (torusPolynomialMulByXai の次数は 0 <= a < 2N なので 2N - bar_b を渡す。負の次数は範囲外書き込みになる)
+    // 回転にはコピー元が要るので ws->diff を一時バッファに使う
+    int32_t a0 = (_2N - bar_b) % _2N;
+    for (int i = 0; i <= k; ++i) {
+        torusPolynomialCopy(ws->diff + i, acc->parts[i]);
+        torusPolynomialMulByXai(acc->parts[i], a0, ws->diff + i);
+    }
 
-    // BBII型: iごとに全uのbk_packedをまとめて一括外部積
-    std::cout << "  [Progress] Blind Rotate (BBII) loop start..." << std::endl;
-    for (int i = 0; i < n; ++i) {
-        std::vector<MKPackedRGSW*> bk_vec;
-        std::vector<int32_t> coeff_vec;
-        for (int u = 0; u < k; ++u) {
+    for (int u = 0; u < k; ++u) {
+        for (int i = 0; i < n; ++i) {
             int32_t bar_ai = modSwitchFromTorus32(bk_input->parts[u]->coefsT[i], _2N);
             if (bar_ai == 0) continue;
-            bk_vec.push_back(mk_bk->bk_packed[u][i]);
-            coeff_vec.push_back(bar_ai);
-        }
-        if (!bk_vec.empty()) {
-            mk_vec_mat_mult(acc_packed, bk_vec, coeff_vec, params);
+            mk_cmux_rotate(acc, mk_bk->bk_fft[u][i], bar_ai, u, params, ws);
         }
     }
-
-    // 結果を書き戻す
-    mk_rlwe_copy(acc, acc_packed->sample);
-    delete acc_packed;
-
-    auto br_end = std::chrono::high_resolution_clock::now();
-    double br_total = std::chrono::duration<double, std::milli>(br_end - br_start).count();
-    double extprod_end = global_profiler.time_external_product;
-    double extprod_diff = extprod_end - extprod_start;
-    global_profiler.time_blind_rotate_control = br_total - extprod_diff;
 }
 
 void mk_sample_extract(MKRLweSample* output, const MKRLweSample* acc, const MKBootstrappingKey* mk_bk, const TFheGateBootstrappingParameterSet* params, const LweParams* lwe_params) {
     auto start = std::chrono::high_resolution_clock::now();
-    double extract0 = global_profiler.time_sample_extract;
+    double extprod0 = global_profiler.time_external_product;
 
     int32_t k = acc->k, N = acc->N;
     MKPackedRLWE* acc_packed = new MKPackedRLWE(k, params, BBIIMode::R12);
@@ -140,17 +122,23 @@ void mk_sample_extract(MKRLweSample* output, const MKRLweSample* acc, const MKBo
     std::vector<int> permutation(N);
     for(int i=0;i<N;++i) permutation[i] = (i+delta)%N;
     // perm_key/kskをキャッシュ経由で取得
-    MKPackedRGSW* perm_key = get_perm_key_cached(const_cast<MKBootstrappingKey*>(mk_bk), permutation, params);
-    BBII_KSKStruct* ksk = get_ksk_cached(const_cast<MKBootstrappingKey*>(mk_bk), delta, k, N, params);
+    std::shared_ptr<MKPackedRGSW> perm_key = get_perm_key_cached(const_cast<MKBootstrappingKey*>(mk_bk), permutation, params);
+    std::shared_ptr<BBII_KSKStruct> ksk = get_ksk_cached(const_cast<MKBootstrappingKey*>(mk_bk), delta, k, N, params);
 
     // Batch-Anti-Rot
-    mk_batch_anti_rot(acc_packed, perm_key, ksk, params);
+    mk_batch_anti_rot(acc_packed, perm_key.get(), ksk.get(), params);
 
     // IDFT
     mk_homomorphic_idft(acc_packed, idft_mat);
 
-    mk_rlwe_copy(const_cast<MKRLweSample*>(acc), acc_packed->sample);
+    // 分散も acc_packed の演算で積み上げた分ごと output に引き継ぐ
+    mk_rlwe_copy(output, acc_packed->sample);
 
     delete acc_packed;
+
+    auto end = std::chrono::high_resolution_clock::now();
+    // Batch-Permute の外部積は time_external_product 側に計上済み
+    global_profiler.time_sample_extract += std::chrono::duration<double, std::milli>(end - start).count()
+        - (global_profiler.time_external_product - extprod0);
 }
 
@@ -0,0 +1,167 @@
+// 標準ライブラリ
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// TFHEライブラリ
+#include <tfhe_io.h>
+
+// プロジェクトヘッダ
+#include "mk_tfhe_structs.h"
+#include "mk_key_store.h"
+
+// s_out(X^exponent): 係数 i は位置 i*exponent mod 2N へ (N 以上なら符号反転)
+void mk_automorphism_lwe_key(LweKey* result, const LweKey* key, int32_t exponent) {
+    const int32_t N = key->params->n;
+    const int32_t _2N = 2 * N;
+    int32_t e = exponent % _2N;
+    if (e < 0) e += _2N;
+    // 鍵を多項式として扱い、添字・符号テーブルによる置換を使う
+    IntPolynomial* src = new_IntPolynomial_array(2, N);
+    IntPolynomial* dst = src + 1;
+    std::memcpy(src->coefs, key->key, N * sizeof(int32_t));
+    intPolynomialAutomorphism(dst, src, e);
+    std::memcpy(result->key, dst->coefs, N * sizeof(int32_t));
+    delete_IntPolynomial_array(2, src);
+}
+
+MKEvalKeyStore::MKEvalKeyStore(const TFheGateBootstrappingParameterSet* params, size_t capacity_bytes)
+    : params(params), capacity(capacity_bytes), used_bytes(0) {}
+
+MKEvalKeyStore::~MKEvalKeyStore() {}
+
+void MKEvalKeyStore::set_capacity(size_t bytes) {
+    capacity = bytes;
+    evict();
+}
+
+size_t MKEvalKeyStore::ksk_bytes() const {
+    const int32_t n = params->in_out_params->n;
+    return (size_t)n * KS_T * (1 << KS_BASEBIT) * (n + 1) * sizeof(Torus32);
+}
+
+size_t MKEvalKeyStore::rgsw_bytes() const {
+    const TGswParams* p = params->tgsw_params;
+    const int32_t k = p->tlwe_params->k;
+    // kpl 行 x (k+1) 多項式, Lagrange 表現は N/2 個の複素数
+    return (size_t)p->kpl * (k + 1) * p->tlwe_params->N * sizeof(double);
+}
+
+MKEvalKeyStore::Entry* MKEvalKeyStore::lookup(const KeyId& id) {
+    auto it = index.find(id);
+    if (it == index.end()) return nullptr;
+    lru.splice(lru.begin(), lru, it->second); // 最近使用へ移動 (イテレータは有効なまま)
+    return &lru.front();
+}
+
+void MKEvalKeyStore::insert(Entry&& e) {
+    used_bytes += e.bytes;
+    lru.push_front(std::move(e));
+    index[lru.front().id] = lru.begin();
+    evict();
+}
+
+void MKEvalKeyStore::evict() {
+    // 挿入直後の鍵 (先頭) は容量を超えていても残す
+    while (used_bytes > capacity && lru.size() > 1) {
+        Entry& victim = lru.back();
+        used_bytes -= victim.bytes;
+        index.erase(victim.id);
+        lru.pop_back();
+        st.evictions++;
+    }
+}
+
+std::shared_ptr<LweKeySwitchKey> MKEvalKeyStore::get_automorphism_ksk(int32_t exponent, int32_t party) {
+    const int32_t _2N = 2 * params->in_out_params->n;
+    int32_t e = exponent % _2N;
+    if (e < 0) e += _2N;
+    KeyId id{KeyKind::AUTOMORPHISM_KSK, e, party};
+    if (Entry* hit = lookup(id)) {
+        st.hits++;
+        return hit->ksk;
+    }
+    st.misses++;
+
+    if (party < 0 || party >= (int32_t)sks.size() || !sks[party]) {
+        std::cerr << "[MKEvalKeyStore] no secret key for party " << party << std::endl;
+        return nullptr;
+    }
+
+    // KSK: s_u(X^e) -> s_u(X)
+    const LweParams* lwe_p = params->in_out_params;
+    LweKey* s_out = sks[party]->lwe_key;
+    LweKey* s_in = new_LweKey(lwe_p);
+    mk_automorphism_lwe_key(s_in, s_out, e);
+    std::shared_ptr<LweKeySwitchKey> ksk(new_LweKeySwitchKey(lwe_p->n, KS_T, KS_BASEBIT, lwe_p), delete_LweKeySwitchKey);
+    lweCreateKeySwitchKey(ksk.get(), s_in, s_out);
+    delete_LweKey(s_in);
+
+    insert(Entry{id, ksk, nullptr, ksk_bytes()});
+    return ksk;
+}
+
+std::shared_ptr<MKPackedRGSW> MKEvalKeyStore::get_permutation_key(int32_t perm_id, int32_t party) {
+    KeyId id{KeyKind::PERMUTATION_RGSW, perm_id, party};
+    if (Entry* hit = lookup(id)) {
+        st.hits++;
+        return hit->rgsw;
+    }
+    st.misses++;
+
+    // 置換鍵は X^delta の自明な RGSW なので、秘密鍵なしで生成できる
+    std::shared_ptr<MKPackedRGSW> key(mk_create_permutation_key(std::vector<int>(1, perm_id), params));
+    insert(Entry{id, nullptr, key, rgsw_bytes()});
+    return key;
+}
+
+// ファイル形式: "MKEK", 個数, 各鍵ごとに (kind, index, party) と export_lweKeySwitchKey_toStream
+static const char KEY_STORE_MAGIC[4] = {'M', 'K', 'E', 'K'};
+
+int32_t MKEvalKeyStore::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) return -1;
+    int32_t n_ksk = 0;
+    for (const Entry& e : lru) if (e.ksk) n_ksk++;
+    out.write(KEY_STORE_MAGIC, 4);
+    out.write((const char*)&n_ksk, sizeof(int32_t));
+    for (const Entry& e : lru) {
+        if (!e.ksk) continue;
+        int32_t hdr[3] = {(int32_t)e.id.kind, e.id.index, e.id.party};
+        out.write((const char*)hdr, sizeof(hdr));
+        export_lweKeySwitchKey_toStream(out, e.ksk.get());
+    }
+    return out ? n_ksk : -1;
+}
+
+int32_t MKEvalKeyStore::preload(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return -1;
+    char magic[4];
+    int32_t n_ksk = 0;
+    in.read(magic, 4);
+    in.read((char*)&n_ksk, sizeof(int32_t));
+    if (!in || std::memcmp(magic, KEY_STORE_MAGIC, 4) != 0) {
+        std::cerr << "[MKEvalKeyStore] " << path << " is not a key store file" << std::endl;
+        return -1;
+    }
+
+    const int32_t n = params->in_out_params->n;
+    int32_t loaded = 0;
+    for (int32_t i = 0; i < n_ksk; ++i) {
+        int32_t hdr[3];
+        in.read((char*)hdr, sizeof(hdr));
+        if (!in) break;
+        std::shared_ptr<LweKeySwitchKey> ksk(new_lweKeySwitchKey_fromStream(in), delete_LweKeySwitchKey);
+        if (ksk->n != n || ksk->t != KS_T || ksk->basebit != KS_BASEBIT || ksk->out_params->n != n) {
+            std::cerr << "[MKEvalKeyStore] " << path << ": key for other parameters, skipped" << std::endl;
+            continue;
+        }
+        KeyId id{(KeyKind)hdr[0], hdr[1], hdr[2]};
+        if (index.count(id)) continue;
+        insert(Entry{id, ksk, nullptr, ksk_bytes()});
+        loaded++;
+    }
+    st.loaded += loaded;
+    return loaded;
+}
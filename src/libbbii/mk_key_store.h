@@ -0,0 +1,110 @@
+#ifndef MK_KEY_STORE_H
+#define MK_KEY_STORE_H
+
+// 標準ライブラリ
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// TFHEライブラリ
+#include <tfhe.h>
+#include <tfhe_core.h>
+
+// プロジェクトヘッダ
+#include "bb_params.h"
+
+struct MKPackedRGSW;
+struct MKSecretKey;
+
+// s_out(X) から s_out(X^exponent) を作る (負巡回: X^N = -1, exponent は奇数)
+void mk_automorphism_lwe_key(LweKey* result, const LweKey* key, int32_t exponent);
+
+/**
+ * @brief 評価鍵ストア
+ * * (自己同型の指数 または 置換ID, パーティ) ごとに、自己同型用KSKと置換RGSWを保持します。
+ * - 初回アクセス時に生成 (KSK は set_secret_keys で渡した鍵から)
+ * - 合計サイズが容量を超えたら、最も長く使われていない鍵から破棄 (LRU)
+ * - KSK はファイルへ保存 / ファイルから事前読み込み可能
+ * 返す鍵は shared_ptr なので、破棄された後も使用中の鍵は有効なままです。
+ */
+class MKEvalKeyStore {
+public:
+    enum class KeyKind : int32_t {
+        AUTOMORPHISM_KSK = 0, // index = 自己同型の指数 (mod 2N)
+        PERMUTATION_RGSW = 1  // index = 置換ID (回転量 delta)
+    };
+
+    struct KeyId {
+        KeyKind kind;
+        int32_t index;
+        int32_t party;
+        bool operator<(const KeyId& o) const {
+            if (kind != o.kind) return kind < o.kind;
+            if (index != o.index) return index < o.index;
+            return party < o.party;
+        }
+    };
+
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t evictions = 0;
+        uint64_t loaded = 0;
+    };
+
+    // KSK の分解パラメータは BBII_KSKStruct と同じ (t=8, basebit=2)
+    static constexpr int32_t KS_T = 8;
+    static constexpr int32_t KS_BASEBIT = 2;
+
+    MKEvalKeyStore(const TFheGateBootstrappingParameterSet* params, size_t capacity_bytes = size_t(1) << 30);
+    ~MKEvalKeyStore();
+    MKEvalKeyStore(const MKEvalKeyStore&) = delete;
+    void operator=(const MKEvalKeyStore&) = delete;
+
+    // KSK の遅延生成に使う秘密鍵 (実験では全パーティの鍵が同じプロセスにある)
+    void set_secret_keys(const std::vector<MKSecretKey*>& sks) { this->sks = sks; }
+    // 容量 (バイト) を変更し、超えていれば破棄する
+    void set_capacity(size_t bytes);
+
+    // s_party(X^exponent) -> s_party(X) の KSK
+    std::shared_ptr<LweKeySwitchKey> get_automorphism_ksk(int32_t exponent, int32_t party);
+    // 置換 (回転量 perm_id) の RGSW
+    std::shared_ptr<MKPackedRGSW> get_permutation_key(int32_t perm_id, int32_t party = 0);
+
+    // KSK をファイルから読み込む (読み込んだ個数, 失敗なら -1)
+    int32_t preload(const std::string& path);
+    // 保持している KSK をファイルへ書き出す (書き出した個数, 失敗なら -1)
+    int32_t save(const std::string& path) const;
+
+    size_t size_bytes() const { return used_bytes; }
+    size_t count() const { return index.size(); }
+    const Stats& stats() const { return st; }
+
+private:
+    struct Entry {
+        KeyId id;
+        std::shared_ptr<LweKeySwitchKey> ksk;
+        std::shared_ptr<MKPackedRGSW> rgsw;
+        size_t bytes;
+    };
+
+    const TFheGateBootstrappingParameterSet* params;
+    std::vector<MKSecretKey*> sks;
+    size_t capacity;
+    size_t used_bytes;
+    std::list<Entry> lru; // 先頭が最近使用したもの
+    std::map<KeyId, std::list<Entry>::iterator> index;
+    Stats st;
+
+    Entry* lookup(const KeyId& id);
+    void insert(Entry&& e);
+    void evict();
+    size_t ksk_bytes() const;
+    size_t rgsw_bytes() const;
+};
+
+#endif // MK_KEY_STORE_H
@@ -4,7 +4,7 @@
 #include <cstdlib>
 #include <vector>
 #include <chrono>
-#include <tfhe/tfhe.h>
+#include <tfhe.h>
 
 
 Torus32 get_rnd() { 
@@ -23,14 +23,14 @@ void mk_lwe_sym_encrypt(MKRLweSample* res, Torus32 msg, const MKSecretKey* sk, i
             res->parts[u]->coefsT[i] = 0;
         }
     }
-    // pid番目のパーティの0次係数に平文+ノイズをセット
+    // pid番目のパーティにマスク、body (parts[k] の0次係数) に平文+ノイズをセット (mk_lwe_decrypt と同じ配置)
     Torus32 prod = 0;
     for(int i=0; i<n_per_party; ++i) {
         Torus32 a = get_rnd();
         res->parts[pid]->coefsT[i] = a;
         if(sk->lwe_key->key[i]) prod += a;
     }
-    res->parts[pid]->coefsT[0] = prod + msg + gaussian32(0, p->in_out_params->alpha_min);
+    res->parts[res->k]->coefsT[0] = prod + msg + gaussian32(0, p->in_out_params->alpha_min);
     auto end = std::chrono::high_resolution_clock::now();
     global_profiler.time_encrypt += std::chrono::duration<double, std::milli>(end - start).count();
 }
@@ -12,19 +12,25 @@ void mk_batch_bootstrapping(
 ) {
     int batch_size = 8; // paramsから計算する場合は d^rho
     int32_t k = inputs[0]->k;
-    // --- Input Packing ---
+    // --- Input Packing: テストベクタ mus[i] * (1 + X + ... + X^{N-1}) (足りない分は 0 で埋める) ---
     auto t_pack_start = std::chrono::high_resolution_clock::now();
     std::vector<MKPackedRLWE*> packed_inputs;
-    for(size_t i=0; i<batch_size; ++i) {
+    for(size_t i=0; i<(size_t)batch_size; ++i) {
         MKPackedRLWE* acc = new MKPackedRLWE(k, params, BBIIMode::R12);
         mk_rlwe_clear(acc->sample);
         if (i < inputs.size()) {
-            acc->sample->parts[k]->coefsT[0] = mus[i];
+            TorusPolynomial* body = acc->sample->parts[k];
+            for(int32_t j=0; j<body->N; ++j) body->coefsT[j] = mus[i];
         }
         packed_inputs.push_back(acc);
     }
     auto t_pack_end = std::chrono::high_resolution_clock::now();
-    global_profiler.time_input_packing = std::chrono::duration<double, std::milli>(t_pack_end - t_pack_start).count();
+    global_profiler.time_input_packing += std::chrono::duration<double, std::milli>(t_pack_end - t_pack_start).count();
+
+    // --- Blind Rotate: 暗号化された入力で acc を X^{-phase} 倍する ---
+    for(size_t i=0; i<inputs.size() && i<packed_inputs.size(); ++i) {
+        mk_blind_rotate(packed_inputs[i]->sample, inputs[i], mk_bk, params);
+    }
 
     // --- DFT ---
     int N = params->in_out_params->n;
@@ -32,7 +38,7 @@ void mk_batch_bootstrapping(
     auto t_dft_start = std::chrono::high_resolution_clock::now();
     mk_homomorphic_dft_batch(packed_inputs, dft_matrix);
     auto t_dft_end = std::chrono::high_resolution_clock::now();
-    global_profiler.time_external_product = std::chrono::duration<double, std::milli>(t_dft_end - t_dft_start).count();
+    global_profiler.time_external_product += std::chrono::duration<double, std::milli>(t_dft_end - t_dft_start).count();
 
     // --- IDFT ---
     auto idft_matrix = mk_create_dft_matrix(N, true);
@@ -48,7 +54,7 @@ void mk_batch_bootstrapping(
         mk_rlwe_copy(results[i], packed_inputs[i]->sample);
     }
     auto t_extract_end = std::chrono::high_resolution_clock::now();
-    global_profiler.time_sample_extract = std::chrono::duration<double, std::milli>(t_extract_end - t_extract_start).count();
+    global_profiler.time_sample_extract += std::chrono::duration<double, std::milli>(t_extract_end - t_extract_start).count();
 
     // メモリ解放
     for(auto* acc : packed_inputs) delete acc;
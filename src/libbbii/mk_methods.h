@@ -7,6 +7,10 @@
 
 // DFTベースBlind Rotate（BBII本体）
 void mk_blind_rotate_dft(MKRLweSample* acc, const MKRLweSample* bk_input, const MKBootstrappingKey* mk_bk, const TFheGateBootstrappingParameterSet* params);
+// Blind Rotate (acc <- X^{-b + sum a_i s_i} * acc)。作業領域を確保して mk_blind_rotate_cmux を呼ぶ
+void mk_blind_rotate(MKRLweSample* acc, const MKRLweSample* bk_input, const MKBootstrappingKey* mk_bk, const TFheGateBootstrappingParameterSet* params);
+// CMUX 版 Blind Rotate (bk_fft を使う)。ws は acc と同じパーティ数の作業領域で、ループ中は確保しない
+void mk_blind_rotate_cmux(MKRLweSample* acc, const MKRLweSample* bk_input, const MKBootstrappingKey* mk_bk, const TFheGateBootstrappingParameterSet* params, MKBlindRotateWorkspace* ws);
 void mk_lwe_sym_encrypt(MKRLweSample* result, Torus32 message, const MKSecretKey* sk, int32_t party_id, const TFheGateBootstrappingParameterSet* params, int32_t n_per_party);
 Torus32 mk_lwe_decrypt(const MKRLweSample* ciphertext, const std::vector<MKSecretKey*>& all_keys, const TFheGateBootstrappingParameterSet* params);
 void mk_batch_bootstrapping(
@@ -0,0 +1,142 @@
+
+
+
+#include "mk_methods.h"
+#include "mk_profiler.h"
+#include <iostream>
+#include <chrono>
+#include <tfhe.h>
+#include <tfhe_core.h>
+#include <polynomials.h>
+#include <tlwe.h>
+#include <tgsw.h>
+#include <tgsw_functions.h>
+#include <lagrangehalfc_arithmetic.h>
+#include <cmath>
+#include <algorithm>
+
+
+
+void mk_rlwe_clear(MKRLweSample* r) {
+    for(int i=0; i<=r->k; ++i) torusPolynomialClear(r->parts[i]);
+    r->current_variance = 0.0;
+}
+
+void mk_rlwe_copy(MKRLweSample* d, const MKRLweSample* s) {
+    if (d == s) return; // no-op for self-copy
+    for(int i=0; i<=d->k; ++i) {
+        torusPolynomialCopy(d->parts[i], s->parts[i]);
+    }
+    d->current_variance = s->current_variance;
+}
+
+void mk_rlwe_addTo(MKRLweSample* r, const MKRLweSample* s) {
+    for(int i=0; i<=r->k; ++i) torusPolynomialAddTo(r->parts[i], s->parts[i]);
+    r->current_variance += s->current_variance;
+}
+
+void mk_rlwe_subTo(MKRLweSample* r, const MKRLweSample* s) {
+    for(int i=0; i<=r->k; ++i) torusPolynomialSubTo(r->parts[i], s->parts[i]);
+    r->current_variance += s->current_variance;
+}
+
+// k+1 成分それぞれの l 桁 (一様分布, 分散 Bg^2/12) が TRGSW の body 行の誤差 (alpha_min) に掛かる分と、
+// 分解の丸め誤差が秘密鍵 (二値) に掛かる分。libtfhe の分解は切り捨てなので、
+// 丸め誤差の平均 Bg^{-l}/2 が k 人分の鍵との積で揃って加算される分も含める
+double mk_external_product_variance(int32_t k, const TFheGateBootstrappingParameterSet* p) {
+    const TGswParams* tgp = p->tgsw_params;
+    const int32_t N = tgp->tlwe_params->N;
+    const int32_t l = tgp->l;
+    const double alpha = tgp->tlwe_params->alpha_min;
+
+    const double var_digit = ldexp(1.0, 2 * tgp->Bgbit) / 12.0;
+    const double var_round = ldexp(1.0, -2 * tgp->Bgbit * l) / 12.0;
+    const double bias = k * ldexp(1.0, -tgp->Bgbit * l - 1) * N;
+
+    return (k + 1) * l * N * var_digit * alpha * alpha
+        + (1.0 + 0.5 * k * N) * var_round
+        + bias * bias / 12.0;
+}
+
+// (0, acc_i) と bk の外部積を k+1 成分まとめて計算する
+// マスク側 0 の分解桁はすべて 0 なので、acc_i を 1 回だけ分解して body 側の l 行だけを掛ければよい
+// v_i は位置 i に、u_i は位置 pid に Lagrange 空間で足し込み、逆FFTは成分ごとに 1 回 (res == acc でもよい)
+void mk_external_product(MKRLweSample* res, const TGswSampleFFT* bk, const MKRLweSample* acc, int32_t pid, const TFheGateBootstrappingParameterSet* p) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const TGswParams* tgp = p->tgsw_params;
+    const int32_t k = acc->k, N = acc->N, l = tgp->l;
+    const TLweSampleFFT* rows = bk->all_samples + tgp->tlwe_params->k * l;
+
+    LagrangeHalfCPolynomial* decFFT = new_LagrangeHalfCPolynomial_array(l, N);
+    LagrangeHalfCPolynomial* accFFT = new_LagrangeHalfCPolynomial_array(k + 1, N);
+    for(int i=0; i<=k; ++i) LagrangeHalfCPolynomialClear(accFFT + i);
+    for(int i=0; i<=k; ++i) {
+        tGswTorus32PolynomialDecompHFFT(decFFT, acc->parts[i], tgp);
+        for(int32_t j=0; j<l; ++j) {
+            LagrangeHalfCPolynomialAddMul(accFFT + pid, decFFT + j, rows[j].a);
+            LagrangeHalfCPolynomialAddMul(accFFT + i, decFFT + j, rows[j].b);
+        }
+    }
+    for(int i=0; i<=k; ++i) TorusPolynomial_fft(res->parts[i], accFFT + i);
+    res->current_variance = acc->current_variance + mk_external_product_variance(k, p);
+    delete_LagrangeHalfCPolynomial_array(k + 1, accFFT);
+    delete_LagrangeHalfCPolynomial_array(l, decFFT);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    global_profiler.time_external_product += std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// ws->prod = bk ⊡ (0, ws->diff): k+1 成分の差分をまとめて分解し、body 側の各行は 1 回読んだら全成分に掛ける
+static void mk_cmux_product(const TGswSampleFFT* bk, int32_t k, int32_t pid, const TFheGateBootstrappingParameterSet* p, MKBlindRotateWorkspace* ws) {
+    auto start = std::chrono::high_resolution_clock::now();
+
+    const TGswParams* tgp = p->tgsw_params;
+    const int32_t l = tgp->l;
+    const TLweSampleFFT* rows = bk->all_samples + tgp->tlwe_params->k * l;
+
+    // decFFT[i*l+j] = g^{-1}(diff_i)_j
+    for(int i=0; i<=k; ++i) tGswTorus32PolynomialDecompHFFT(ws->decFFT + i * l, ws->diff + i, tgp);
+    // v_i -> accFFT[i], u_i -> accFFT[pid]
+    for(int i=0; i<=k; ++i) LagrangeHalfCPolynomialClear(ws->accFFT + i);
+    for(int32_t j=0; j<l; ++j) {
+        for(int i=0; i<=k; ++i) {
+            LagrangeHalfCPolynomialAddMul(ws->accFFT + pid, ws->decFFT + i * l + j, rows[j].a);
+            LagrangeHalfCPolynomialAddMul(ws->accFFT + i, ws->decFFT + i * l + j, rows[j].b);
+        }
+    }
+    TorusPolynomial_fft_batch(ws->prod, ws->accFFT, k + 1);
+
+    auto end = std::chrono::high_resolution_clock::now();
+    global_profiler.time_external_product += std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+void mk_cmux(MKRLweSample* res, const TGswSampleFFT* bk, const MKRLweSample* in0, const MKRLweSample* in1, int32_t pid, const TFheGateBootstrappingParameterSet* p, MKBlindRotateWorkspace* ws) {
+    const int32_t k = in0->k;
+    // 選択されなかった側の誤差は残らない: 差分の分散 (in0 + in1) ではなく大きい方 (res は in0, in1 と同じでもよい)
+    const double variance = std::max(in0->current_variance, in1->current_variance) + mk_external_product_variance(k, p);
+
+    for(int i=0; i<=k; ++i) torusPolynomialSub(ws->diff + i, in1->parts[i], in0->parts[i]);
+    mk_cmux_product(bk, k, pid, p, ws);
+    for(int i=0; i<=k; ++i) {
+        if (res != in0) torusPolynomialCopy(res->parts[i], in0->parts[i]);
+        torusPolynomialAddTo(res->parts[i], ws->prod + i);
+    }
+    res->current_variance = variance;
+}
+
+void mk_cmux_rotate(MKRLweSample* acc, const TGswSampleFFT* bk, int32_t bar_ai, int32_t pid, const TFheGateBootstrappingParameterSet* p, MKBlindRotateWorkspace* ws) {
+    const int32_t k = acc->k;
+    for(int i=0; i<=k; ++i) torusPolynomialMulByXaiMinusOne(ws->diff + i, bar_ai, acc->parts[i]);
+    mk_cmux_product(bk, k, pid, p, ws);
+    for(int i=0; i<=k; ++i) torusPolynomialAddTo(acc->parts[i], ws->prod + i);
+    acc->current_variance += mk_external_product_variance(k, p);
+}
+
+// BBII型ラッパー: MKPackedRGSWのsampleメンバ（TGswSampleFFT*）を使う
+void mk_external_product(MKRLweSample* res, const MKPackedRGSW* rgsw, const MKRLweSample* acc, int32_t pid, const TFheGateBootstrappingParameterSet* params) {
+    const TGswSampleFFT* bk_fft = rgsw->sample;
+    mk_external_product(res, bk_fft, acc, pid, params);
+}
+
+
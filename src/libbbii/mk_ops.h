@@ -17,7 +17,12 @@ void mk_rlwe_copy(MKRLweSample* dest, const MKRLweSample* src);
 void mk_rlwe_addTo(MKRLweSample* r, const MKRLweSample* s);
 void mk_rlwe_subTo(MKRLweSample* r, const MKRLweSample* s);
 void mk_external_product(MKRLweSample* res, const TGswSampleFFT* bk, const MKRLweSample* acc, int32_t pid, const TFheGateBootstrappingParameterSet* p);
-void mk_cmux(MKRLweSample* res, const TGswSampleFFT* bk, const MKRLweSample* in0, const MKRLweSample* in1, int32_t pid, const TFheGateBootstrappingParameterSet* p);
+// 外部積 1 回で増える分散 (k パーティ、選択ビットは 0 か 1)
+double mk_external_product_variance(int32_t k, const TFheGateBootstrappingParameterSet* p);
+// CMUX: res = in0 + bk * (in1 - in0)。ws (in0 と同じパーティ数) の作業領域だけで計算する (res は in0, in1 と同じでもよい)
+void mk_cmux(MKRLweSample* res, const TGswSampleFFT* bk, const MKRLweSample* in0, const MKRLweSample* in1, int32_t pid, const TFheGateBootstrappingParameterSet* p, MKBlindRotateWorkspace* ws);
+// 回転付き CMUX (in place): acc += bk * (X^{bar_ai} * acc - acc)。mk_cmux(acc, bk, acc, X^{bar_ai} * acc) と同じ結果を ws だけで計算
+void mk_cmux_rotate(MKRLweSample* acc, const TGswSampleFFT* bk, int32_t bar_ai, int32_t pid, const TFheGateBootstrappingParameterSet* p, MKBlindRotateWorkspace* ws);
 
 
 #endif
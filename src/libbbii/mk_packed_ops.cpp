@@ -17,11 +17,12 @@
 #include "mk_tfhe_structs.h"
 #include "mk_ops.h"
 #include "bb_params.h"
+#include <numeric_functions.h>
 
-// Perm/Key cache: ダミー実装
-MKPackedRGSW* get_perm_key_cached(MKBootstrappingKey* mk_bk, const std::vector<int>& permutation, const TFheGateBootstrappingParameterSet* params) {
-    // 常に新しいMKPackedRGSWを返す（本来はキャッシュすべき）
-    return new MKPackedRGSW(params, BBIIMode::R12_TO_R13);
+// Perm/Key cache: 置換ID (回転量 delta = permutation[0]) ごとにストアから取得
+std::shared_ptr<MKPackedRGSW> get_perm_key_cached(MKBootstrappingKey* mk_bk, const std::vector<int>& permutation, const TFheGateBootstrappingParameterSet* params) {
+    int32_t delta = permutation.empty() ? 0 : permutation[0];
+    return mk_bk->key_store->get_permutation_key(delta, 0); // pid=0: 全体一括 (mk_batch_permute)
 }
 
 // 再帰型DFT（ダミー: 実際は分割統治）
@@ -69,16 +70,12 @@ void mk_butterfly(MKPackedRLWE* u, MKPackedRLWE* v, const TFheGateBootstrappingP
 
 // Twiddle Factorの適用（DFT用）
 void mk_apply_twiddle(MKPackedRLWE* acc, int32_t power, int32_t N, const MKBootstrappingKey* mk_bk, const TFheGateBootstrappingParameterSet* params) {
-    // 各成分の多項式を X^power だけ巡回シフト
+    // 各成分の多項式に X^power を掛ける (負巡回: X^N = -1)
+    int32_t p = power % (2 * N);
+    if (p < 0) p += 2 * N;
     int32_t k = acc->sample->k;
     for (int u = 0; u <= k; ++u) {
-        TorusPolynomial* poly = acc->sample->parts[u];
-        std::vector<Torus32> tmp(poly->coefsT, poly->coefsT + N);
-        for (int i = 0; i < N; ++i) {
-            int idx = (i + power) % N;
-            if (idx < 0) idx += N;
-            poly->coefsT[idx] = tmp[i];
-        }
+        torusPolynomialMulByXaiInPlace(acc->sample->parts[u], p);
     }
 }
 
@@ -117,16 +114,13 @@ void mk_homomorphic_idft_recursive(
 // KSK生成: Automorphism後の鍵からKeySwitchingKeyを生成
 void mk_fill_automorphism_ksk(BBII_KSKStruct* ksk, const std::vector<MKSecretKey*>& sks, const TFheGateBootstrappingParameterSet* params) {
     int32_t k = ksk->k;
-    int32_t N = ksk->N;
     const LweParams* lwe_p = params->in_out_params;
     for(int u = 0; u < k; ++u) {
         // 入力鍵 s_in = s_u(X^-1) を作成
         LweKey* s_in = new_LweKey(lwe_p);
         LweKey* s_out = sks[u]->lwe_key;
-        // s_in の生成: s_out の係数を反転 (Automorphism: i -> N-i, 符号反転)
-        for(int i=0; i<N; ++i) {
-            s_in->key[i] = s_out->key[(N-i)%N];
-        }
+        // s_in の生成: s_out(X^{-1}) (Automorphism: i -> N-i, 符号反転)
+        mk_automorphism_lwe_key(s_in, s_out, 2 * lwe_p->n - 1);
         // KSK生成: s_in -> s_out
         lweCreateKeySwitchKey(ksk->ks_keys[u], s_in, s_out);
         delete_LweKey(s_in);
@@ -221,7 +215,7 @@ std::vector<std::vector<std::complex<double>>> mk_create_dft_matrix(int N, bool
 void mk_homomorphic_dft(MKPackedRLWE* acc, const std::vector<std::vector<std::complex<double>>>& dft_matrix) {
     // 各パーティの多項式係数にDFT行列を適用（実際の暗号多項式変換は要実装）
     int k = acc->sample->k;
-    int N = acc->sample->N;
+    int N = (int)dft_matrix.size(); // 行列の次数分の先頭係数 (パックされた LWE は先頭 n 係数) に作用
     for(int u=0; u<=k; ++u) {
         TorusPolynomial* poly = acc->sample->parts[u];
         std::vector<std::complex<double>> input(N);
@@ -233,22 +227,16 @@ void mk_homomorphic_dft(MKPackedRLWE* acc, const std::vector<std::vector<std::co
             }
         }
         // 実部をTorus32に戻す（本実装は要検討）
-        // Torus32変換: 丸め・クリッピング・スケーリング
-        constexpr double torus_max = static_cast<double>(0x7FFFFFFF);
-        constexpr double torus_min = static_cast<double>(-0x80000000);
-        constexpr double scale = 1.0; // 必要に応じて調整
+        // トーラス上の値なのでクリップせず 2^32 を法として丸める
         for(int i=0;i<N;++i) {
-            double val = std::real(output[i]) * scale;
-            if(val > torus_max) val = torus_max;
-            if(val < torus_min) val = torus_min;
-            poly->coefsT[i] = static_cast<Torus32>(std::round(val));
+            poly->coefsT[i] = dtot32(std::round(std::real(output[i])) * 0x1p-32);
         }
     }
 }
 
 void mk_homomorphic_idft(MKPackedRLWE* acc, const std::vector<std::vector<std::complex<double>>>& idft_matrix) {
     int k = acc->sample->k;
-    int N = acc->sample->N;
+    int N = (int)idft_matrix.size();
     for(int u=0; u<=k; ++u) {
         TorusPolynomial* poly = acc->sample->parts[u];
         std::vector<std::complex<double>> input(N);
@@ -259,23 +247,14 @@ void mk_homomorphic_idft(MKPackedRLWE* acc, const std::vector<std::vector<std::c
                 output[i] += idft_matrix[i][j] * input[j];
             }
         }
-        constexpr double torus_max = static_cast<double>(0x7FFFFFFF);
-        constexpr double torus_min = static_cast<double>(-0x80000000);
-        constexpr double scale = 1.0;
         for(int i=0; i<N; ++i) {
-            double val = std::real(output[i]) * scale;
-            if(val > torus_max) val = torus_max;
-            if(val < torus_min) val = torus_min;
-            poly->coefsT[i] = static_cast<Torus32>(std::round(val));
+            poly->coefsT[i] = dtot32(std::round(std::real(output[i])) * 0x1p-32);
         }
     }
 }
-// 多項式のインデックス反転（Automorphism）
+// Automorphism X -> X^{-1}: 係数 i は位置 N-i へ符号反転 (i = 0 はそのまま)
 void mk_poly_automorphism(TorusPolynomial* poly) {
-    int32_t N = poly->N;
-    for (int i = 1; i < N / 2; ++i) {
-        std::swap(poly->coefsT[i], poly->coefsT[N - i]);
-    }
+    torusPolynomialAutomorphismInPlace(poly, 2 * poly->N - 1);
 }
 
 // Inv-Auto: Automorphism+KeySwitching
@@ -296,8 +275,7 @@ void mk_inv_auto(MKPackedRLWE* acc, const BBII_KSKStruct* ksk, const TFheGateBoo
     torusPolynomialCopy(res->parts[0], acc->sample->parts[0]);
 
     // 各パーティの a_i 部分を KeySwitching
-    constexpr int t = 8; // TFHE標準値（要調整）
-    constexpr int basebit = 2; // TFHE標準値（要調整）
+    double ks_variance = 0.0; // 係数ごとの KeySwitch の分散の最大
     for (int u = 1; u <= k; ++u) {
         TorusPolynomial* poly_in = acc->sample->parts[u];
         TorusPolynomial* poly_out = res->parts[u];
@@ -313,11 +291,13 @@ void mk_inv_auto(MKPackedRLWE* acc, const BBII_KSKStruct* ksk, const TFheGateBoo
             lweKeySwitch(lwe_out, ksk->ks_keys[u-1], lwe_tmp);
             // 結果をpoly_outに格納
             poly_out->coefsT[i] = lwe_out->b;
+            ks_variance = std::max(ks_variance, lwe_out->current_variance);
             delete_LweSample(lwe_tmp);
             delete_LweSample(lwe_out);
         }
     }
 
+    res->current_variance = acc->sample->current_variance + ks_variance;
     mk_rlwe_copy(acc->sample, res);
     delete res;
 }
@@ -410,10 +390,13 @@ void mk_vec_mat_mult(
 }
 
 
-// KSK cache: ダミー実装
-BBII_KSKStruct* get_ksk_cached(MKBootstrappingKey* mk_bk, int delta, int k, int N, const TFheGateBootstrappingParameterSet* params) {
-    // 常に新しいBBII_KSKStructを返す（本来はキャッシュすべき）
-    return new BBII_KSKStruct(k, N, params);
+// KSK cache: Inv-Auto の自己同型 X -> X^{-1} (指数 2n-1) の KSK を各パーティ分ストアから取得
+// (Inv-Auto の写像は delta に依らないので、delta ごとには持たない)
+std::shared_ptr<BBII_KSKStruct> get_ksk_cached(MKBootstrappingKey* mk_bk, int delta, int k, int N, const TFheGateBootstrappingParameterSet* params) {
+    const int32_t inv_exponent = 2 * params->in_out_params->n - 1;
+    std::vector<std::shared_ptr<LweKeySwitchKey>> keys(k);
+    for(int u = 0; u < k; ++u) keys[u] = mk_bk->key_store->get_automorphism_ksk(inv_exponent, u);
+    return std::make_shared<BBII_KSKStruct>(keys, N);
 }
 
 
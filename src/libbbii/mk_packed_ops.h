@@ -3,6 +3,7 @@
 
 #include <complex>
 #undef complex
+#include <memory>
 #include <vector>
 #include "bb_params.h"
 #include "mk_ops.h"
@@ -29,8 +30,9 @@ void mk_batch_anti_rot(MKPackedRLWE* acc, const MKPackedRGSW* perm_key, const BB
 void mk_vec_mat_mult(MKPackedRLWE* acc, const std::vector<MKPackedRGSW*>& bk_list, const std::vector<int32_t>& coeffs, const TFheGateBootstrappingParameterSet* params);
 
 // Perm/Key cache
-MKPackedRGSW* get_perm_key_cached(MKBootstrappingKey* mk_bk, const std::vector<int>& permutation, const TFheGateBootstrappingParameterSet* params);
-BBII_KSKStruct* get_ksk_cached(MKBootstrappingKey* mk_bk, int delta, int k, int N, const TFheGateBootstrappingParameterSet* params);
+// (mk_bk->key_store から取得。返す鍵はストアから破棄されても使用中は有効)
+std::shared_ptr<MKPackedRGSW> get_perm_key_cached(MKBootstrappingKey* mk_bk, const std::vector<int>& permutation, const TFheGateBootstrappingParameterSet* params);
+std::shared_ptr<BBII_KSKStruct> get_ksk_cached(MKBootstrappingKey* mk_bk, int delta, int k, int N, const TFheGateBootstrappingParameterSet* params);
 
 // DFT/IDFT・Twiddle
 void mk_apply_inv_twiddle(MKPackedRLWE* acc, int32_t power, int32_t N, const MKBootstrappingKey* mk_bk, const TFheGateBootstrappingParameterSet* params);
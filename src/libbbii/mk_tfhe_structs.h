@@ -8,13 +8,14 @@
 #include <map>
 
 // TFHEライブラリ
-#include <tfhe/tfhe.h>
-#include <tfhe/tgsw.h>
-#include <tfhe/tfhe_core.h>
+#include <tfhe.h>
+#include <tgsw.h>
+#include <tfhe_core.h>
 
 // プロジェクトヘッダ
 #include "bb_params.h"
 #include "mk_utils.h" // 自作アロケータ読み込み
+#include "mk_key_store.h"
 
 
 
@@ -29,6 +30,12 @@ struct BBII_KSKStruct {
     int32_t k;
     int32_t N;
     std::vector<LweKeySwitchKey*> ks_keys; // 各パーティごとのKSK
+    // MKEvalKeyStore の鍵を参照する場合はここで保持 (このときは ks_keys を解放しない)
+    std::vector<std::shared_ptr<LweKeySwitchKey>> held;
+    BBII_KSKStruct(const std::vector<std::shared_ptr<LweKeySwitchKey>>& keys, int32_t N_)
+        : k((int32_t)keys.size()), N(N_), held(keys) {
+        for(auto& key : held) ks_keys.push_back(key.get());
+    }
     BBII_KSKStruct(int32_t parties, int32_t N_, const TFheGateBootstrappingParameterSet* params) : k(parties), N(N_) {
         ks_keys.resize(k);
         constexpr int basebit = 2; // TFHE標準値（要調整）
@@ -39,6 +46,7 @@ struct BBII_KSKStruct {
         }
     }
     ~BBII_KSKStruct() {
+        if(!held.empty()) return;
         for(int i=0;i<k;++i) {
             if(ks_keys[i]) delete_LweKeySwitchKey(ks_keys[i]);
         }
@@ -48,9 +56,10 @@ struct BBII_KSKStruct {
 // --- 2. RLWEサンプル（BBII型） ---
 struct MKRLweSample {
     int32_t k; // パーティ数
-    int32_t N; // 多項式次数
+    int32_t N; // 多項式次数 (TGSW 鍵と同じ環の次数。LWE として使うときは先頭 n 係数)
     std::vector<TorusPolynomial*> parts; // 各パーティのRLWE部分
-    MKRLweSample(int32_t parties, const TFheGateBootstrappingParameterSet* params) : k(parties), N(params->in_out_params->n) {
+    double current_variance; // 位相の誤差の分散 (解析的な見積もり)
+    MKRLweSample(int32_t parties, const TFheGateBootstrappingParameterSet* params) : k(parties), N(params->tgsw_params->tlwe_params->N), current_variance(0.0) {
         parts.resize(k+1);
         for(int i=0;i<=k;++i) {
             parts[i] = new_TorusPolynomial(N);
@@ -64,6 +73,30 @@ struct MKRLweSample {
     }
 };
 
+// --- mk_cmux_rotate 用の作業領域 (CMUX ごとの確保をなくす) ---
+struct MKBlindRotateWorkspace {
+    int32_t k; int32_t N; int32_t l;
+    TorusPolynomial* diff;            // k+1 個: X^{a} * acc - acc
+    TorusPolynomial* prod;            // k+1 個: 積の結果
+    LagrangeHalfCPolynomial* decFFT;  // (k+1)*l 個: diff の分解 (成分 i の j 桁目は i*l+j)
+    LagrangeHalfCPolynomial* accFFT;  // k+1 個: Lagrange 空間のアキュムレータ
+    MKBlindRotateWorkspace(int32_t parties, const TFheGateBootstrappingParameterSet* params)
+        : k(parties), N(params->tgsw_params->tlwe_params->N), l(params->tgsw_params->l) {
+        diff = new_TorusPolynomial_array(k + 1, N);
+        prod = new_TorusPolynomial_array(k + 1, N);
+        decFFT = new_LagrangeHalfCPolynomial_array((k + 1) * l, N);
+        accFFT = new_LagrangeHalfCPolynomial_array(k + 1, N);
+    }
+    ~MKBlindRotateWorkspace() {
+        delete_LagrangeHalfCPolynomial_array(k + 1, accFFT);
+        delete_LagrangeHalfCPolynomial_array((k + 1) * l, decFFT);
+        delete_TorusPolynomial_array(k + 1, prod);
+        delete_TorusPolynomial_array(k + 1, diff);
+    }
+    MKBlindRotateWorkspace(const MKBlindRotateWorkspace&) = delete;
+    void operator=(const MKBlindRotateWorkspace&) = delete;
+};
+
 // --- 3. Packed RGSW（BBII用） ---
 struct MKPackedRGSW {
     TGswSampleFFT* sample; // 実体の暗号文
@@ -105,9 +138,8 @@ struct MKPackedRLWE {
 
 // --- 6. BBII用パックド鍵 ---
 struct MKBootstrappingKey {
-    // perm_key/kskキャッシュ（順列→鍵, delta→鍵）
-    std::map<std::vector<int>, MKPackedRGSW*> perm_key_cache;
-    std::map<int, BBII_KSKStruct*> ksk_cache;
+    // 自己同型KSK・置換RGSWのストア（遅延生成, LRU）
+    MKEvalKeyStore* key_store;
     int32_t k;
     int32_t n_per_party;
     std::vector<std::vector<TGswSampleFFT*>> bk_fft;
@@ -115,6 +147,7 @@ struct MKBootstrappingKey {
     // 自己同型用KeySwitchingKey（各パーティ・各自己同型写像ごと）
     std::vector<std::vector<BBII_KSKStruct*>> auto_ksk;
     MKBootstrappingKey(int32_t parties, int32_t n, const TFheGateBootstrappingParameterSet* params) : k(parties), n_per_party(n) {
+        key_store = new MKEvalKeyStore(params);
         bk_fft.resize(k);
         bk_packed.resize(k);
         auto_ksk.resize(k); // 各パーティ分
@@ -139,8 +172,7 @@ struct MKBootstrappingKey {
                 if(ksk) delete ksk;
             }
         }
-        for(auto& p : perm_key_cache) if(p.second) delete p.second;
-        for(auto& p : ksk_cache) if(p.second) delete p.second;
+        delete key_store;
     }
     void generateKeyForParty(int pid, const MKSecretKey* sk, const TFheGateBootstrappingParameterSet* params) {
         for(int j=0; j<this->n_per_party; ++j) {
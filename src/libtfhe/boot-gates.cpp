@@ -13,6 +13,7 @@
 #include "lwe-functions.h"
 #include "lwebootstrappingkey.h"
 #include "tfhe.h"
+#include "tfhe_thread_pool.h"
 
 using namespace std;
 #else
@@ -36,7 +37,8 @@ bootsNAND(LweSample *result, const LweSample *ca, const LweSample *cb, const TFh
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,1/8) - ca - cb
     static const Torus32 NandConst = modSwitchToTorus32(1, 8);
@@ -46,9 +48,7 @@ bootsNAND(LweSample *result, const LweSample *ca, const LweSample *cb, const TFh
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -62,7 +62,8 @@ bootsOR(LweSample *result, const LweSample *ca, const LweSample *cb, const TFheG
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,1/8) + ca + cb
     static const Torus32 OrConst = modSwitchToTorus32(1, 8);
@@ -72,9 +73,7 @@ bootsOR(LweSample *result, const LweSample *ca, const LweSample *cb, const TFheG
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -88,7 +87,8 @@ bootsAND(LweSample *result, const LweSample *ca, const LweSample *cb, const TFhe
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,-1/8) + ca + cb
     static const Torus32 AndConst = modSwitchToTorus32(-1, 8);
@@ -98,9 +98,7 @@ bootsAND(LweSample *result, const LweSample *ca, const LweSample *cb, const TFhe
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -114,7 +112,8 @@ bootsXOR(LweSample *result, const LweSample *ca, const LweSample *cb, const TFhe
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,1/4) + 2*(ca + cb)
     static const Torus32 XorConst = modSwitchToTorus32(1, 4);
@@ -124,9 +123,7 @@ bootsXOR(LweSample *result, const LweSample *ca, const LweSample *cb, const TFhe
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -140,7 +137,8 @@ bootsXNOR(LweSample *result, const LweSample *ca, const LweSample *cb, const TFh
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,-1/4) + 2*(-ca-cb)
     static const Torus32 XnorConst = modSwitchToTorus32(-1, 4);
@@ -150,9 +148,7 @@ bootsXNOR(LweSample *result, const LweSample *ca, const LweSample *cb, const TFh
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -199,7 +195,8 @@ bootsNOR(LweSample *result, const LweSample *ca, const LweSample *cb, const TFhe
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,-1/8) - ca - cb
     static const Torus32 NorConst = modSwitchToTorus32(-1, 8);
@@ -209,9 +206,7 @@ bootsNOR(LweSample *result, const LweSample *ca, const LweSample *cb, const TFhe
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -225,7 +220,8 @@ bootsANDNY(LweSample *result, const LweSample *ca, const LweSample *cb, const TF
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,-1/8) - ca + cb
     static const Torus32 AndNYConst = modSwitchToTorus32(-1, 8);
@@ -235,9 +231,7 @@ bootsANDNY(LweSample *result, const LweSample *ca, const LweSample *cb, const TF
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -251,7 +245,8 @@ bootsANDYN(LweSample *result, const LweSample *ca, const LweSample *cb, const TF
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,-1/8) + ca - cb
     static const Torus32 AndYNConst = modSwitchToTorus32(-1, 8);
@@ -261,9 +256,7 @@ bootsANDYN(LweSample *result, const LweSample *ca, const LweSample *cb, const TF
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -277,7 +270,8 @@ bootsORNY(LweSample *result, const LweSample *ca, const LweSample *cb, const TFh
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,1/8) - ca + cb
     static const Torus32 OrNYConst = modSwitchToTorus32(1, 8);
@@ -287,9 +281,7 @@ bootsORNY(LweSample *result, const LweSample *ca, const LweSample *cb, const TFh
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -303,7 +295,8 @@ bootsORYN(LweSample *result, const LweSample *ca, const LweSample *cb, const TFh
     static const Torus32 MU = modSwitchToTorus32(1, 8);
     const LweParams *in_out_params = bk->params->in_out_params;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
 
     //compute: (0,1/8) + ca - cb
     static const Torus32 OrYNConst = modSwitchToTorus32(1, 8);
@@ -313,9 +306,7 @@ bootsORYN(LweSample *result, const LweSample *ca, const LweSample *cb, const TFh
 
     //if the phase is positive, the result is 1/8
     //if the phase is positive, else the result is -1/8
-    tfhe_bootstrap_FFT(result, bk->bkFFT, MU, temp_result);
-
-    delete_LweSample(temp_result);
+    tfhe_bootstrap_FFT_ws(result, bk->bkFFT, MU, temp_result, ws);
 }
 
 
@@ -332,10 +323,11 @@ EXPORT void bootsMUX(LweSample *result, const LweSample *a, const LweSample *b,
     const LweParams *in_out_params = bk->params->in_out_params;
     const LweParams *extracted_params = &bk->params->tgsw_params->tlwe_params->extracted_lweparams;
 
-    LweSample *temp_result = new_LweSample(in_out_params);
-    LweSample *temp_result1 = new_LweSample(extracted_params);
-    LweSample *u1 = new_LweSample(extracted_params);
-    LweSample *u2 = new_LweSample(extracted_params);
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    LweSample *temp_result = ws->gate_in;
+    LweSample *temp_result1 = ws->gate_sum;
+    LweSample *u1 = ws->gate_u1;
+    LweSample *u2 = ws->gate_u2;
 
 
     //compute "AND(a,b)": (0,-1/8) + a + b
@@ -344,7 +336,7 @@ EXPORT void bootsMUX(LweSample *result, const LweSample *a, const LweSample *b,
     lweAddTo(temp_result, a, in_out_params);
     lweAddTo(temp_result, b, in_out_params);
     // Bootstrap without KeySwitch
-    tfhe_bootstrap_woKS_FFT(u1, bk->bkFFT, MU, temp_result);
+    tfhe_bootstrap_woKS_FFT_ws(u1, bk->bkFFT, MU, temp_result, ws);
 
 
     //compute "AND(not(a),c)": (0,-1/8) - a + c
@@ -352,7 +344,7 @@ EXPORT void bootsMUX(LweSample *result, const LweSample *a, const LweSample *b,
     lweSubTo(temp_result, a, in_out_params);
     lweAddTo(temp_result, c, in_out_params);
     // Bootstrap without KeySwitch
-    tfhe_bootstrap_woKS_FFT(u2, bk->bkFFT, MU, temp_result);
+    tfhe_bootstrap_woKS_FFT_ws(u2, bk->bkFFT, MU, temp_result, ws);
 
     // Add u1=u1+u2
     static const Torus32 MuxConst = modSwitchToTorus32(1, 8);
@@ -361,13 +353,243 @@ EXPORT void bootsMUX(LweSample *result, const LweSample *a, const LweSample *b,
     lweAddTo(temp_result1, u2, extracted_params);
     // Key switching
     lweKeySwitch(result, bk->bkFFT->ks, temp_result1);
+}
+
+
+
+//*//*****************************************
+// batched gates
+//*//*****************************************
+
+/*
+ * The *_batch gates evaluate count independent gates: result[s] = gate(ca[s], cb[s]),
+ * where result, ca and cb are arrays of count samples (as allocated by
+ * new_gate_bootstrapping_ciphertext_array). The gates are cut in chunks of
+ * TFHE_BOOTSTRAP_BATCH_SIZE whose blind rotations are interleaved, and the chunks
+ * are spread over the gate thread pool (see tfhe_set_gate_batch_threads).
+ */
+struct BootsBatchArgs {
+    LweSample *result;
+    const LweSample *ca;
+    const LweSample *cb;
+    const LweSample *cc;
+    int32_t count;
+    Torus32 constant; // constant term of the linear combination
+    int32_t wa; // weight of ca
+    int32_t wb; // weight of cb
+    const TFheGateBootstrappingCloudKeySet *bk;
+};
+
+// result += w*sample, for w in {-2,-1,1,2}
+static void boots_add_weighted(LweSample *result, int32_t w, const LweSample *sample, const LweParams *params) {
+    switch (w) {
+        case 1: lweAddTo(result, sample, params); break;
+        case -1: lweSubTo(result, sample, params); break;
+        case 2: lweAddMulTo(result, 2, sample, params); break;
+        case -2: lweSubMulTo(result, 2, sample, params); break;
+        default: abort();
+    }
+}
+
+// bootstraps constant + wa*ca[s] + wb*cb[s] for the gates of one chunk
+static void boots_binary_batch_chunk(int32_t chunk, void *arg) {
+    static const Torus32 MU = modSwitchToTorus32(1, 8);
+    const BootsBatchArgs *args = (const BootsBatchArgs *) arg;
+    const TFheGateBootstrappingCloudKeySet *bk = args->bk;
+    const LweParams *in_out_params = bk->params->in_out_params;
+    const int32_t begin = chunk * TFHE_BOOTSTRAP_BATCH_SIZE;
+    const int32_t count = min(args->count - begin, TFHE_BOOTSTRAP_BATCH_SIZE);
+
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    tfhe_reserve_bootstrap_workspace_batch(ws, bk->bkFFT);
+    for (int32_t s = 0; s < count; s++) {
+        LweSample *temp_result = ws->batch_in + s;
+        lweNoiselessTrivial(temp_result, args->constant, in_out_params);
+        boots_add_weighted(temp_result, args->wa, args->ca + begin + s, in_out_params);
+        boots_add_weighted(temp_result, args->wb, args->cb + begin + s, in_out_params);
+    }
+    tfhe_bootstrap_FFT_batch_ws(args->result + begin, bk->bkFFT, MU, ws->batch_in, count, ws);
+}
+
+static void boots_binary_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                               Torus32 constant, int32_t wa, int32_t wb, const TFheGateBootstrappingCloudKeySet *bk) {
+    BootsBatchArgs args = {result, ca, cb, 0, count, constant, wa, wb, bk};
+    const int32_t nb_chunks = (count + TFHE_BOOTSTRAP_BATCH_SIZE - 1) / TFHE_BOOTSTRAP_BATCH_SIZE;
+    TfheThreadPool::global().run(nb_chunks, boots_binary_batch_chunk, &args);
+}
+
+
+/*
+ * Homomorphic bootstrapped NAND gate, on count independent pairs of samples
+ * result[s] = bootstrap((0,1/8) - ca - cb) with ca[s], cb[s]
+*/
+EXPORT void
+bootsNAND_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 NandConst = modSwitchToTorus32(1, 8);
+    boots_binary_batch(result, ca, cb, count, NandConst, -1, -1, bk);
+}
+
+
+/*
+ * Homomorphic bootstrapped OR gate, on count independent pairs of samples
+ * result[s] = bootstrap((0,1/8) + ca + cb) with ca[s], cb[s]
+*/
+EXPORT void
+bootsOR_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+              const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 OrConst = modSwitchToTorus32(1, 8);
+    boots_binary_batch(result, ca, cb, count, OrConst, 1, 1, bk);
+}
+
+
+/*
+ * Homomorphic bootstrapped AND gate, on count independent pairs of samples
+ * result[s] = bootstrap((0,-1/8) + ca + cb) with ca[s], cb[s]
+*/
+EXPORT void
+bootsAND_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+               const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 AndConst = modSwitchToTorus32(-1, 8);
+    boots_binary_batch(result, ca, cb, count, AndConst, 1, 1, bk);
+}
+
+
+/*
+ * Homomorphic bootstrapped XOR gate, on count independent pairs of samples
+ * result[s] = bootstrap((0,1/4) + 2*(ca + cb)) with ca[s], cb[s]
+*/
+EXPORT void
+bootsXOR_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+               const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 XorConst = modSwitchToTorus32(1, 4);
+    boots_binary_batch(result, ca, cb, count, XorConst, 2, 2, bk);
+}
 
 
-    delete_LweSample(u2);
-    delete_LweSample(u1);
-    delete_LweSample(temp_result1);
-    delete_LweSample(temp_result);
+/*
+ * Homomorphic bootstrapped XNOR gate, on count independent pairs of samples
+ * result[s] = bootstrap((0,-1/4) + 2*(-ca-cb)) with ca[s], cb[s]
+*/
+EXPORT void
+bootsXNOR_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 XnorConst = modSwitchToTorus32(-1, 4);
+    boots_binary_batch(result, ca, cb, count, XnorConst, -2, -2, bk);
 }
 
 
+/*
+ * Homomorphic bootstrapped NOR gate, on count independent pairs of samples
+ * result[s] = bootstrap((0,-1/8) - ca - cb) with ca[s], cb[s]
+*/
+EXPORT void
+bootsNOR_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+               const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 NorConst = modSwitchToTorus32(-1, 8);
+    boots_binary_batch(result, ca, cb, count, NorConst, -1, -1, bk);
+}
+
 
+/*
+ * Homomorphic bootstrapped AndNY Gate: not(a) and b, on count independent pairs of samples
+ * result[s] = bootstrap((0,-1/8) - ca + cb) with ca[s], cb[s]
+*/
+EXPORT void
+bootsANDNY_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                 const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 AndNYConst = modSwitchToTorus32(-1, 8);
+    boots_binary_batch(result, ca, cb, count, AndNYConst, -1, 1, bk);
+}
+
+
+/*
+ * Homomorphic bootstrapped AndYN Gate: a and not(b), on count independent pairs of samples
+ * result[s] = bootstrap((0,-1/8) + ca - cb) with ca[s], cb[s]
+*/
+EXPORT void
+bootsANDYN_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                 const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 AndYNConst = modSwitchToTorus32(-1, 8);
+    boots_binary_batch(result, ca, cb, count, AndYNConst, 1, -1, bk);
+}
+
+
+/*
+ * Homomorphic bootstrapped OrNY Gate: not(a) or b, on count independent pairs of samples
+ * result[s] = bootstrap((0,1/8) - ca + cb) with ca[s], cb[s]
+*/
+EXPORT void
+bootsORNY_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 OrNYConst = modSwitchToTorus32(1, 8);
+    boots_binary_batch(result, ca, cb, count, OrNYConst, -1, 1, bk);
+}
+
+
+/*
+ * Homomorphic bootstrapped OrYN Gate: a or not(b), on count independent pairs of samples
+ * result[s] = bootstrap((0,1/8) + ca - cb) with ca[s], cb[s]
+*/
+EXPORT void
+bootsORYN_batch(LweSample *result, const LweSample *ca, const LweSample *cb, int32_t count,
+                const TFheGateBootstrappingCloudKeySet *bk) {
+    static const Torus32 OrYNConst = modSwitchToTorus32(1, 8);
+    boots_binary_batch(result, ca, cb, count, OrYNConst, 1, -1, bk);
+}
+
+
+// bootsMUX for the gates of one chunk
+static void boots_mux_batch_chunk(int32_t chunk, void *arg) {
+    static const Torus32 MU = modSwitchToTorus32(1, 8);
+    static const Torus32 AndConst = modSwitchToTorus32(-1, 8);
+    static const Torus32 MuxConst = modSwitchToTorus32(1, 8);
+    const BootsBatchArgs *args = (const BootsBatchArgs *) arg;
+    const TFheGateBootstrappingCloudKeySet *bk = args->bk;
+    const LweParams *in_out_params = bk->params->in_out_params;
+    const LweParams *extracted_params = &bk->params->tgsw_params->tlwe_params->extracted_lweparams;
+    const int32_t begin = chunk * TFHE_BOOTSTRAP_BATCH_SIZE;
+    const int32_t count = min(args->count - begin, TFHE_BOOTSTRAP_BATCH_SIZE);
+    const LweSample *a = args->ca + begin;
+    const LweSample *b = args->cb + begin;
+    const LweSample *c = args->cc + begin;
+
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk->bkFFT);
+    tfhe_reserve_bootstrap_workspace_batch(ws, bk->bkFFT);
+
+    //compute "AND(a,b)": (0,-1/8) + a + b
+    for (int32_t s = 0; s < count; s++) {
+        lweNoiselessTrivial(ws->batch_in + s, AndConst, in_out_params);
+        lweAddTo(ws->batch_in + s, a + s, in_out_params);
+        lweAddTo(ws->batch_in + s, b + s, in_out_params);
+    }
+    tfhe_bootstrap_woKS_FFT_batch_ws(ws->batch_u, bk->bkFFT, MU, ws->batch_in, count, ws);
+
+    //compute "AND(not(a),c)": (0,-1/8) - a + c
+    for (int32_t s = 0; s < count; s++) {
+        lweNoiselessTrivial(ws->batch_in + s, AndConst, in_out_params);
+        lweSubTo(ws->batch_in + s, a + s, in_out_params);
+        lweAddTo(ws->batch_in + s, c + s, in_out_params);
+    }
+    tfhe_bootstrap_woKS_FFT_batch_ws(ws->batch_u2, bk->bkFFT, MU, ws->batch_in, count, ws);
+
+    // u1+u2, then key switching
+    LweSample *temp_result1 = ws->gate_sum;
+    for (int32_t s = 0; s < count; s++) {
+        lweNoiselessTrivial(temp_result1, MuxConst, extracted_params);
+        lweAddTo(temp_result1, ws->batch_u + s, extracted_params);
+        lweAddTo(temp_result1, ws->batch_u2 + s, extracted_params);
+        lweKeySwitch(args->result + begin + s, bk->bkFFT->ks, temp_result1);
+    }
+}
+
+/*
+ * Homomorphic bootstrapped Mux, on count independent triples of samples
+ * result[s] = a[s]?b[s]:c[s]
+*/
+EXPORT void bootsMUX_batch(LweSample *result, const LweSample *a, const LweSample *b, const LweSample *c, int32_t count,
+                           const TFheGateBootstrappingCloudKeySet *bk) {
+    BootsBatchArgs args = {result, a, b, c, count, 0, 0, 0, bk};
+    const int32_t nb_chunks = (count + TFHE_BOOTSTRAP_BATCH_SIZE - 1) / TFHE_BOOTSTRAP_BATCH_SIZE;
+    TfheThreadPool::global().run(nb_chunks, boots_mux_batch_chunk, &args);
+}
@@ -0,0 +1,293 @@
+/*
+ * Circuit bootstrapping (LWE -> TRGSW) and CMux-tree lookup tables
+ */
+
+#include <cassert>
+#include "tfhe.h"
+#include "circuitbootstrapping.h"
+
+using namespace std;
+
+
+TfheCircuitBootstrappingKey::TfheCircuitBootstrappingKey(const LweBootstrappingKeyFFT *bk, const TGswParams *cb_params,
+                                                         int32_t t, int32_t basebit, TLweSample *privks) :
+        bk(bk), cb_params(cb_params), t(t), basebit(basebit), base(1 << basebit), privks(privks) {}
+
+TfheCircuitBootstrappingKey::~TfheCircuitBootstrappingKey() {}
+
+
+// number of samples of the private keyswitch key: (k+1) x (kN+1) x t
+static int32_t privks_size(const TLweParams *params, int32_t t) {
+    return (params->k + 1) * (params->k * params->N + 1) * t;
+}
+
+/**
+ * privks[i][p][j] encodes f_i(K'_p/base^(j+1)), where K' = (K, -1) is the extracted key
+ * followed by the coefficient of b, and f_i(m) = -s_i.m (i < k), f_k(m) = m.
+ * Only the digit 1 is stored: the keyswitch multiplies it by the digit.
+ */
+EXPORT TfheCircuitBootstrappingKey *new_TfheCircuitBootstrappingKey(const LweBootstrappingKeyFFT *bk,
+                                                                    const TGswKey *tgsw_key,
+                                                                    const TGswParams *cb_params,
+                                                                    int32_t t, int32_t basebit, double alpha) {
+    const TLweParams *accum_params = bk->accum_params;
+    const TLweKey *key = &tgsw_key->tlwe_key;
+    const int32_t N = accum_params->N;
+    const int32_t k = accum_params->k;
+    const int32_t kN = k * N;
+    assert(cb_params->tlwe_params->N == N && cb_params->tlwe_params->k == k);
+    assert(basebit * t <= 32);
+
+    TLweSample *privks = new_TLweSample_array(privks_size(accum_params, t), accum_params);
+    TorusPolynomial *mu = new_TorusPolynomial(N);
+
+    TLweSample *ks = privks;
+    for (int32_t i = 0; i <= k; ++i) {
+        for (int32_t p = 0; p <= kN; ++p) {
+            const int32_t Kp = (p < kN) ? key->key[p / N].coefs[p % N] : -1;
+            for (int32_t j = 0; j < t; ++j) {
+                const Torus32 x = Kp * (1 << (32 - (j + 1) * basebit));
+                if (i < k) {
+                    const int32_t *si = key->key[i].coefs;
+                    for (int32_t c = 0; c < N; ++c) mu->coefsT[c] = -si[c] * x;
+                } else {
+                    torusPolynomialClear(mu);
+                    mu->coefsT[0] = x;
+                }
+                tLweSymEncrypt(ks++, mu, alpha, key);
+            }
+        }
+    }
+
+    delete_TorusPolynomial(mu);
+    return new TfheCircuitBootstrappingKey(bk, cb_params, t, basebit, privks);
+}
+
+EXPORT void delete_TfheCircuitBootstrappingKey(TfheCircuitBootstrappingKey *obj) {
+    delete_TLweSample_array(privks_size(obj->bk->accum_params, obj->t), obj->privks);
+    delete obj;
+}
+
+
+// digits[p*t+j] = j-th digit (base 2^basebit) of the rounding of (a_0..a_{kN-1}, b)[p]
+static void privks_decompose(int32_t *digits, const LweSample *x, int32_t kN, int32_t t, int32_t basebit) {
+    const uint32_t prec_offset = 1u << (32 - (1 + basebit * t)); //precision
+    const uint32_t mask = (1u << basebit) - 1;
+
+    for (int32_t p = 0; p <= kN; ++p) {
+        const uint32_t abar = uint32_t((p < kN) ? x->a[p] : x->b) + prec_offset;
+        for (int32_t j = 0; j < t; ++j)
+            digits[p * t + j] = (abar >> (32 - (j + 1) * basebit)) & mask;
+    }
+}
+
+// result = f_i(phase) from the decomposition of the input sample
+static void privks_apply(TLweSample *result, const TfheCircuitBootstrappingKey *cbk, int32_t i,
+                         const int32_t *digits) {
+    const TLweParams *accum_params = cbk->bk->accum_params;
+    const int32_t kN = accum_params->k * accum_params->N;
+    const int32_t t = cbk->t;
+    const TLweSample *ks = cbk->privks + i * (kN + 1) * t;
+
+    tLweClear(result, accum_params);
+    for (int32_t pj = 0; pj < (kN + 1) * t; ++pj) {
+        if (digits[pj] != 0) tLweSubMulTo(result, digits[pj], ks + pj, accum_params);
+    }
+}
+
+EXPORT void tfhe_privateKeySwitch(TLweSample *result, const TfheCircuitBootstrappingKey *cbk, int32_t i,
+                                  const LweSample *x) {
+    const TLweParams *accum_params = cbk->bk->accum_params;
+    const int32_t kN = accum_params->k * accum_params->N;
+    int32_t *digits = new int32_t[(kN + 1) * cbk->t];
+
+    privks_decompose(digits, x, kN, cbk->t, cbk->basebit);
+    privks_apply(result, cbk, i, digits);
+
+    delete[] digits;
+}
+
+
+/**
+ * result row (i,j) is a TRLWE of m.h_j on the i-th component:
+ * bootstrap x to +-h_j/2, shift to {0, h_j}, then keyswitch it through f_i for every i
+ */
+EXPORT void tfhe_circuitBootstrap_FFT(TGswSampleFFT *result, const TfheCircuitBootstrappingKey *cbk,
+                                      const LweSample *x) {
+    const LweBootstrappingKeyFFT *bk = cbk->bk;
+    const TGswParams *cb_params = cbk->cb_params;
+    const TLweParams *accum_params = bk->accum_params;
+    const int32_t k = accum_params->k;
+    const int32_t kN = k * accum_params->N;
+    const int32_t l = cb_params->l;
+    const int32_t t = cbk->t;
+
+    TfheBootstrapWorkspace *ws = tfhe_local_bootstrap_workspace(bk);
+    LweSample *u = new_LweSample(bk->extract_params);
+    TLweSample *row = new_TLweSample(accum_params);
+    int32_t *digits = new int32_t[(kN + 1) * t];
+
+    for (int32_t j = 0; j < l; ++j) {
+        const Torus32 mu = cb_params->h[j] / 2;
+        tfhe_bootstrap_woKS_FFT_ws(u, bk, mu, x, ws);
+        u->b += mu;
+
+        // the decomposition of u is shared by the k+1 keyswitches
+        privks_decompose(digits, u, kN, t, cbk->basebit);
+        for (int32_t i = 0; i <= k; ++i) {
+            privks_apply(row, cbk, i, digits);
+            tLweToFFTConvert(result->all_samples + i * l + j, row, accum_params);
+        }
+    }
+
+    delete[] digits;
+    delete_TLweSample(row);
+    delete_LweSample(u);
+}
+
+
+// buffers of the external product for one TRGSW parameter set
+struct ExternMulBuffers {
+    const int32_t kpl;
+    IntPolynomial *deca;
+    LagrangeHalfCPolynomial *decaFFT;
+    TLweSampleFFT *tmpa;
+
+    ExternMulBuffers(const TGswParams *params) :
+            kpl(params->kpl),
+            deca(new_IntPolynomial_array(kpl, params->tlwe_params->N)),
+            decaFFT(new_LagrangeHalfCPolynomial_array(kpl, params->tlwe_params->N)),
+            tmpa(new_TLweSampleFFT(params->tlwe_params)) {}
+
+    ~ExternMulBuffers() {
+        delete_TLweSampleFFT(tmpa);
+        delete_LagrangeHalfCPolynomial_array(kpl, decaFFT);
+        delete_IntPolynomial_array(kpl, deca);
+    }
+
+    ExternMulBuffers(const ExternMulBuffers &) = delete;
+    void operator=(const ExternMulBuffers &) = delete;
+};
+
+// c1 = c0 + sel.(c1 - c0)
+static void cmux_to(TLweSample *c1, const TGswSampleFFT *sel, const TLweSample *c0, const TGswParams *params,
+                    ExternMulBuffers &buf) {
+    tLweSubTo(c1, c0, params->tlwe_params);
+    tGswFFTExternMulToTLwe_buffers(c1, sel, params, buf.deca, buf.decaFFT, buf.tmpa);
+    tLweAddTo(c1, c0, params->tlwe_params);
+}
+
+EXPORT void tfhe_CMux_FFT(TLweSample *result, const TGswSampleFFT *sel, const TLweSample *c0, const TLweSample *c1,
+                          const TGswParams *params) {
+    assert(result != c0);
+    ExternMulBuffers buf(params);
+    if (result != c1) tLweCopy(result, c1, params->tlwe_params);
+    cmux_to(result, sel, c0, params, buf);
+}
+
+// reduces the 2^nb_sel leaves of tree to tree[0], selecting with sel[0] (LSB) first
+static void cmux_tree(TLweSample *tree, const TGswSampleFFT *sel, int32_t nb_sel, const TGswParams *params,
+                      ExternMulBuffers &buf) {
+    for (int32_t b = 0; b < nb_sel; ++b) {
+        const int32_t half = 1 << (nb_sel - b - 1);
+        for (int32_t m = 0; m < half; ++m) {
+            cmux_to(tree + 2 * m + 1, sel + b, tree + 2 * m, params, buf);
+            tLweCopy(tree + m, tree + 2 * m + 1, params->tlwe_params);
+        }
+    }
+}
+
+// extract coefficient index of acc and keyswitch it back to the in_out key
+static void lut_extract(LweSample *result, const TLweSample *acc, int32_t index, LweSample *u,
+                        const LweBootstrappingKeyFFT *bk) {
+    tLweExtractLweSampleIndex(u, acc, index, bk->extract_params, bk->accum_params);
+    lweKeySwitch(result, bk->ks, u);
+}
+
+EXPORT void tfhe_lutVertical_FFT(LweSample *result, const int32_t *table, int32_t nb_outputs,
+                                 const TGswSampleFFT *inputs, int32_t nb_inputs,
+                                 const TfheCircuitBootstrappingKey *cbk) {
+    const LweBootstrappingKeyFFT *bk = cbk->bk;
+    const TGswParams *cb_params = cbk->cb_params;
+    const TLweParams *accum_params = bk->accum_params;
+    const int32_t N = accum_params->N;
+    const Torus32 mu = modSwitchToTorus32(1, 8);
+
+    // the L low bits select a coefficient, the remaining ones a polynomial
+    int32_t L = 0;
+    while (L < nb_inputs && (2 << L) <= N) ++L;
+    const int32_t width = 1 << L;
+    const int32_t group = N / width; // outputs packed in one polynomial
+    const int32_t nb_high = nb_inputs - L;
+    const int32_t nb_polys = 1 << nb_high;
+
+    ExternMulBuffers buf(cb_params);
+    TLweSample *tree = new_TLweSample_array(nb_polys, accum_params);
+    TLweSample *rot = new_TLweSample(accum_params);
+    TorusPolynomial *poly = new_TorusPolynomial(N);
+    LweSample *u = new_LweSample(bk->extract_params);
+
+    for (int32_t o0 = 0; o0 < nb_outputs; o0 += group) {
+        const int32_t nb_group = (nb_outputs - o0 < group) ? nb_outputs - o0 : group;
+
+        for (int32_t q = 0; q < nb_polys; ++q) {
+            torusPolynomialClear(poly);
+            for (int32_t g = 0; g < nb_group; ++g) {
+                for (int32_t xl = 0; xl < width; ++xl) {
+                    const int32_t x = q * width + xl;
+                    poly->coefsT[g * width + xl] = table[x * nb_outputs + o0 + g] ? mu : -mu;
+                }
+            }
+            tLweNoiselessTrivial(tree + q, poly, accum_params);
+        }
+        cmux_tree(tree, inputs + L, nb_high, cb_params, buf);
+
+        // acc = X^(-x_low).acc, one controlled rotation per low bit
+        TLweSample *acc = tree;
+        for (int32_t i = 0; i < L; ++i) {
+            tLweMulByXaiMinusOne(rot, 2 * N - (1 << i), acc, accum_params);
+            tGswFFTExternMulToTLwe_buffers(rot, inputs + i, cb_params, buf.deca, buf.decaFFT, buf.tmpa);
+            tLweAddTo(acc, rot, accum_params);
+        }
+
+        for (int32_t g = 0; g < nb_group; ++g)
+            lut_extract(result + o0 + g, acc, g * width, u, bk);
+    }
+
+    delete_LweSample(u);
+    delete_TorusPolynomial(poly);
+    delete_TLweSample(rot);
+    delete_TLweSample_array(nb_polys, tree);
+}
+
+EXPORT void tfhe_lutHorizontal_FFT(LweSample *result, const int32_t *table, int32_t nb_outputs,
+                                   const TGswSampleFFT *inputs, int32_t nb_inputs,
+                                   const TfheCircuitBootstrappingKey *cbk) {
+    const LweBootstrappingKeyFFT *bk = cbk->bk;
+    const TGswParams *cb_params = cbk->cb_params;
+    const TLweParams *accum_params = bk->accum_params;
+    const int32_t N = accum_params->N;
+    const Torus32 mu = modSwitchToTorus32(1, 8);
+    const int32_t nb_polys = 1 << nb_inputs;
+    assert(nb_outputs <= N);
+
+    ExternMulBuffers buf(cb_params);
+    TLweSample *tree = new_TLweSample_array(nb_polys, accum_params);
+    TorusPolynomial *poly = new_TorusPolynomial(N);
+    LweSample *u = new_LweSample(bk->extract_params);
+
+    for (int32_t x = 0; x < nb_polys; ++x) {
+        torusPolynomialClear(poly);
+        for (int32_t o = 0; o < nb_outputs; ++o)
+            poly->coefsT[o] = table[x * nb_outputs + o] ? mu : -mu;
+        tLweNoiselessTrivial(tree + x, poly, accum_params);
+    }
+    cmux_tree(tree, inputs, nb_inputs, cb_params, buf);
+
+    for (int32_t o = 0; o < nb_outputs; ++o)
+        lut_extract(result + o, tree, o, u, bk);
+
+    delete_LweSample(u);
+    delete_TorusPolynomial(poly);
+    delete_TLweSample_array(nb_polys, tree);
+}
@@ -15,6 +15,23 @@ FFT_Processor_nayuki::FFT_Processor_nayuki(const int32_t N): _2N(2*N),N(N),Ns2(N
 	omegaxminus1[x]=cos(x*M_PI/N)-1. + sin(x*M_PI/N) * 1i; 
 	//exp(i.x.pi/N)-1
     }
+    auto_tables = new int32_t*[N]();
+}
+
+/**
+ * the value i is P(omega^(2i+1)), so P(X^e) takes there the value of P at omega^(e.(2i+1)):
+ * one of the stored values, or the conjugate of one (P has real coefficients)
+ */
+const int32_t* FFT_Processor_nayuki::automorphism_table(int32_t e) {
+    assert((e & 1) == 1 && e > 0 && e < _2N);
+    int32_t*& table = auto_tables[e >> 1];
+    if (table) return table;
+    table = new int32_t[Ns2];
+    for (int32_t i=0; i<Ns2; i++) {
+	const int32_t y = int32_t((int64_t(e) * (2*i+1)) % _2N);
+	table[i] = y < N ? (y >> 1) : ~((_2N - y) >> 1);
+    }
+    return table;
 }
 
 void FFT_Processor_nayuki::check_alternate_real() {
@@ -91,6 +108,8 @@ FFT_Processor_nayuki::~FFT_Processor_nayuki() {
     free(real_inout); 
     free(imag_inout);
     free(omegaxminus1);    
+    for (int32_t i=0; i<N; i++) delete[] auto_tables[i];
+    delete[] auto_tables;
 }
 
 thread_local FFT_Processor_nayuki fp1024_nayuki(1024);
@@ -110,3 +129,33 @@ EXPORT void TorusPolynomial_fft(TorusPolynomial* result, const LagrangeHalfCPoly
     LagrangeHalfCPolynomial_IMPL* r = (LagrangeHalfCPolynomial_IMPL*) p;
     fp1024_nayuki.execute_direct_torus32(result->coefsT, r->coefsC);
 }
+
+/**
+ * batched FFT functions (one polynomial at a time)
+ */
+EXPORT void IntPolynomial_ifft_batch(LagrangeHalfCPolynomial* result, const IntPolynomial* p, const int32_t count) {
+    for (int32_t i = 0; i < count; i++) IntPolynomial_ifft(result + i, p + i);
+}
+EXPORT void TorusPolynomial_ifft_batch(LagrangeHalfCPolynomial* result, const TorusPolynomial* p, const int32_t count) {
+    for (int32_t i = 0; i < count; i++) TorusPolynomial_ifft(result + i, p + i);
+}
+EXPORT void TorusPolynomial_fft_batch(TorusPolynomial* result, const LagrangeHalfCPolynomial* p, const int32_t count) {
+    for (int32_t i = 0; i < count; i++) TorusPolynomial_fft(result + i, p + i);
+}
+
+/**
+ * decomposition then FFT, one digit at a time (the digit only goes through a small buffer)
+ */
+EXPORT void TorusPolynomial_decomp_ifft(LagrangeHalfCPolynomial* result, const TorusPolynomial* p, const int32_t l,
+                                        const int32_t Bgbit, const uint32_t maskMod, const int32_t halfBg,
+                                        const uint32_t offset) {
+    static thread_local IntPolynomial digit(1024);
+    const int32_t N = p->N;
+    const uint32_t* aa = (const uint32_t*) p->coefsT;
+    assert(N == digit.N);
+    for (int32_t q=0; q<l; q++) {
+        const int32_t decal = 32 - (q + 1) * Bgbit;
+        for (int32_t i=0; i<N; i++) digit.coefs[i] = int32_t(((aa[i] + offset) >> decal) & maskMod) - halfBg;
+        IntPolynomial_ifft(result + q, &digit);
+    }
+}
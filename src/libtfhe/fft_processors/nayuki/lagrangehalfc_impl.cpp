@@ -84,6 +84,20 @@ EXPORT void LagrangeHalfCPolynomialSetXaiMinusOne(LagrangeHalfCPolynomial* resul
 	result1->coefsC[i]=omegaxminus1[((2*i+1)*ai)%_2N];
 }
 
+/** result(X) = a(X^e), e odd: a permutation of the values, some of them conjugated */
+EXPORT void LagrangeHalfCPolynomialAutomorphism(LagrangeHalfCPolynomial* result, const LagrangeHalfCPolynomial* a, const int32_t e) {
+    LagrangeHalfCPolynomial_IMPL* result1 = (LagrangeHalfCPolynomial_IMPL*) result;
+    const int32_t Ns2 = result1->proc->Ns2;
+    const int32_t* table = result1->proc->automorphism_table(e);
+    const cplx* aa = ((const LagrangeHalfCPolynomial_IMPL*) a)->coefsC;
+    cplx* rr = result1->coefsC;
+    assert(rr != aa);
+    for (int32_t i=0; i<Ns2; i++) {
+	const int32_t j = table[i];
+	rr[i] = j >= 0 ? aa[j] : conj(aa[~j]);
+    }
+}
+
 /** termwise multiplication in Lagrange space */
 EXPORT void LagrangeHalfCPolynomialMul(
 	LagrangeHalfCPolynomial* result, 
@@ -19,6 +19,7 @@ class FFT_Processor_nayuki {
     double* imag_inout;
     void* tables_direct;
     void* tables_reverse;
+    int32_t** auto_tables; //one automorphism table per odd e, built on first use
     public:
     cplx* omegaxminus1;
 
@@ -28,6 +29,9 @@ class FFT_Processor_nayuki {
     void execute_reverse_int(cplx* res, const int32_t* a);
     void execute_reverse_torus32(cplx* res, const Torus32* a);
     void execute_direct_torus32(Torus32* res, const cplx* a);
+    // Lagrange automorphism X -> X^e (e odd): the value i of the result is the value table[i]
+    // of the input, or the conjugate of the value ~table[i] when table[i] < 0
+    const int32_t* automorphism_table(int32_t e);
     ~FFT_Processor_nayuki();
 };
 
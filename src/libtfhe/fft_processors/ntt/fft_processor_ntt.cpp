@@ -0,0 +1,278 @@
+#include <polynomials.h>
+#include "lagrangehalfc_impl.h"
+#include <cassert>
+
+using namespace std;
+
+const uint64_t FFT_Processor_NTT::P = UINT64_C(0x3FFFFFFFFFE80001);
+
+namespace {
+    // slow modular arithmetic, only used to build the tables
+    uint64_t mulmod(uint64_t a, uint64_t b, uint64_t p) {
+        return uint64_t(((unsigned __int128) a * b) % p);
+    }
+
+    uint64_t powmod(uint64_t a, uint64_t e, uint64_t p) {
+        uint64_t reps = 1;
+        for (; e; e >>= 1) {
+            if (e & 1) reps = mulmod(reps, a, p);
+            a = mulmod(a, a, p);
+        }
+        return reps;
+    }
+
+    uint64_t shoup(uint64_t w, uint64_t p) {
+        return uint64_t(((unsigned __int128) w << 64) / p);
+    }
+
+    //reverse the log2(n) bits of i
+    int32_t bitrev(int32_t i, int32_t n) {
+        int32_t reps = 0;
+        for (int32_t j = 1; j < n; j *= 2) {
+            reps = 2 * reps + (i % 2);
+            i /= 2;
+        }
+        return reps;
+    }
+
+    //w.y mod p in [0,2p), for any y < 2^64 (Shoup)
+    inline uint64_t mul_shoup_lazy(uint64_t y, uint64_t w, uint64_t w_shoup, uint64_t p) {
+        const uint64_t q = uint64_t(((unsigned __int128) y * w_shoup) >> 64);
+        return y * w - q * p;
+    }
+}
+
+FFT_Processor_NTT::FFT_Processor_NTT(const int32_t N) : _2N(2 * N), N(N), Ns2(N / 2) {
+    assert((P - 1) % uint64_t(_2N) == 0);
+    buf = new uint64_t[2 * N];
+    psi_rev = new uint64_t[4 * N];
+    psi_rev_shoup = psi_rev + N;
+    ipsi_rev = psi_rev + 2 * N;
+    ipsi_rev_shoup = psi_rev + 3 * N;
+    xpow = new uint64_t[_2N];
+    slot_exp = new int32_t[N];
+
+    //g is a quadratic non residue, so psi=g^((p-1)/2N) has order exactly 2N
+    uint64_t g = 2;
+    while (powmod(g, (P - 1) / 2, P) != P - 1) g++;
+    const uint64_t psi = powmod(g, (P - 1) / _2N, P);
+    const uint64_t ipsi = powmod(psi, P - 2, P);
+    for (int32_t i = 0; i < N; i++) {
+        const int32_t ri = bitrev(i, N);
+        psi_rev[i] = powmod(psi, ri, P);
+        psi_rev_shoup[i] = shoup(psi_rev[i], P);
+        ipsi_rev[i] = powmod(ipsi, ri, P);
+        ipsi_rev_shoup[i] = shoup(ipsi_rev[i], P);
+        slot_exp[i] = 2 * ri + 1;
+    }
+
+    //Montgomery constants
+    p_inv = 1;
+    for (int32_t i = 0; i < 6; i++) p_inv *= 2 - P * p_inv; //Newton iteration mod 2^64
+    mont_r = uint64_t((((unsigned __int128) 1) << 64) % P);
+    mont_r_shoup = shoup(mont_r, P);
+    inv_scale = mulmod(powmod(N, P - 2, P), powmod(mont_r, P - 2, P), P);
+    inv_scale_shoup = shoup(inv_scale, P);
+    for (int32_t j = 0; j < _2N; j++) xpow[j] = mulmod(powmod(psi, j, P), mont_r, P);
+    auto_tables = new int32_t *[N]();
+}
+
+//the value i is P(psi^slot_exp[i]), and the N slots cover all the odd exponents
+const int32_t *FFT_Processor_NTT::automorphism_table(int32_t e) {
+    assert((e & 1) == 1 && e > 0 && e < _2N);
+    int32_t *&table = auto_tables[e >> 1];
+    if (table) return table;
+    int32_t *slot = new int32_t[_2N];
+    for (int32_t j = 0; j < N; j++) slot[slot_exp[j]] = j;
+    table = new int32_t[N];
+    for (int32_t i = 0; i < N; i++) table[i] = slot[(int64_t(e) * slot_exp[i]) % _2N];
+    delete[] slot;
+    return table;
+}
+
+//Cooley-Tukey, natural order to bit-reversed order, input in [0,4p), output in [0,p)
+template<int32_t M>
+void FFT_Processor_NTT::forward(uint64_t *const *a) {
+    const uint64_t _2P = 2 * P;
+    int32_t t = N;
+    for (int32_t m = 1; m < N; m *= 2) {
+        t /= 2;
+        for (int32_t i = 0; i < m; i++) {
+            const uint64_t w = psi_rev[m + i];
+            const uint64_t w_shoup = psi_rev_shoup[m + i];
+            for (int32_t j = 2 * i * t; j < (2 * i + 1) * t; j++) {
+                for (int32_t k = 0; k < M; k++) {
+                    uint64_t *x = a[k] + j;
+                    uint64_t *y = x + t;
+                    uint64_t u = *x;
+                    u = (u >= _2P) ? u - _2P : u;
+                    const uint64_t v = mul_shoup_lazy(*y, w, w_shoup, P);
+                    *x = u + v;
+                    *y = u - v + _2P;
+                }
+            }
+        }
+    }
+    for (int32_t k = 0; k < M; k++) {
+        for (int32_t i = 0; i < N; i++) {
+            uint64_t u = a[k][i];
+            u = (u >= _2P) ? u - _2P : u;
+            a[k][i] = (u >= P) ? u - P : u;
+        }
+    }
+}
+
+//Gentleman-Sande, bit-reversed order to natural order, input in [0,2p), output in [0,2p)
+//(without the division by N)
+template<int32_t M>
+void FFT_Processor_NTT::inverse(uint64_t *const *a) {
+    const uint64_t _2P = 2 * P;
+    int32_t t = 1;
+    for (int32_t m = N; m > 1; m /= 2) {
+        const int32_t h = m / 2;
+        for (int32_t i = 0; i < h; i++) {
+            const uint64_t w = ipsi_rev[h + i];
+            const uint64_t w_shoup = ipsi_rev_shoup[h + i];
+            for (int32_t j = 2 * i * t; j < (2 * i + 1) * t; j++) {
+                for (int32_t k = 0; k < M; k++) {
+                    uint64_t *x = a[k] + j;
+                    uint64_t *y = x + t;
+                    const uint64_t u = *x;
+                    const uint64_t v = *y;
+                    const uint64_t s = u + v;
+                    *x = (s >= _2P) ? s - _2P : s;
+                    *y = mul_shoup_lazy(u - v + _2P, w, w_shoup, P);
+                }
+            }
+        }
+        t *= 2;
+    }
+}
+
+//scales the output of the inverse transform by 1/N, and lifts it to the torus
+void FFT_Processor_NTT::direct_output(Torus32 *res, const uint64_t *a) {
+    static const uint64_t Ps2 = P / 2;
+    for (int32_t i = 0; i < N; i++) {
+        uint64_t x = mul_shoup_lazy(a[i], inv_scale, inv_scale_shoup, P);
+        x = (x >= P) ? x - P : x;
+        //centered lift, then mod 2^32
+        res[i] = Torus32(uint32_t((x > Ps2) ? x - P : x));
+    }
+}
+
+void FFT_Processor_NTT::execute_reverse_int(uint64_t *res, const int32_t *a) {
+    for (int32_t i = 0; i < N; i++) res[i] = to_mont(a[i]);
+    forward<1>(&res);
+}
+
+void FFT_Processor_NTT::execute_reverse_torus32(uint64_t *res, const Torus32 *a) {
+    //the torus is lifted to [-2^31,2^31), we do not rescale
+    execute_reverse_int(res, (const int32_t *) a);
+}
+
+void FFT_Processor_NTT::execute_direct_torus32(Torus32 *res, const uint64_t *a) {
+    for (int32_t i = 0; i < N; i++) buf[i] = a[i];
+    inverse<1>(&buf);
+    direct_output(res, buf);
+}
+
+void FFT_Processor_NTT::execute_reverse_int2(uint64_t *res0, uint64_t *res1, const int32_t *a0, const int32_t *a1) {
+    uint64_t *const res[2] = {res0, res1};
+    for (int32_t i = 0; i < N; i++) {
+        res0[i] = to_mont(a0[i]);
+        res1[i] = to_mont(a1[i]);
+    }
+    forward<2>(res);
+}
+
+void FFT_Processor_NTT::execute_direct_torus32_2(Torus32 *res0, Torus32 *res1, const uint64_t *a0, const uint64_t *a1) {
+    uint64_t *const b[2] = {buf, buf + N};
+    for (int32_t i = 0; i < N; i++) {
+        b[0][i] = a0[i];
+        b[1][i] = a1[i];
+    }
+    inverse<2>(b);
+    direct_output(res0, b[0]);
+    direct_output(res1, b[1]);
+}
+
+void FFT_Processor_NTT::execute_reverse_digit(uint64_t *res, const Torus32 *a, const int32_t decal,
+                                              const uint32_t maskMod, const int32_t halfBg, const uint32_t offset) {
+    const uint32_t *aa = (const uint32_t *) a;
+    for (int32_t i = 0; i < N; i++) res[i] = to_mont(int32_t(((aa[i] + offset) >> decal) & maskMod) - halfBg);
+    forward<1>(&res);
+}
+
+void FFT_Processor_NTT::execute_reverse_digit2(uint64_t *res0, uint64_t *res1, const Torus32 *a, const int32_t decal,
+                                               const int32_t Bgbit, const uint32_t maskMod, const int32_t halfBg,
+                                               const uint32_t offset) {
+    uint64_t *const res[2] = {res0, res1};
+    const uint32_t *aa = (const uint32_t *) a;
+    for (int32_t i = 0; i < N; i++) {
+        const uint32_t x = aa[i] + offset;
+        res0[i] = to_mont(int32_t((x >> decal) & maskMod) - halfBg);
+        res1[i] = to_mont(int32_t((x >> (decal - Bgbit)) & maskMod) - halfBg);
+    }
+    forward<2>(res);
+}
+
+FFT_Processor_NTT::~FFT_Processor_NTT() {
+    for (int32_t i = 0; i < N; i++) delete[] auto_tables[i];
+    delete[] auto_tables;
+    delete[] slot_exp;
+    delete[] xpow;
+    delete[] psi_rev;
+    delete[] buf;
+}
+
+thread_local FFT_Processor_NTT ntt1024(1024);
+
+/**
+ * FFT functions
+ */
+EXPORT void IntPolynomial_ifft(LagrangeHalfCPolynomial *result, const IntPolynomial *p) {
+    ntt1024.execute_reverse_int(((LagrangeHalfCPolynomial_IMPL *) result)->values, p->coefs);
+}
+EXPORT void TorusPolynomial_ifft(LagrangeHalfCPolynomial *result, const TorusPolynomial *p) {
+    ntt1024.execute_reverse_torus32(((LagrangeHalfCPolynomial_IMPL *) result)->values, p->coefsT);
+}
+EXPORT void TorusPolynomial_fft(TorusPolynomial *result, const LagrangeHalfCPolynomial *p) {
+    ntt1024.execute_direct_torus32(result->coefsT, ((LagrangeHalfCPolynomial_IMPL *) p)->values);
+}
+
+/**
+ * batched FFT functions: the polynomials are transformed two by two
+ */
+EXPORT void IntPolynomial_ifft_batch(LagrangeHalfCPolynomial *result, const IntPolynomial *p, const int32_t count) {
+    LagrangeHalfCPolynomial_IMPL *r = (LagrangeHalfCPolynomial_IMPL *) result;
+    int32_t i = 0;
+    for (; i + 1 < count; i += 2)
+        ntt1024.execute_reverse_int2(r[i].values, r[i + 1].values, p[i].coefs, p[i + 1].coefs);
+    if (i < count) ntt1024.execute_reverse_int(r[i].values, p[i].coefs);
+}
+EXPORT void TorusPolynomial_ifft_batch(LagrangeHalfCPolynomial *result, const TorusPolynomial *p, const int32_t count) {
+    LagrangeHalfCPolynomial_IMPL *r = (LagrangeHalfCPolynomial_IMPL *) result;
+    int32_t i = 0;
+    for (; i + 1 < count; i += 2)
+        ntt1024.execute_reverse_int2(r[i].values, r[i + 1].values,
+                                     (const int32_t *) p[i].coefsT, (const int32_t *) p[i + 1].coefsT);
+    if (i < count) ntt1024.execute_reverse_torus32(r[i].values, p[i].coefsT);
+}
+EXPORT void TorusPolynomial_fft_batch(TorusPolynomial *result, const LagrangeHalfCPolynomial *p, const int32_t count) {
+    const LagrangeHalfCPolynomial_IMPL *pp = (const LagrangeHalfCPolynomial_IMPL *) p;
+    int32_t i = 0;
+    for (; i + 1 < count; i += 2)
+        ntt1024.execute_direct_torus32_2(result[i].coefsT, result[i + 1].coefsT, pp[i].values, pp[i + 1].values);
+    if (i < count) ntt1024.execute_direct_torus32(result[i].coefsT, pp[i].values);
+}
+
+EXPORT void TorusPolynomial_decomp_ifft(LagrangeHalfCPolynomial *result, const TorusPolynomial *p, const int32_t l,
+                                        const int32_t Bgbit, const uint32_t maskMod, const int32_t halfBg,
+                                        const uint32_t offset) {
+    LagrangeHalfCPolynomial_IMPL *r = (LagrangeHalfCPolynomial_IMPL *) result;
+    int32_t q = 0;
+    for (; q + 1 < l; q += 2)
+        ntt1024.execute_reverse_digit2(r[q].values, r[q + 1].values, p->coefsT, 32 - (q + 1) * Bgbit, Bgbit,
+                                       maskMod, halfBg, offset);
+    if (q < l) ntt1024.execute_reverse_digit(r[q].values, p->coefsT, 32 - (q + 1) * Bgbit, maskMod, halfBg, offset);
+}
@@ -0,0 +1,171 @@
+#include <polynomials.h>
+#include "lagrangehalfc_impl.h"
+
+using namespace std;
+
+
+LagrangeHalfCPolynomial_IMPL::LagrangeHalfCPolynomial_IMPL(const int32_t N) {
+    assert(N == 1024);
+    values = new uint64_t[N];
+    proc = &ntt1024;
+}
+
+LagrangeHalfCPolynomial_IMPL::~LagrangeHalfCPolynomial_IMPL() {
+    delete[] values;
+}
+
+//initialize the key structure
+//(equivalent of the C++ constructor)
+EXPORT void init_LagrangeHalfCPolynomial(LagrangeHalfCPolynomial *obj, const int32_t N) {
+    new(obj) LagrangeHalfCPolynomial_IMPL(N);
+}
+EXPORT void init_LagrangeHalfCPolynomial_array(int32_t nbelts, LagrangeHalfCPolynomial *obj, const int32_t N) {
+    for (int32_t i = 0; i < nbelts; i++) {
+        new(obj + i) LagrangeHalfCPolynomial_IMPL(N);
+    }
+}
+
+//destroys the LagrangeHalfCPolynomial structure
+//(equivalent of the C++ destructor)
+EXPORT void destroy_LagrangeHalfCPolynomial(LagrangeHalfCPolynomial *obj) {
+    LagrangeHalfCPolynomial_IMPL *objbis = (LagrangeHalfCPolynomial_IMPL *) obj;
+    objbis->~LagrangeHalfCPolynomial_IMPL();
+}
+EXPORT void destroy_LagrangeHalfCPolynomial_array(int32_t nbelts, LagrangeHalfCPolynomial *obj) {
+    LagrangeHalfCPolynomial_IMPL *objbis = (LagrangeHalfCPolynomial_IMPL *) obj;
+    for (int32_t i = 0; i < nbelts; i++) {
+        (objbis + i)->~LagrangeHalfCPolynomial_IMPL();
+    }
+}
+
+
+//MISC OPERATIONS
+/** sets to zero */
+EXPORT void LagrangeHalfCPolynomialClear(LagrangeHalfCPolynomial *reps) {
+    LagrangeHalfCPolynomial_IMPL *reps1 = (LagrangeHalfCPolynomial_IMPL *) reps;
+    const int32_t N = reps1->proc->N;
+    for (int32_t i = 0; i < N; i++) reps1->values[i] = 0;
+}
+
+// used in MK
+EXPORT void LagrangeHalfCPolynomialCopy(LagrangeHalfCPolynomial *reps, LagrangeHalfCPolynomial *sample) {
+    LagrangeHalfCPolynomial_IMPL *reps1 = (LagrangeHalfCPolynomial_IMPL *) reps;
+    LagrangeHalfCPolynomial_IMPL *sample1 = (LagrangeHalfCPolynomial_IMPL *) sample;
+    const int32_t N = reps1->proc->N;
+    for (int32_t i = 0; i < N; i++) reps1->values[i] = sample1->values[i];
+}
+
+//a constant polynomial has the same value everywhere
+EXPORT void LagrangeHalfCPolynomialSetTorusConstant(LagrangeHalfCPolynomial *result, const Torus32 mu) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
+    const int32_t N = result1->proc->N;
+    const uint64_t muc = result1->proc->to_mont(mu); //we do not rescale
+    for (int32_t j = 0; j < N; j++) result1->values[j] = muc;
+}
+
+EXPORT void LagrangeHalfCPolynomialAddTorusConstant(LagrangeHalfCPolynomial *result, const Torus32 mu) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
+    const int32_t N = result1->proc->N;
+    const uint64_t muc = result1->proc->to_mont(mu);
+    uint64_t *b = result1->values;
+    for (int32_t j = 0; j < N; j++) b[j] = FFT_Processor_NTT::add_mod(b[j], muc);
+}
+
+EXPORT void LagrangeHalfCPolynomialSetXaiMinusOne(LagrangeHalfCPolynomial *result, const int32_t ai) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
+    const FFT_Processor_NTT *proc = result1->proc;
+    const int32_t N = proc->N;
+    const int32_t _2N = proc->_2N;
+    const int32_t aa = ((ai % _2N) + _2N) % _2N;
+    const uint64_t one = proc->xpow[0];
+    for (int32_t i = 0; i < N; i++)
+        result1->values[i] = FFT_Processor_NTT::sub_mod(proc->xpow[(proc->slot_exp[i] * aa) % _2N], one);
+}
+
+/** result(X) = a(X^e), e odd: a permutation of the values */
+EXPORT void LagrangeHalfCPolynomialAutomorphism(LagrangeHalfCPolynomial *result, const LagrangeHalfCPolynomial *a,
+                                                const int32_t e) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
+    const int32_t N = result1->proc->N;
+    const int32_t *table = result1->proc->automorphism_table(e);
+    const uint64_t *aa = ((const LagrangeHalfCPolynomial_IMPL *) a)->values;
+    uint64_t *rr = result1->values;
+    assert(rr != aa);
+    for (int32_t i = 0; i < N; i++) rr[i] = aa[table[i]];
+}
+
+/** termwise multiplication in Lagrange space */
+EXPORT void LagrangeHalfCPolynomialMul(
+        LagrangeHalfCPolynomial *result,
+        const LagrangeHalfCPolynomial *a,
+        const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
+    const FFT_Processor_NTT *proc = result1->proc;
+    const int32_t N = proc->N;
+    const uint64_t *aa = ((const LagrangeHalfCPolynomial_IMPL *) a)->values;
+    const uint64_t *bb = ((const LagrangeHalfCPolynomial_IMPL *) b)->values;
+    uint64_t *rr = result1->values;
+    for (int32_t i = 0; i < N; i++)
+        rr[i] = proc->mont_mul(aa[i], bb[i]);
+}
+
+/** termwise multiplication and addTo in Lagrange space */
+EXPORT void LagrangeHalfCPolynomialAddMul(
+        LagrangeHalfCPolynomial *accum,
+        const LagrangeHalfCPolynomial *a,
+        const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const FFT_Processor_NTT *proc = result1->proc;
+    const int32_t N = proc->N;
+    const uint64_t *aa = ((const LagrangeHalfCPolynomial_IMPL *) a)->values;
+    const uint64_t *bb = ((const LagrangeHalfCPolynomial_IMPL *) b)->values;
+    uint64_t *rr = result1->values;
+    for (int32_t i = 0; i < N; i++)
+        rr[i] = FFT_Processor_NTT::add_mod(rr[i], proc->mont_mul(aa[i], bb[i]));
+}
+
+/** termwise multiplication and subTo in Lagrange space */
+EXPORT void LagrangeHalfCPolynomialSubMul(
+        LagrangeHalfCPolynomial *accum,
+        const LagrangeHalfCPolynomial *a,
+        const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const FFT_Processor_NTT *proc = result1->proc;
+    const int32_t N = proc->N;
+    const uint64_t *aa = ((const LagrangeHalfCPolynomial_IMPL *) a)->values;
+    const uint64_t *bb = ((const LagrangeHalfCPolynomial_IMPL *) b)->values;
+    uint64_t *rr = result1->values;
+    for (int32_t i = 0; i < N; i++)
+        rr[i] = FFT_Processor_NTT::sub_mod(rr[i], proc->mont_mul(aa[i], bb[i]));
+}
+
+EXPORT void LagrangeHalfCPolynomialAddTo(
+        LagrangeHalfCPolynomial *accum,
+        const LagrangeHalfCPolynomial *a) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const int32_t N = result1->proc->N;
+    const uint64_t *aa = ((const LagrangeHalfCPolynomial_IMPL *) a)->values;
+    uint64_t *rr = result1->values;
+    for (int32_t i = 0; i < N; i++)
+        rr[i] = FFT_Processor_NTT::add_mod(rr[i], aa[i]);
+}
+
+// same as SubMul
+EXPORT void LagrangeHalfCPolynomialSubTo(
+        LagrangeHalfCPolynomial *accum,
+        const LagrangeHalfCPolynomial *a,
+        const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomialSubMul(accum, a, b);
+}
+
+// 2引数版: accum -= a
+EXPORT void LagrangeHalfCPolynomialSubToSimple(
+        LagrangeHalfCPolynomial *accum,
+        const LagrangeHalfCPolynomial *a) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const int32_t N = result1->proc->N;
+    const uint64_t *aa = ((const LagrangeHalfCPolynomial_IMPL *) a)->values;
+    uint64_t *rr = result1->values;
+    for (int32_t i = 0; i < N; i++)
+        rr[i] = FFT_Processor_NTT::sub_mod(rr[i], aa[i]);
+}
@@ -0,0 +1,121 @@
+#ifndef LAGRANGEHALFC_IMPL_NTT_H
+#define LAGRANGEHALFC_IMPL_NTT_H
+
+#include <cassert>
+#include <cstdint>
+#include "tfhe.h"
+#include "polynomials.h"
+
+/**
+ * Exact negacyclic number theoretic transform over Z/pZ, p = 2^62 - 3.2^19 + 1.
+ *
+ * The integer (resp. torus) polynomials are lifted to the integers in [-2^31,2^31), so the
+ * product of a torus polynomial by an integer polynomial is exact mod 2^32 as long as the
+ * integer coefficients of the result stay in (-p/2,p/2): it suffices that the sum of the
+ * absolute values of the integer coefficients (over all the products accumulated in the
+ * Lagrange space) is below 2^30, e.g. N.Bg/2.(number of terms) <= 2^30.
+ *
+ * The butterflies are Harvey's lazy butterflies with Shoup's precomputed twiddles,
+ * and the Lagrange values are kept in Montgomery form (x.2^64 mod p) so that the
+ * pointwise products are Montgomery multiplications.
+ */
+class FFT_Processor_NTT {
+public:
+    const int32_t _2N;
+    const int32_t N;
+    const int32_t Ns2;
+    static const uint64_t P;
+
+private:
+    uint64_t *buf;           //2N, room for two polynomials
+    uint64_t *psi_rev;       //psi^rev(i), psi is a primitive 2N-th root of unity
+    uint64_t *psi_rev_shoup; //floor(psi^rev(i).2^64/p)
+    uint64_t *ipsi_rev;      //psi^-rev(i)
+    uint64_t *ipsi_rev_shoup;
+    uint64_t mont_r;         //2^64 mod p
+    uint64_t mont_r_shoup;
+    uint64_t inv_scale;      //N^-1.2^-64 mod p
+    uint64_t inv_scale_shoup;
+    int32_t **auto_tables; //one automorphism table per odd e, built on first use
+
+    //transform M polynomials at once, the twiddles are loaded once for all of them
+    template<int32_t M>
+    void forward(uint64_t *const *a);
+    template<int32_t M>
+    void inverse(uint64_t *const *a);
+    void direct_output(Torus32 *res, const uint64_t *a);
+
+public:
+    uint64_t p_inv;     //p^-1 mod 2^64
+    uint64_t *xpow;     //psi^j.2^64 mod p, for j < 2N
+    int32_t *slot_exp;  //the i-th Lagrange value is P(psi^slot_exp[i])
+
+    FFT_Processor_NTT(const int32_t N);
+
+    // Lagrange automorphism X -> X^e (e odd): the value i of the result is the value table[i] of the input
+    const int32_t *automorphism_table(int32_t e);
+
+    void execute_reverse_int(uint64_t *res, const int32_t *a);
+
+    void execute_reverse_torus32(uint64_t *res, const Torus32 *a);
+
+    void execute_direct_torus32(Torus32 *res, const uint64_t *a);
+
+    void execute_reverse_int2(uint64_t *res0, uint64_t *res1, const int32_t *a0, const int32_t *a1);
+
+    void execute_direct_torus32_2(Torus32 *res0, Torus32 *res1, const uint64_t *a0, const uint64_t *a1);
+
+    // transform of the signed digit ((a+offset)>>decal)&maskMod - halfBg, computed on the fly
+    void execute_reverse_digit(uint64_t *res, const Torus32 *a, int32_t decal, uint32_t maskMod, int32_t halfBg,
+                               uint32_t offset);
+
+    // two consecutive digits (decal and decal-Bgbit) from a single pass over a
+    void execute_reverse_digit2(uint64_t *res0, uint64_t *res1, const Torus32 *a, int32_t decal, int32_t Bgbit,
+                                uint32_t maskMod, int32_t halfBg, uint32_t offset);
+
+    /** a.b.2^-64 mod p, in [0,p) (Montgomery multiplication) */
+    inline uint64_t mont_mul(uint64_t a, uint64_t b) const {
+        const unsigned __int128 t = (unsigned __int128) a * b;
+        const uint64_t m = uint64_t(t) * p_inv;
+        const uint64_t hi = uint64_t(t >> 64);
+        const uint64_t mp = uint64_t(((unsigned __int128) m * P) >> 64);
+        return (hi >= mp) ? hi - mp : hi - mp + P;
+    }
+
+    static inline uint64_t add_mod(uint64_t a, uint64_t b) {
+        const uint64_t s = a + b;
+        return (s >= P) ? s - P : s;
+    }
+
+    static inline uint64_t sub_mod(uint64_t a, uint64_t b) {
+        return (a >= b) ? a - b : a - b + P;
+    }
+
+    /** the Montgomery form of the integer x */
+    inline uint64_t to_mont(int64_t x) const {
+        const uint64_t xp = (x >= 0) ? uint64_t(x) : uint64_t(x + int64_t(P));
+        const uint64_t q = uint64_t(((unsigned __int128) xp * mont_r_shoup) >> 64);
+        const uint64_t r = xp * mont_r - q * P;
+        return (r >= P) ? r - P : r;
+    }
+
+    ~FFT_Processor_NTT();
+};
+
+extern thread_local FFT_Processor_NTT ntt1024;
+
+/**
+ * structure that represents a polynomial P mod X^N+1
+ * as its N values P(psi^(2j+1)) mod p, in Montgomery form,
+ * where psi is a primitive 2N-th root of unity mod p
+ */
+struct LagrangeHalfCPolynomial_IMPL {
+    uint64_t *values;
+    FFT_Processor_NTT *proc;
+
+    LagrangeHalfCPolynomial_IMPL(int32_t N);
+
+    ~LagrangeHalfCPolynomial_IMPL();
+};
+
+#endif // LAGRANGEHALFC_IMPL_NTT_H
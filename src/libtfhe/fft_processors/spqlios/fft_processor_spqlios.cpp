@@ -21,6 +21,9 @@ FFT_Processor_Spqlios::FFT_Processor_Spqlios(const int32_t N) : _2N(2 * N), N(N)
     imag_inout_direct = real_inout_direct + Ns2;
     real_inout_rev = fft_table_get_buffer(tables_reverse);
     imag_inout_rev = real_inout_rev + Ns2;
+#ifdef TFHE_CPU_DISPATCH
+    batch_direct = new double[N];
+#endif
     reva = new int32_t[Ns2];
     cosomegaxminus1 = new double[2 * _2N];
     sinomegaxminus1 = cosomegaxminus1 + _2N;
@@ -33,9 +36,43 @@ FFT_Processor_Spqlios::FFT_Processor_Spqlios(const int32_t N) : _2N(2 * N), N(N)
         cosomegaxminus1[j] = cos(2 * M_PI * j / _2N) - 1.;
         sinomegaxminus1[j] = sin(2 * M_PI * j / _2N);
     }
+    auto_tables = new int32_t *[N]();
+}
+
+/**
+ * the value i is P(omega^reva[i]), so P(X^e) takes there the value of P at omega^(e.reva[i]):
+ * one of the stored values, or the conjugate of one (P has real coefficients)
+ */
+const int32_t *FFT_Processor_Spqlios::automorphism_table(int32_t e) {
+    assert((e & 1) == 1 && e > 0 && e < _2N);
+    int32_t *&table = auto_tables[e >> 1];
+    if (table) return table;
+    int32_t *slot = new int32_t[_2N];
+    for (int32_t j = 0; j < _2N; j++) slot[j] = -1;
+    for (int32_t j = 0; j < Ns2; j++) slot[reva[j]] = j;
+    table = new int32_t[Ns2];
+    for (int32_t i = 0; i < Ns2; i++) {
+        const int32_t y = int32_t((int64_t(e) * reva[i]) % _2N);
+        table[i] = slot[y] >= 0 ? slot[y] : ~slot[_2N - y];
+    }
+    delete[] slot;
+    return table;
 }
 
 void FFT_Processor_Spqlios::execute_reverse_int(double *res, const int32_t *a) {
+#ifdef TFHE_CPU_DISPATCH
+    const Spqlios_Kernels *kernels = spqlios_kernels();
+    if (kernels->avx512) {
+        execute_reverse_int_avx512(res, a);
+        return;
+    }
+    if (!kernels->avx) {
+        for (int32_t i = 0; i < N; i++) real_inout_rev[i] = (double) a[i];
+        kernels->ifft(tables_reverse, real_inout_rev);
+        for (int32_t i = 0; i < N; i++) res[i] = real_inout_rev[i];
+        return;
+    }
+#endif
     //for (int32_t i=0; i<N; i++) real_inout_rev[i]=(double)a[i];
     {
         double *dst = real_inout_rev;
@@ -55,7 +92,11 @@ void FFT_Processor_Spqlios::execute_reverse_int(double *res, const int32_t *a) {
         : "%xmm0", "%ymm1", "memory"
         );
     }
+#ifdef TFHE_CPU_DISPATCH
+    kernels->ifft(tables_reverse, real_inout_rev);
+#else
     ifft(tables_reverse, real_inout_rev);
+#endif
     //for (int32_t i=0; i<N; i++) res[i]=real_inout_rev[i];
     {
         double *dst = res;
@@ -85,9 +126,97 @@ void FFT_Processor_Spqlios::execute_reverse_torus32(double *res, const Torus32 *
     execute_reverse_int(res, aa);
 }
 
+void FFT_Processor_Spqlios::execute_reverse_digit(double *res, const Torus32 *a, const int32_t decal,
+                                                  const uint32_t maskMod, const int32_t halfBg, const uint32_t offset) {
+    //the digits are computed directly in the FFT buffer, without going through an IntPolynomial
+#ifdef TFHE_CPU_DISPATCH
+    const Spqlios_Kernels *kernels = spqlios_kernels();
+    if (kernels->avx512) {
+        execute_reverse_digit_avx512(res, a, decal, maskMod, halfBg, offset);
+        return;
+    }
+    if (!kernels->avx) {
+        const uint32_t *aa = (const uint32_t *) a;
+        for (int32_t i = 0; i < N; i++)
+            real_inout_rev[i] = double(int32_t(((aa[i] + offset) >> decal) & maskMod) - halfBg);
+        kernels->ifft(tables_reverse, real_inout_rev);
+        for (int32_t i = 0; i < N; i++) res[i] = real_inout_rev[i];
+        return;
+    }
+#endif
+    //for (int32_t i=0; i<N; i++) real_inout_rev[i]=(((a[i]+offset)>>decal)&maskMod)-halfBg;
+    {
+        double *dst = real_inout_rev;
+        const Torus32 *ait = a;
+        const Torus32 *aend = a + N;
+        const uint32_t *offset_addr = &offset;
+        const uint32_t *maskMod_addr = &maskMod;
+        const int32_t *halfBg_addr = &halfBg;
+        const int32_t *decal_addr = &decal;
+        __asm__ __volatile__ (
+        "vbroadcastss (%3),%%xmm4\n"
+                "vbroadcastss (%4),%%xmm5\n"
+                "vbroadcastss (%5),%%xmm6\n"
+                "vmovd (%6),%%xmm7\n"
+                "0:\n"
+                "vmovdqu (%1),%%xmm0\n"
+                "vpaddd %%xmm4,%%xmm0,%%xmm0\n" // add offset
+                "vpsrld %%xmm7,%%xmm0,%%xmm0\n" // shift by decal
+                "vpand %%xmm5,%%xmm0,%%xmm0\n"  // and maskMod
+                "vpsubd %%xmm6,%%xmm0,%%xmm0\n" // sub halfBg
+                "vcvtdq2pd %%xmm0,%%ymm1\n"
+                "vmovapd %%ymm1,(%0)\n"
+                "addq $16,%1\n"
+                "addq $32,%0\n"
+                "cmpq %2,%1\n"
+                "jb 0b\n"
+        : "=r"(dst), "=r"(ait), "=r"(aend), "=r"(offset_addr), "=r"(maskMod_addr), "=r"(halfBg_addr), "=r"(decal_addr)
+        : "0"(dst), "1"(ait), "2"(aend), "3"(offset_addr), "4"(maskMod_addr), "5"(halfBg_addr), "6"(decal_addr)
+        : "%xmm0", "%ymm1", "%xmm4", "%xmm5", "%xmm6", "%xmm7", "memory"
+        );
+    }
+#ifdef TFHE_CPU_DISPATCH
+    kernels->ifft(tables_reverse, real_inout_rev);
+#else
+    ifft(tables_reverse, real_inout_rev);
+#endif
+    //for (int32_t i=0; i<N; i++) res[i]=real_inout_rev[i];
+    {
+        double *dst = res;
+        double *sit = real_inout_rev;
+        double *send = real_inout_rev + N;
+        __asm__ __volatile__ (
+        "1:\n"
+                "vmovapd (%1),%%ymm0\n"
+                "vmovupd %%ymm0,(%0)\n"
+                "addq $32,%1\n"
+                "addq $32,%0\n"
+                "cmpq %2,%1\n"
+                "jb 1b\n"
+                "vzeroall\n"
+        : "=r"(dst), "=r"(sit), "=r"(send)
+        : "0"(dst), "1"(sit), "2"(send)
+        : "%ymm0", "memory"
+        );
+    }
+}
+
 void FFT_Processor_Spqlios::execute_direct_torus32(Torus32 *res, const double *a) {
     //TODO: parallelization
     static const double _2sN = double(2) / double(N);
+#ifdef TFHE_CPU_DISPATCH
+    const Spqlios_Kernels *kernels = spqlios_kernels();
+    if (kernels->avx512) {
+        execute_direct_torus32_avx512(res, a);
+        return;
+    }
+    if (!kernels->avx) {
+        for (int32_t i = 0; i < N; i++) real_inout_direct[i] = a[i] * _2sN;
+        kernels->fft(tables_direct, real_inout_direct);
+        for (int32_t i = 0; i < N; i++) res[i] = Torus32(int64_t(real_inout_direct[i]));
+        return;
+    }
+#endif
     //for (int32_t i=0; i<N; i++) real_inout_direct[i]=a[i]*_2sn;
     {
         double *dst = real_inout_direct;
@@ -110,7 +239,11 @@ void FFT_Processor_Spqlios::execute_direct_torus32(Torus32 *res, const double *a
         : "%ymm0", "%ymm2", "memory"
         );
     }
+#ifdef TFHE_CPU_DISPATCH
+    kernels->fft(tables_direct, real_inout_direct);
+#else
     fft(tables_direct, real_inout_direct);
+#endif
     for (int32_t i = 0; i < N; i++) res[i] = Torus32(int64_t(real_inout_direct[i]));
 }
 
@@ -118,6 +251,11 @@ FFT_Processor_Spqlios::~FFT_Processor_Spqlios() {
     //delete (tables_direct);
     //delete (tables_reverse);
     delete[] cosomegaxminus1;
+    for (int32_t i = 0; i < N; i++) delete[] auto_tables[i];
+    delete[] auto_tables;
+#ifdef TFHE_CPU_DISPATCH
+    delete[] batch_direct;
+#endif
 }
 
 thread_local FFT_Processor_Spqlios fftp1024(1024);
@@ -134,3 +272,62 @@ EXPORT void TorusPolynomial_ifft(LagrangeHalfCPolynomial *result, const TorusPol
 EXPORT void TorusPolynomial_fft(TorusPolynomial *result, const LagrangeHalfCPolynomial *p) {
     fftp1024.execute_direct_torus32(result->coefsT, ((LagrangeHalfCPolynomial_IMPL *) p)->coefsC);
 }
+
+/**
+ * batched FFT functions: the AVX-512 kernels transform the polynomials two by two,
+ * the others one by one
+ */
+EXPORT void IntPolynomial_ifft_batch(LagrangeHalfCPolynomial *result, const IntPolynomial *p, const int32_t count) {
+    LagrangeHalfCPolynomial_IMPL *r = (LagrangeHalfCPolynomial_IMPL *) result;
+    int32_t i = 0;
+#ifdef TFHE_CPU_DISPATCH
+    if (spqlios_kernels()->avx512) {
+        for (; i + 1 < count; i += 2)
+            fftp1024.execute_reverse_int2_avx512(r[i].coefsC, r[i + 1].coefsC, p[i].coefs, p[i + 1].coefs);
+    }
+#endif
+    for (; i < count; i++)
+        fftp1024.execute_reverse_int(r[i].coefsC, p[i].coefs);
+}
+EXPORT void TorusPolynomial_ifft_batch(LagrangeHalfCPolynomial *result, const TorusPolynomial *p, const int32_t count) {
+    LagrangeHalfCPolynomial_IMPL *r = (LagrangeHalfCPolynomial_IMPL *) result;
+    int32_t i = 0;
+#ifdef TFHE_CPU_DISPATCH
+    if (spqlios_kernels()->avx512) {
+        for (; i + 1 < count; i += 2)
+            fftp1024.execute_reverse_int2_avx512(r[i].coefsC, r[i + 1].coefsC,
+                                                 (const int32_t *) p[i].coefsT, (const int32_t *) p[i + 1].coefsT);
+    }
+#endif
+    for (; i < count; i++)
+        fftp1024.execute_reverse_torus32(r[i].coefsC, p[i].coefsT);
+}
+EXPORT void TorusPolynomial_fft_batch(TorusPolynomial *result, const LagrangeHalfCPolynomial *p, const int32_t count) {
+    const LagrangeHalfCPolynomial_IMPL *pp = (const LagrangeHalfCPolynomial_IMPL *) p;
+    int32_t i = 0;
+#ifdef TFHE_CPU_DISPATCH
+    if (spqlios_kernels()->avx512) {
+        for (; i + 1 < count; i += 2)
+            fftp1024.execute_direct_torus32_2_avx512(result[i].coefsT, result[i + 1].coefsT, pp[i].coefsC,
+                                                     pp[i + 1].coefsC);
+    }
+#endif
+    for (; i < count; i++)
+        fftp1024.execute_direct_torus32(result[i].coefsT, pp[i].coefsC);
+}
+
+EXPORT void TorusPolynomial_decomp_ifft(LagrangeHalfCPolynomial *result, const TorusPolynomial *p, const int32_t l,
+                                        const int32_t Bgbit, const uint32_t maskMod, const int32_t halfBg,
+                                        const uint32_t offset) {
+    LagrangeHalfCPolynomial_IMPL *r = (LagrangeHalfCPolynomial_IMPL *) result;
+    int32_t q = 0;
+#ifdef TFHE_CPU_DISPATCH
+    if (spqlios_kernels()->avx512) {
+        for (; q + 1 < l; q += 2)
+            fftp1024.execute_reverse_digit2_avx512(r[q].coefsC, r[q + 1].coefsC, p->coefsT, 32 - (q + 1) * Bgbit,
+                                                   Bgbit, maskMod, halfBg, offset);
+    }
+#endif
+    for (; q < l; q++)
+        fftp1024.execute_reverse_digit(r[q].coefsC, p->coefsT, 32 - (q + 1) * Bgbit, maskMod, halfBg, offset);
+}
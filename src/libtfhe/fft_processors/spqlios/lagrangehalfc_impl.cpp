@@ -39,19 +39,22 @@ EXPORT void destroy_LagrangeHalfCPolynomial_array(int32_t nbelts, LagrangeHalfCP
 }
 
 
-//MISC OPERATIONS
-/** sets to zero */
-EXPORT void LagrangeHalfCPolynomialClear(
-        LagrangeHalfCPolynomial *reps) {
-    LagrangeHalfCPolynomial_IMPL *reps1 = (LagrangeHalfCPolynomial_IMPL *) reps;
-    const int32_t N = reps1->proc->N;
-#ifndef __AVX2__
-    for (int32_t i = 0; i < N; i++)
-        reps1->coefsC[i] = 0;
+// the AVX2 helpers are written in inline assembly, which does not depend on the compilation
+// flags: they are used when the target has AVX2, or in the dispatch build when the CPU has it
+static inline bool use_avx2_helpers() {
+#if defined TFHE_CPU_DISPATCH
+    return spqlios_kernels()->avx2;
+#elif defined __AVX2__
+    return true;
 #else
-    {
-    double* sit = reps1->coefsC;
-    double* send = reps1->coefsC+N;
+    return false;
+#endif
+}
+
+//MISC OPERATIONS
+static void LagrangeHalfCPolynomialClear_avx2(double *coefsC, const int32_t N) {
+    double* sit = coefsC;
+    double* send = coefsC+N;
     __asm__ __volatile__ (
         "vpxor %%ymm0,%%ymm0,%%ymm0\n"
         "0:\n"
@@ -63,8 +66,19 @@ EXPORT void LagrangeHalfCPolynomialClear(
         :  "0"(sit), "1"(send)
         : "%ymm0", "memory"
         );
+}
+
+/** sets to zero */
+EXPORT void LagrangeHalfCPolynomialClear(
+        LagrangeHalfCPolynomial *reps) {
+    LagrangeHalfCPolynomial_IMPL *reps1 = (LagrangeHalfCPolynomial_IMPL *) reps;
+    const int32_t N = reps1->proc->N;
+    if (use_avx2_helpers()) {
+        LagrangeHalfCPolynomialClear_avx2(reps1->coefsC, N);
+        return;
     }
-#endif
+    for (int32_t i = 0; i < N; i++)
+        reps1->coefsC[i] = 0;
 }
 
 
@@ -88,24 +102,7 @@ EXPORT void LagrangeHalfCPolynomialCopy(LagrangeHalfCPolynomial* reps, LagrangeH
 
 
 
-#ifndef __AVX2__
-EXPORT void LagrangeHalfCPolynomialSetTorusConstant(LagrangeHalfCPolynomial *result, const Torus32 mu) {
-    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
-    const int32_t Ns2 = result1->proc->Ns2;
-    double *b = result1->coefsC;
-    double *c = b + Ns2;
-    const double muc = mu; //we do not rescale
-
-    for (int32_t j = 0; j < Ns2; j++) b[j] = muc;
-    for (int32_t j = 0; j < Ns2; j++) c[j] = 0;
-
-
-}
-#else
-EXPORT void LagrangeHalfCPolynomialSetTorusConstant(LagrangeHalfCPolynomial* result, const Torus32 mu) {
-    LagrangeHalfCPolynomial_IMPL* result1 = (LagrangeHalfCPolynomial_IMPL*) result;
-    const int32_t Ns2 = result1->proc->Ns2;
-    double* b = result1->coefsC;
+static void LagrangeHalfCPolynomialSetTorusConstant_avx2(double *b, const int32_t Ns2, const Torus32 mu) {
     double* c = b+Ns2;
     double* d = c+Ns2;
 
@@ -127,23 +124,24 @@ EXPORT void LagrangeHalfCPolynomialSetTorusConstant(LagrangeHalfCPolynomial* res
         :  "0"(b), "1"(c), "2"(d),"S"(mu)
         : "%ymm0", "memory"
         );
- 
 }
-#endif
 
-#ifndef __AVX2__
-EXPORT void LagrangeHalfCPolynomialAddTorusConstant(LagrangeHalfCPolynomial *result, const Torus32 mu) {
+EXPORT void LagrangeHalfCPolynomialSetTorusConstant(LagrangeHalfCPolynomial *result, const Torus32 mu) {
     LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
     const int32_t Ns2 = result1->proc->Ns2;
     double *b = result1->coefsC;
+    double *c = b + Ns2;
     const double muc = mu; //we do not rescale
-    for (int32_t j = 0; j < Ns2; j++) b[j] += muc;
+
+    if (use_avx2_helpers()) {
+        LagrangeHalfCPolynomialSetTorusConstant_avx2(b, Ns2, mu);
+        return;
+    }
+    for (int32_t j = 0; j < Ns2; j++) b[j] = muc;
+    for (int32_t j = 0; j < Ns2; j++) c[j] = 0;
 }
-#else
-EXPORT void LagrangeHalfCPolynomialAddTorusConstant(LagrangeHalfCPolynomial* result, const Torus32 mu) {
-    LagrangeHalfCPolynomial_IMPL* result1 = (LagrangeHalfCPolynomial_IMPL*) result;
-    const int32_t Ns2 = result1->proc->Ns2;
-    double* b = result1->coefsC;
+
+static void LagrangeHalfCPolynomialAddTorusConstant_avx2(double *b, const int32_t Ns2, const Torus32 mu) {
     double* c = b+Ns2;
 
     __asm__ __volatile__ (
@@ -161,9 +159,20 @@ EXPORT void LagrangeHalfCPolynomialAddTorusConstant(LagrangeHalfCPolynomial* res
         :  "0"(b), "1"(c),"S"(mu)
         : "%ymm0","%ymm1","memory"
         );
- 
 }
-#endif
+
+EXPORT void LagrangeHalfCPolynomialAddTorusConstant(LagrangeHalfCPolynomial *result, const Torus32 mu) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
+    const int32_t Ns2 = result1->proc->Ns2;
+    double *b = result1->coefsC;
+    const double muc = mu; //we do not rescale
+
+    if (use_avx2_helpers()) {
+        LagrangeHalfCPolynomialAddTorusConstant_avx2(b, Ns2, mu);
+        return;
+    }
+    for (int32_t j = 0; j < Ns2; j++) b[j] += muc;
+}
 
 EXPORT void LagrangeHalfCPolynomialSetXaiMinusOne(LagrangeHalfCPolynomial *result, const int32_t ai) {
     LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
@@ -181,9 +190,35 @@ EXPORT void LagrangeHalfCPolynomialSetXaiMinusOne(LagrangeHalfCPolynomial *resul
     }
 }
 
+/** result(X) = a(X^e), e odd: a permutation of the values, some of them conjugated */
+EXPORT void LagrangeHalfCPolynomialAutomorphism(LagrangeHalfCPolynomial *result, const LagrangeHalfCPolynomial *a,
+                                                const int32_t e) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
+    const int32_t Ns2 = result1->proc->Ns2;
+    const int32_t *table = result1->proc->automorphism_table(e);
+    const double *ar = ((const LagrangeHalfCPolynomial_IMPL *) a)->coefsC;
+    const double *ai = ar + Ns2;
+    double *rr = result1->coefsC;
+    double *ri = rr + Ns2;
+    assert(rr != ar);
+    for (int32_t i = 0; i < Ns2; i++) {
+        const int32_t j = table[i];
+        if (j >= 0) {
+            rr[i] = ar[j];
+            ri[i] = ai[j];
+        } else {
+            rr[i] = ar[~j];
+            ri[i] = -ai[~j];
+        }
+    }
+}
+
 EXPORT void LagrangeHalfCPolynomialAddTo(
         LagrangeHalfCPolynomial *accum,
         const LagrangeHalfCPolynomial *a) {
+#ifdef TFHE_CPU_DISPATCH
+    spqlios_kernels()->addTo(accum, a);
+#else
     LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) accum;
     const int32_t N = result1->proc->N;
     double *rr = result1->coefsC;
@@ -191,6 +226,7 @@ EXPORT void LagrangeHalfCPolynomialAddTo(
     for (int32_t i = 0; i < N; i++) {
         rr[i] += ar[i];
     }
+#endif
 }    
 
 
@@ -19,6 +19,10 @@ private:
     double *imag_inout_rev;
     void *tables_direct;
     void *tables_reverse;
+    int32_t **auto_tables; //one automorphism table per odd e, built on first use
+#ifdef TFHE_CPU_DISPATCH
+    double *batch_direct; //second input buffer of the direct FFT, for the batches
+#endif
 public:
     double *cosomegaxminus1;
     double *sinomegaxminus1;
@@ -26,12 +30,39 @@ public:
 
     FFT_Processor_Spqlios(const int32_t N);
 
+    // Lagrange automorphism X -> X^e (e odd): the value i of the result is the value table[i]
+    // of the input, or the conjugate of the value ~table[i] when table[i] < 0
+    const int32_t *automorphism_table(int32_t e);
+
     void execute_reverse_int(double *res, const int32_t *a);
 
     void execute_reverse_torus32(double *res, const Torus32 *a);
 
     void execute_direct_torus32(Torus32 *res, const double *a);
 
+    // reverse FFT of the signed digit ((a+offset)>>decal)&maskMod - halfBg, computed on the fly
+    void execute_reverse_digit(double *res, const Torus32 *a, int32_t decal, uint32_t maskMod, int32_t halfBg,
+                               uint32_t offset);
+
+#ifdef TFHE_CPU_DISPATCH
+    // AVX-512F versions, called by the two functions above when they are selected
+    void execute_reverse_int_avx512(double *res, const int32_t *a);
+
+    void execute_direct_torus32_avx512(Torus32 *res, const double *a);
+
+    // two polynomials at once (the butterflies are interleaved), used by the batches
+    void execute_reverse_int2_avx512(double *res0, double *res1, const int32_t *a0, const int32_t *a1);
+
+    void execute_direct_torus32_2_avx512(Torus32 *res0, Torus32 *res1, const double *a0, const double *a1);
+
+    void execute_reverse_digit_avx512(double *res, const Torus32 *a, int32_t decal, uint32_t maskMod, int32_t halfBg,
+                                      uint32_t offset);
+
+    // two consecutive digits (decal and decal-Bgbit) from a single pass over a
+    void execute_reverse_digit2_avx512(double *res0, double *res1, const Torus32 *a, int32_t decal, int32_t Bgbit,
+                                       uint32_t maskMod, int32_t halfBg, uint32_t offset);
+#endif
+
     ~FFT_Processor_Spqlios();
 };
 
@@ -52,4 +83,36 @@ struct LagrangeHalfCPolynomial_IMPL {
     ~LagrangeHalfCPolynomial_IMPL();
 };
 
+#ifdef TFHE_CPU_DISPATCH
+/**
+ * the spqlios kernels selected when the library is loaded:
+ * the AVX-512F intrinsics, the FMA or AVX assembly, or the portable C++ model
+ * of the same FFT (all of them share the tables and the Lagrange layout)
+ */
+struct Spqlios_Kernels {
+    bool avx; ///< the AVX conversion loops of the processor can be used
+    bool avx2; ///< the AVX2 helpers of the Lagrange arithmetic can be used
+    bool avx512; ///< the AVX-512F conversion loops of the processor are used instead
+    void (*fft)(const void *tables, double *data);
+    void (*ifft)(const void *tables, double *data);
+    void (*mul)(LagrangeHalfCPolynomial *result, const LagrangeHalfCPolynomial *a, const LagrangeHalfCPolynomial *b);
+    void (*addMul)(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a, const LagrangeHalfCPolynomial *b);
+    void (*subMul)(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a, const LagrangeHalfCPolynomial *b);
+    void (*addTo)(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a);
+};
+
+const Spqlios_Kernels *spqlios_kernels();
+
+// spqlios-avx512.cpp: only called when the CPU supports AVX-512F and FMA
+void fft_avx512(const void *tables, double *data);
+void ifft_avx512(const void *tables, double *data);
+void LagrangeHalfCPolynomialMul_avx512(LagrangeHalfCPolynomial *result, const LagrangeHalfCPolynomial *a,
+                                       const LagrangeHalfCPolynomial *b);
+void LagrangeHalfCPolynomialAddMul_avx512(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                          const LagrangeHalfCPolynomial *b);
+void LagrangeHalfCPolynomialSubMul_avx512(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                          const LagrangeHalfCPolynomial *b);
+void LagrangeHalfCPolynomialAddTo_avx512(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a);
+#endif
+
 #endif // LAGRANGEHALFC_IMPL_SPQLIOS_H
@@ -0,0 +1,462 @@
+#include <immintrin.h>
+#include "lagrangehalfc_impl.h"
+#include "spqlios-fft.h"
+
+using namespace std;
+
+/*
+ * AVX-512F kernels of the dispatch build.
+ * The FFTs follow fft_model/ifft_model (spqlios-fft-impl.cpp) on the same tables,
+ * 8 coefficients at a time: the tables store 4 cosines followed by 4 sines, so two
+ * consecutive groups are shuffled into one vector of cosines and one of sines.
+ * The file is compiled with the baseline flags: every function carries its target,
+ * and is only called when the CPU supports AVX-512F and FMA.
+ */
+#define AVX512_KERNEL __attribute__((target("avx512f,fma")))
+
+/*
+ * Without -mavx512f on the command line, GCC reports the _mm512_undefined_pd()
+ * passthrough of the masked builtins (shuffle_f64x2, permute_pd, ...) as
+ * maybe-uninitialized wherever they are inlined. Those lanes are never read.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace {
+
+    // cos and sin of 8 consecutive twiddles (|c0..c3|s0..s3|c4..c7|s4..s7|)
+    AVX512_KERNEL inline void load_trig8(__m512d &cs, __m512d &sn, const double *t) {
+        const __m512d t0 = _mm512_loadu_pd(t);
+        const __m512d t1 = _mm512_loadu_pd(t + 8);
+        cs = _mm512_shuffle_f64x2(t0, t1, 0x44);
+        sn = _mm512_shuffle_f64x2(t0, t1, 0xEE);
+    }
+
+    AVX512_KERNEL inline __m512d signs(double a, double b, double c, double d) {
+        return _mm512_setr_pd(a, b, c, d, a, b, c, d);
+    }
+
+    /*
+     * The transforms below work on M polynomials at once: each twiddle is loaded once,
+     * and the butterflies of the M polynomials are independent (instruction-level parallelism).
+     * data[m] holds the ns4 real parts followed by the ns4 imaginary parts of the m-th polynomial.
+     */
+
+    //(re*cos-im*sin) + i (im*cos+re*sin) on ns4 coefficients
+    template<int32_t M>
+    AVX512_KERNEL void twist(double *const *data, const double *trig_tables, int32_t ns4) {
+        for (int32_t j = 0; j < ns4; j += 8) {
+            __m512d cs, sn;
+            load_trig8(cs, sn, trig_tables + 2 * j);
+            for (int32_t m = 0; m < M; m++) {
+                double *re = data[m] + j;
+                double *im = re + ns4;
+                const __m512d d0 = _mm512_loadu_pd(re);
+                const __m512d d1 = _mm512_loadu_pd(im);
+                _mm512_storeu_pd(re, _mm512_fmsub_pd(d0, cs, _mm512_mul_pd(d1, sn)));
+                _mm512_storeu_pd(im, _mm512_fmadd_pd(d0, sn, _mm512_mul_pd(d1, cs)));
+            }
+        }
+    }
+
+    //size 2: [1 1][1 -1] on each pair
+    template<int32_t M>
+    AVX512_KERNEL void butterfly2(double *const *data, int32_t ns4) {
+        const __m512d sgn = signs(1, -1, 1, -1);
+        for (int32_t block = 0; block < ns4; block += 8) {
+            for (int32_t m = 0; m < M; m++) {
+                double *re = data[m] + block;
+                double *im = re + ns4;
+                const __m512d r = _mm512_loadu_pd(re);
+                const __m512d i = _mm512_loadu_pd(im);
+                _mm512_storeu_pd(re, _mm512_fmadd_pd(_mm512_permute_pd(r, 0xFF), sgn, _mm512_permute_pd(r, 0x00)));
+                _mm512_storeu_pd(im, _mm512_fmadd_pd(_mm512_permute_pd(i, 0xFF), sgn, _mm512_permute_pd(i, 0x00)));
+            }
+        }
+    }
+
+    template<int32_t M>
+    AVX512_KERNEL void fft_avx512_m(const void *tables, double *const *data) {
+        const int32_t n = fft_table_get_size(tables);
+        const double *trig_tables = fft_table_get_trig_tables(tables);
+        const int32_t ns4 = n / 4;
+        assert(ns4 % 16 == 0);
+
+        butterfly2<M>(data, ns4);
+
+        //size 4
+        // r0 + r2    i0 + i2
+        // r1 + i3    i1 - r3
+        // r0 - r2    i0 - i2
+        // r1 - i3    i1 + r3
+        {
+            const __m512d sgn_re = signs(1, 1, -1, -1);
+            const __m512d sgn_im = signs(1, -1, -1, 1);
+            for (int32_t block = 0; block < ns4; block += 8) {
+                for (int32_t m = 0; m < M; m++) {
+                    double *pre = data[m] + block;
+                    double *pim = pre + ns4;
+                    const __m512d r = _mm512_loadu_pd(pre);
+                    const __m512d i = _mm512_loadu_pd(pim);
+                    const __m512d r01 = _mm512_permutex_pd(r, 0x44);
+                    const __m512d r23 = _mm512_permutex_pd(r, 0xEE);
+                    const __m512d i01 = _mm512_permutex_pd(i, 0x44);
+                    const __m512d i23 = _mm512_permutex_pd(i, 0xEE);
+                    _mm512_storeu_pd(pre, _mm512_fmadd_pd(_mm512_mask_blend_pd(0xAA, r23, i23), sgn_re, r01));
+                    _mm512_storeu_pd(pim, _mm512_fmadd_pd(_mm512_mask_blend_pd(0xAA, i23, r23), sgn_im, i01));
+                }
+            }
+        }
+
+        //size 8: the two halves of each block of 8 are combined in the same vector
+        const double *cur_tt = trig_tables;
+        {
+            const __m512d cs = _mm512_broadcast_f64x4(_mm256_loadu_pd(cur_tt));
+            const __m512d sn = _mm512_broadcast_f64x4(_mm256_loadu_pd(cur_tt + 4));
+            const __m512d sgn = _mm512_setr_pd(1, 1, 1, 1, -1, -1, -1, -1);
+            for (int32_t block = 0; block < ns4; block += 8) {
+                for (int32_t m = 0; m < M; m++) {
+                    double *pre = data[m] + block;
+                    double *pim = pre + ns4;
+                    const __m512d r = _mm512_loadu_pd(pre);
+                    const __m512d i = _mm512_loadu_pd(pim);
+                    const __m512d r1 = _mm512_shuffle_f64x2(r, r, 0xEE);
+                    const __m512d i1 = _mm512_shuffle_f64x2(i, i, 0xEE);
+                    const __m512d tre = _mm512_fmsub_pd(r1, cs, _mm512_mul_pd(i1, sn));
+                    const __m512d tim = _mm512_fmadd_pd(r1, sn, _mm512_mul_pd(i1, cs));
+                    _mm512_storeu_pd(pre, _mm512_fmadd_pd(tre, sgn, _mm512_shuffle_f64x2(r, r, 0x44)));
+                    _mm512_storeu_pd(pim, _mm512_fmadd_pd(tim, sgn, _mm512_shuffle_f64x2(i, i, 0x44)));
+                }
+            }
+            cur_tt += 8;
+        }
+
+        //general loop
+        for (int32_t halfnn = 8; halfnn < ns4; halfnn *= 2) {
+            const int32_t nn = 2 * halfnn;
+            for (int32_t block = 0; block < ns4; block += nn) {
+                for (int32_t off = 0; off < halfnn; off += 8) {
+                    __m512d cs, sn;
+                    load_trig8(cs, sn, cur_tt + 2 * off);
+                    for (int32_t m = 0; m < M; m++) {
+                        double *re0 = data[m] + block + off;
+                        double *im0 = re0 + ns4;
+                        double *re1 = re0 + halfnn;
+                        double *im1 = im0 + halfnn;
+                        const __m512d r0 = _mm512_loadu_pd(re0);
+                        const __m512d i0 = _mm512_loadu_pd(im0);
+                        const __m512d r1 = _mm512_loadu_pd(re1);
+                        const __m512d i1 = _mm512_loadu_pd(im1);
+                        const __m512d tre = _mm512_fmsub_pd(r1, cs, _mm512_mul_pd(i1, sn));
+                        const __m512d tim = _mm512_fmadd_pd(r1, sn, _mm512_mul_pd(i1, cs));
+                        _mm512_storeu_pd(re0, _mm512_add_pd(r0, tre));
+                        _mm512_storeu_pd(im0, _mm512_add_pd(i0, tim));
+                        _mm512_storeu_pd(re1, _mm512_sub_pd(r0, tre));
+                        _mm512_storeu_pd(im1, _mm512_sub_pd(i0, tim));
+                    }
+                }
+            }
+            cur_tt += nn;
+        }
+
+        //multiply by omb^j
+        twist<M>(data, cur_tt, ns4);
+    }
+
+    template<int32_t M>
+    AVX512_KERNEL void ifft_avx512_m(const void *tables, double *const *data) {
+        const int32_t n = ifft_table_get_size(tables);
+        const double *trig_tables = ifft_table_get_trig_tables(tables);
+        const int32_t ns4 = n / 4;
+        assert(ns4 % 16 == 0);
+
+        //multiply by omega^j
+        twist<M>(data, trig_tables, ns4);
+
+        const double *cur_tt = trig_tables;
+        for (int32_t nn = ns4; nn >= 16; nn /= 2) {
+            const int32_t halfnn = nn / 2;
+            cur_tt += 2 * nn;
+            for (int32_t block = 0; block < ns4; block += nn) {
+                for (int32_t off = 0; off < halfnn; off += 8) {
+                    __m512d cs, sn;
+                    load_trig8(cs, sn, cur_tt + 2 * off);
+                    for (int32_t m = 0; m < M; m++) {
+                        double *d00 = data[m] + block + off;
+                        double *d01 = d00 + ns4;
+                        double *d10 = d00 + halfnn;
+                        double *d11 = d01 + halfnn;
+                        const __m512d r0 = _mm512_loadu_pd(d00);
+                        const __m512d i0 = _mm512_loadu_pd(d01);
+                        const __m512d r1 = _mm512_loadu_pd(d10);
+                        const __m512d i1 = _mm512_loadu_pd(d11);
+                        const __m512d dre = _mm512_sub_pd(r0, r1);
+                        const __m512d dim = _mm512_sub_pd(i0, i1);
+                        _mm512_storeu_pd(d00, _mm512_add_pd(r0, r1));
+                        _mm512_storeu_pd(d01, _mm512_add_pd(i0, i1));
+                        _mm512_storeu_pd(d10, _mm512_fmsub_pd(dre, cs, _mm512_mul_pd(dim, sn)));
+                        _mm512_storeu_pd(d11, _mm512_fmadd_pd(dre, sn, _mm512_mul_pd(dim, cs)));
+                    }
+                }
+            }
+        }
+
+        //size 8: the lower half of the cosines and sines is (1,0), so only the upper half is rotated
+        {
+            cur_tt += 16;
+            const __m512d cs = _mm512_mask_broadcast_f64x4(_mm512_set1_pd(1), 0xF0, _mm256_loadu_pd(cur_tt));
+            const __m512d sn = _mm512_maskz_broadcast_f64x4(0xF0, _mm256_loadu_pd(cur_tt + 4));
+            const __m512d sgn = _mm512_setr_pd(1, 1, 1, 1, -1, -1, -1, -1);
+            for (int32_t block = 0; block < ns4; block += 8) {
+                for (int32_t m = 0; m < M; m++) {
+                    double *are = data[m] + block;
+                    double *aim = are + ns4;
+                    const __m512d r = _mm512_loadu_pd(are);
+                    const __m512d i = _mm512_loadu_pd(aim);
+                    const __m512d sre = _mm512_fmadd_pd(_mm512_shuffle_f64x2(r, r, 0xEE), sgn,
+                                                        _mm512_shuffle_f64x2(r, r, 0x44));
+                    const __m512d sim = _mm512_fmadd_pd(_mm512_shuffle_f64x2(i, i, 0xEE), sgn,
+                                                        _mm512_shuffle_f64x2(i, i, 0x44));
+                    _mm512_storeu_pd(are, _mm512_fmsub_pd(sre, cs, _mm512_mul_pd(sim, sn)));
+                    _mm512_storeu_pd(aim, _mm512_fmadd_pd(sre, sn, _mm512_mul_pd(sim, cs)));
+                }
+            }
+        }
+
+        //size 4
+        // r0 + r2    i0 + i2
+        // r1 + r3    i1 + i3
+        // r0 - r2    i0 - i2
+        // i3 - i1    r1 - r3
+        {
+            const __m512d sgn0 = signs(1, 1, 1, -1);
+            const __m512d sgn1 = signs(1, 1, -1, 1);
+            const __m512d sgn3 = signs(1, 1, -1, -1);
+            for (int32_t block = 0; block < ns4; block += 8) {
+                for (int32_t m = 0; m < M; m++) {
+                    double *are = data[m] + block;
+                    double *aim = are + ns4;
+                    const __m512d r = _mm512_loadu_pd(are);
+                    const __m512d i = _mm512_loadu_pd(aim);
+                    const __m512d r01 = _mm512_permutex_pd(r, 0x44);
+                    const __m512d r23 = _mm512_permutex_pd(r, 0xEE);
+                    const __m512d i01 = _mm512_permutex_pd(i, 0x44);
+                    const __m512d i23 = _mm512_permutex_pd(i, 0xEE);
+                    const __m512d t0 = _mm512_mul_pd(_mm512_mask_blend_pd(0x88, r01, i01), sgn0);
+                    _mm512_storeu_pd(are, _mm512_fmadd_pd(_mm512_mask_blend_pd(0x88, r23, i23), sgn1, t0));
+                    _mm512_storeu_pd(aim, _mm512_fmadd_pd(_mm512_mask_blend_pd(0x88, i23, r23), sgn3,
+                                                          _mm512_mask_blend_pd(0x88, i01, r01)));
+                }
+            }
+        }
+
+        butterfly2<M>(data, ns4);
+    }
+
+}
+
+
+AVX512_KERNEL void fft_avx512(const void *tables, double *data) {
+    double *const d[1] = {data};
+    fft_avx512_m<1>(tables, d);
+}
+
+AVX512_KERNEL void ifft_avx512(const void *tables, double *data) {
+    double *const d[1] = {data};
+    ifft_avx512_m<1>(tables, d);
+}
+
+
+// the Lagrange polynomials hold Ns2 real parts followed by Ns2 imaginary parts
+AVX512_KERNEL void LagrangeHalfCPolynomialMul_avx512(LagrangeHalfCPolynomial *result, const LagrangeHalfCPolynomial *a,
+                                                     const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
+    const int32_t Ns2 = result1->proc->Ns2;
+    double *rr = result1->coefsC;
+    double *ri = rr + Ns2;
+    const double *ar = ((const LagrangeHalfCPolynomial_IMPL *) a)->coefsC;
+    const double *ai = ar + Ns2;
+    const double *br = ((const LagrangeHalfCPolynomial_IMPL *) b)->coefsC;
+    const double *bi = br + Ns2;
+    for (int32_t i = 0; i < Ns2; i += 8) {
+        const __m512d xr = _mm512_loadu_pd(ar + i);
+        const __m512d xi = _mm512_loadu_pd(ai + i);
+        const __m512d yr = _mm512_loadu_pd(br + i);
+        const __m512d yi = _mm512_loadu_pd(bi + i);
+        _mm512_storeu_pd(rr + i, _mm512_fmsub_pd(xr, yr, _mm512_mul_pd(xi, yi)));
+        _mm512_storeu_pd(ri + i, _mm512_fmadd_pd(xr, yi, _mm512_mul_pd(xi, yr)));
+    }
+}
+
+AVX512_KERNEL void LagrangeHalfCPolynomialAddMul_avx512(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                                        const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomial_IMPL *accum1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const int32_t Ns2 = accum1->proc->Ns2;
+    double *rr = accum1->coefsC;
+    double *ri = rr + Ns2;
+    const double *ar = ((const LagrangeHalfCPolynomial_IMPL *) a)->coefsC;
+    const double *ai = ar + Ns2;
+    const double *br = ((const LagrangeHalfCPolynomial_IMPL *) b)->coefsC;
+    const double *bi = br + Ns2;
+    for (int32_t i = 0; i < Ns2; i += 8) {
+        const __m512d xr = _mm512_loadu_pd(ar + i);
+        const __m512d xi = _mm512_loadu_pd(ai + i);
+        const __m512d yr = _mm512_loadu_pd(br + i);
+        const __m512d yi = _mm512_loadu_pd(bi + i);
+        const __m512d re = _mm512_fmadd_pd(xr, yr, _mm512_loadu_pd(rr + i));
+        const __m512d im = _mm512_fmadd_pd(xr, yi, _mm512_loadu_pd(ri + i));
+        _mm512_storeu_pd(rr + i, _mm512_fnmadd_pd(xi, yi, re));
+        _mm512_storeu_pd(ri + i, _mm512_fmadd_pd(xi, yr, im));
+    }
+}
+
+AVX512_KERNEL void LagrangeHalfCPolynomialSubMul_avx512(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                                        const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomial_IMPL *accum1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const int32_t Ns2 = accum1->proc->Ns2;
+    double *rr = accum1->coefsC;
+    double *ri = rr + Ns2;
+    const double *ar = ((const LagrangeHalfCPolynomial_IMPL *) a)->coefsC;
+    const double *ai = ar + Ns2;
+    const double *br = ((const LagrangeHalfCPolynomial_IMPL *) b)->coefsC;
+    const double *bi = br + Ns2;
+    for (int32_t i = 0; i < Ns2; i += 8) {
+        const __m512d xr = _mm512_loadu_pd(ar + i);
+        const __m512d xi = _mm512_loadu_pd(ai + i);
+        const __m512d yr = _mm512_loadu_pd(br + i);
+        const __m512d yi = _mm512_loadu_pd(bi + i);
+        const __m512d re = _mm512_fnmadd_pd(xr, yr, _mm512_loadu_pd(rr + i));
+        const __m512d im = _mm512_fnmadd_pd(xr, yi, _mm512_loadu_pd(ri + i));
+        _mm512_storeu_pd(rr + i, _mm512_fmadd_pd(xi, yi, re));
+        _mm512_storeu_pd(ri + i, _mm512_fnmadd_pd(xi, yr, im));
+    }
+}
+
+AVX512_KERNEL void LagrangeHalfCPolynomialAddTo_avx512(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a) {
+    LagrangeHalfCPolynomial_IMPL *accum1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const int32_t N = accum1->proc->N;
+    double *rr = accum1->coefsC;
+    const double *ar = ((const LagrangeHalfCPolynomial_IMPL *) a)->coefsC;
+    for (int32_t i = 0; i < N; i += 8) {
+        _mm512_storeu_pd(rr + i, _mm512_add_pd(_mm512_loadu_pd(rr + i), _mm512_loadu_pd(ar + i)));
+    }
+}
+
+
+namespace {
+
+    AVX512_KERNEL inline void int32_to_double(double *res, const int32_t *a, int32_t N) {
+        for (int32_t i = 0; i < N; i += 8) {
+            const __m256i x = _mm256_loadu_si256((const __m256i *) (a + i));
+            _mm512_storeu_pd(res + i, _mm512_cvtepi32_pd(x));
+        }
+    }
+
+    AVX512_KERNEL inline void scale_double(double *res, const double *a, int32_t N) {
+        const __m512d _2sN = _mm512_set1_pd(double(2) / double(N));
+        for (int32_t i = 0; i < N; i += 8) {
+            _mm512_storeu_pd(res + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), _2sN));
+        }
+    }
+
+    // Torus32(int64_t(x)) without the AVX512DQ conversions: t = trunc(x) is split exactly as
+    // q*2^32 + r with 0 <= r < 2^32, and r converts to the same 32 bits as int64_t(x)
+    AVX512_KERNEL inline void double_to_torus32(Torus32 *res, const double *a, int32_t N) {
+        const __m512d _2p32 = _mm512_set1_pd(4294967296.);
+        const __m512d _2m32 = _mm512_set1_pd(1. / 4294967296.);
+        for (int32_t i = 0; i < N; i += 8) {
+            const __m512d t = _mm512_roundscale_pd(_mm512_loadu_pd(a + i), _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+            const __m512d q = _mm512_roundscale_pd(_mm512_mul_pd(t, _2m32), _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+            const __m512d r = _mm512_fnmadd_pd(q, _2p32, t);
+            _mm256_storeu_si256((__m256i *) (res + i), _mm512_cvttpd_epu32(r));
+        }
+    }
+
+    // 16 signed digits ((a+offset)>>decal)&maskMod - halfBg, as two vectors of doubles
+    AVX512_KERNEL inline void digit16(__m512d &lo, __m512d &hi, const __m512i x, const __m128i decal,
+                                      const __m512i maskMod, const __m512i halfBg) {
+        const __m512i d = _mm512_sub_epi32(_mm512_and_si512(_mm512_srl_epi32(x, decal), maskMod), halfBg);
+        lo = _mm512_cvtepi32_pd(_mm512_castsi512_si256(d));
+        hi = _mm512_cvtepi32_pd(_mm512_extracti64x4_epi64(d, 1));
+    }
+
+}
+
+// the AVX-512 kernels accept unaligned data: the reverse FFT runs in place in the result
+AVX512_KERNEL void FFT_Processor_Spqlios::execute_reverse_int_avx512(double *res, const int32_t *a) {
+    double *const d[1] = {res};
+    int32_to_double(res, a, N);
+    ifft_avx512_m<1>(tables_reverse, d);
+}
+
+AVX512_KERNEL void FFT_Processor_Spqlios::execute_direct_torus32_avx512(Torus32 *res, const double *a) {
+    double *const d[1] = {real_inout_direct};
+    scale_double(real_inout_direct, a, N);
+    fft_avx512_m<1>(tables_direct, d);
+    double_to_torus32(res, real_inout_direct, N);
+}
+
+AVX512_KERNEL void FFT_Processor_Spqlios::execute_reverse_int2_avx512(double *res0, double *res1,
+                                                                      const int32_t *a0, const int32_t *a1) {
+    double *const d[2] = {res0, res1};
+    int32_to_double(res0, a0, N);
+    int32_to_double(res1, a1, N);
+    ifft_avx512_m<2>(tables_reverse, d);
+}
+
+AVX512_KERNEL void FFT_Processor_Spqlios::execute_direct_torus32_2_avx512(Torus32 *res0, Torus32 *res1,
+                                                                          const double *a0, const double *a1) {
+    double *const d[2] = {real_inout_direct, batch_direct};
+    scale_double(real_inout_direct, a0, N);
+    scale_double(batch_direct, a1, N);
+    fft_avx512_m<2>(tables_direct, d);
+    double_to_torus32(res0, real_inout_direct, N);
+    double_to_torus32(res1, batch_direct, N);
+}
+
+AVX512_KERNEL void FFT_Processor_Spqlios::execute_reverse_digit_avx512(double *res, const Torus32 *a,
+                                                                       const int32_t decal, const uint32_t maskMod,
+                                                                       const int32_t halfBg, const uint32_t offset) {
+    double *const d[1] = {res};
+    const __m512i voffset = _mm512_set1_epi32(offset);
+    const __m512i vmask = _mm512_set1_epi32(maskMod);
+    const __m512i vhalf = _mm512_set1_epi32(halfBg);
+    const __m128i vdecal = _mm_cvtsi32_si128(decal);
+    for (int32_t i = 0; i < N; i += 16) {
+        const __m512i x = _mm512_add_epi32(_mm512_loadu_si512((const void *) (a + i)), voffset);
+        __m512d lo, hi;
+        digit16(lo, hi, x, vdecal, vmask, vhalf);
+        _mm512_storeu_pd(res + i, lo);
+        _mm512_storeu_pd(res + i + 8, hi);
+    }
+    ifft_avx512_m<1>(tables_reverse, d);
+}
+
+AVX512_KERNEL void FFT_Processor_Spqlios::execute_reverse_digit2_avx512(double *res0, double *res1, const Torus32 *a,
+                                                                        const int32_t decal, const int32_t Bgbit,
+                                                                        const uint32_t maskMod, const int32_t halfBg,
+                                                                        const uint32_t offset) {
+    double *const d[2] = {res0, res1};
+    const __m512i voffset = _mm512_set1_epi32(offset);
+    const __m512i vmask = _mm512_set1_epi32(maskMod);
+    const __m512i vhalf = _mm512_set1_epi32(halfBg);
+    const __m128i vdecal0 = _mm_cvtsi32_si128(decal);
+    const __m128i vdecal1 = _mm_cvtsi32_si128(decal - Bgbit);
+    for (int32_t i = 0; i < N; i += 16) {
+        const __m512i x = _mm512_add_epi32(_mm512_loadu_si512((const void *) (a + i)), voffset);
+        __m512d lo, hi;
+        digit16(lo, hi, x, vdecal0, vmask, vhalf);
+        _mm512_storeu_pd(res0 + i, lo);
+        _mm512_storeu_pd(res0 + i + 8, hi);
+        digit16(lo, hi, x, vdecal1, vmask, vhalf);
+        _mm512_storeu_pd(res1 + i, lo);
+        _mm512_storeu_pd(res1 + i + 8, hi);
+    }
+    ifft_avx512_m<2>(tables_reverse, d);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
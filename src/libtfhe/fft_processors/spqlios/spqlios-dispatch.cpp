@@ -0,0 +1,166 @@
+#include "lagrangehalfc_impl.h"
+#include "spqlios-fft.h"
+#include "tfhe_cpu_dispatch.h"
+
+using namespace std;
+
+/*
+ * Load-time selection of the spqlios kernels (dispatch build only).
+ * The assembly files are assembled twice through the spqlios-dispatch-*.S wrappers,
+ * which suffix their symbols with _avx and _fma. The _avx512 kernels are in spqlios-avx512.cpp.
+ */
+
+extern "C" {
+void fft_avx(const void *tables, double *data);
+void ifft_avx(const void *tables, double *data);
+void fft_fma(const void *tables, double *data);
+void ifft_fma(const void *tables, double *data);
+void LagrangeHalfCPolynomialMul_avx(LagrangeHalfCPolynomial *result, const LagrangeHalfCPolynomial *a,
+                                    const LagrangeHalfCPolynomial *b);
+void LagrangeHalfCPolynomialAddMul_avx(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                       const LagrangeHalfCPolynomial *b);
+void LagrangeHalfCPolynomialSubMul_avx(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                       const LagrangeHalfCPolynomial *b);
+void LagrangeHalfCPolynomialMul_fma(LagrangeHalfCPolynomial *result, const LagrangeHalfCPolynomial *a,
+                                    const LagrangeHalfCPolynomial *b);
+void LagrangeHalfCPolynomialAddMul_fma(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                       const LagrangeHalfCPolynomial *b);
+void LagrangeHalfCPolynomialSubMul_fma(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                       const LagrangeHalfCPolynomial *b);
+}
+
+// the models work in place in the buffer of the tables, which is where the processor puts the data
+static void fft_portable(const void *tables, double *data) {
+    assert(data == fft_table_get_buffer(tables));
+    fft_model(tables);
+}
+
+static void ifft_portable(const void *tables, double *data) {
+    assert(data == ifft_table_get_buffer(tables));
+    ifft_model((void *) tables);
+}
+
+// the Lagrange polynomials hold Ns2 real parts followed by Ns2 imaginary parts
+static void LagrangeHalfCPolynomialMul_portable(LagrangeHalfCPolynomial *result, const LagrangeHalfCPolynomial *a,
+                                                const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomial_IMPL *result1 = (LagrangeHalfCPolynomial_IMPL *) result;
+    const int32_t Ns2 = result1->proc->Ns2;
+    double *rr = result1->coefsC;
+    double *ri = rr + Ns2;
+    const double *ar = ((const LagrangeHalfCPolynomial_IMPL *) a)->coefsC;
+    const double *ai = ar + Ns2;
+    const double *br = ((const LagrangeHalfCPolynomial_IMPL *) b)->coefsC;
+    const double *bi = br + Ns2;
+    for (int32_t i = 0; i < Ns2; i++) {
+        const double re = ar[i] * br[i] - ai[i] * bi[i];
+        const double im = ar[i] * bi[i] + ai[i] * br[i];
+        rr[i] = re;
+        ri[i] = im;
+    }
+}
+
+static void LagrangeHalfCPolynomialAddMul_portable(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                                   const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomial_IMPL *accum1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const int32_t Ns2 = accum1->proc->Ns2;
+    double *rr = accum1->coefsC;
+    double *ri = rr + Ns2;
+    const double *ar = ((const LagrangeHalfCPolynomial_IMPL *) a)->coefsC;
+    const double *ai = ar + Ns2;
+    const double *br = ((const LagrangeHalfCPolynomial_IMPL *) b)->coefsC;
+    const double *bi = br + Ns2;
+    for (int32_t i = 0; i < Ns2; i++) {
+        rr[i] += ar[i] * br[i] - ai[i] * bi[i];
+        ri[i] += ar[i] * bi[i] + ai[i] * br[i];
+    }
+}
+
+static void LagrangeHalfCPolynomialSubMul_portable(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                                   const LagrangeHalfCPolynomial *b) {
+    LagrangeHalfCPolynomial_IMPL *accum1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const int32_t Ns2 = accum1->proc->Ns2;
+    double *rr = accum1->coefsC;
+    double *ri = rr + Ns2;
+    const double *ar = ((const LagrangeHalfCPolynomial_IMPL *) a)->coefsC;
+    const double *ai = ar + Ns2;
+    const double *br = ((const LagrangeHalfCPolynomial_IMPL *) b)->coefsC;
+    const double *bi = br + Ns2;
+    for (int32_t i = 0; i < Ns2; i++) {
+        rr[i] -= ar[i] * br[i] - ai[i] * bi[i];
+        ri[i] -= ar[i] * bi[i] + ai[i] * br[i];
+    }
+}
+
+static void LagrangeHalfCPolynomialAddTo_portable(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a) {
+    LagrangeHalfCPolynomial_IMPL *accum1 = (LagrangeHalfCPolynomial_IMPL *) accum;
+    const int32_t N = accum1->proc->N;
+    double *rr = accum1->coefsC;
+    const double *ar = ((const LagrangeHalfCPolynomial_IMPL *) a)->coefsC;
+    for (int32_t i = 0; i < N; i++) {
+        rr[i] += ar[i];
+    }
+}
+
+static Spqlios_Kernels select_spqlios_kernels() {
+    Spqlios_Kernels reps;
+    const TfheCpuBackend backend = tfhe_cpu_backend();
+    reps.avx = (backend != TFHE_CPU_PORTABLE);
+    reps.avx2 = reps.avx && tfhe_cpu_features()->avx2;
+    reps.avx512 = (backend == TFHE_CPU_AVX512);
+    reps.addTo = LagrangeHalfCPolynomialAddTo_portable;
+    switch (backend) {
+        case TFHE_CPU_AVX512:
+            reps.fft = fft_avx512;
+            reps.ifft = ifft_avx512;
+            reps.mul = LagrangeHalfCPolynomialMul_avx512;
+            reps.addMul = LagrangeHalfCPolynomialAddMul_avx512;
+            reps.subMul = LagrangeHalfCPolynomialSubMul_avx512;
+            reps.addTo = LagrangeHalfCPolynomialAddTo_avx512;
+            break;
+        case TFHE_CPU_FMA:
+            reps.fft = fft_fma;
+            reps.ifft = ifft_fma;
+            reps.mul = LagrangeHalfCPolynomialMul_fma;
+            reps.addMul = LagrangeHalfCPolynomialAddMul_fma;
+            reps.subMul = LagrangeHalfCPolynomialSubMul_fma;
+            break;
+        case TFHE_CPU_AVX:
+            reps.fft = fft_avx;
+            reps.ifft = ifft_avx;
+            reps.mul = LagrangeHalfCPolynomialMul_avx;
+            reps.addMul = LagrangeHalfCPolynomialAddMul_avx;
+            reps.subMul = LagrangeHalfCPolynomialSubMul_avx;
+            break;
+        default:
+            reps.fft = fft_portable;
+            reps.ifft = ifft_portable;
+            reps.mul = LagrangeHalfCPolynomialMul_portable;
+            reps.addMul = LagrangeHalfCPolynomialAddMul_portable;
+            reps.subMul = LagrangeHalfCPolynomialSubMul_portable;
+    }
+    return reps;
+}
+
+const Spqlios_Kernels *spqlios_kernels() {
+    static const Spqlios_Kernels kernels = select_spqlios_kernels();
+    return &kernels;
+}
+
+// select the kernels once, when the library is loaded
+static const Spqlios_Kernels *const loaded_spqlios_kernels __attribute__((unused)) = spqlios_kernels();
+
+
+EXPORT void LagrangeHalfCPolynomialMul(LagrangeHalfCPolynomial *result, const LagrangeHalfCPolynomial *a,
+                                       const LagrangeHalfCPolynomial *b) {
+    spqlios_kernels()->mul(result, a, b);
+}
+
+EXPORT void LagrangeHalfCPolynomialAddMul(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                          const LagrangeHalfCPolynomial *b) {
+    spqlios_kernels()->addMul(accum, a, b);
+}
+
+EXPORT void LagrangeHalfCPolynomialSubMul(LagrangeHalfCPolynomial *accum, const LagrangeHalfCPolynomial *a,
+                                          const LagrangeHalfCPolynomial *b) {
+    spqlios_kernels()->subMul(accum, a, b);
+}
@@ -199,6 +199,19 @@ extern "C" double *ifft_table_get_buffer(const void *tables) {
     IFFT_PRECOMP *reps = (IFFT_PRECOMP *) tables;
     return reps->aligned_data;
 }
+//n is twice the degree of the polynomials
+extern "C" int32_t fft_table_get_size(const void *tables) {
+    return ((FFT_PRECOMP *) tables)->n;
+}
+extern "C" const double *fft_table_get_trig_tables(const void *tables) {
+    return ((FFT_PRECOMP *) tables)->aligned_trig_tables;
+}
+extern "C" int32_t ifft_table_get_size(const void *tables) {
+    return ((IFFT_PRECOMP *) tables)->n;
+}
+extern "C" const double *ifft_table_get_trig_tables(const void *tables) {
+    return ((IFFT_PRECOMP *) tables)->aligned_trig_tables;
+}
 
 //c has size n/2
 extern "C" void fft_model(const void *tables) {
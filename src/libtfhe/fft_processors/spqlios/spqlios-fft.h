@@ -9,6 +9,10 @@ void *new_fft_table(int32_t nn);
 double *fft_table_get_buffer(const void *tables);
 void *new_ifft_table(int32_t nn);
 double *ifft_table_get_buffer(const void *tables);
+int32_t fft_table_get_size(const void *tables);
+const double *fft_table_get_trig_tables(const void *tables);
+int32_t ifft_table_get_size(const void *tables);
+const double *ifft_table_get_trig_tables(const void *tables);
 void fft_model(const void *tables);
 void ifft_model(void *tables);
 void fft(const void *tables, double *data);
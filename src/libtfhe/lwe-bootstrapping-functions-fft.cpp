@@ -75,6 +75,14 @@ void tfhe_MuxRotate_FFT(TLweSample *result, const TLweSample *accum, const TGswS
     tLweAddTo(result, accum, bk_params->tlwe_params);
 }
 
+void tfhe_MuxRotate_FFT_ws(TLweSample *result, const TLweSample *accum, const TGswSampleFFT *bki, const int32_t barai,
+                           const TGswParams *bk_params, TfheBootstrapWorkspace *ws) {
+    // ACC = BKi*[(X^barai-1)*ACC]+ACC
+    tLweMulByXaiMinusOne(result, barai, accum, bk_params->tlwe_params);
+    tGswFFTExternMulToTLwe_ws(result, bki, bk_params, ws);
+    tLweAddTo(result, accum, bk_params->tlwe_params);
+}
+
 
 #if defined INCLUDE_ALL || defined INCLUDE_TFHE_BLIND_ROTATE_FFT
 #undef INCLUDE_TFHE_BLIND_ROTATE_FFT
@@ -110,6 +118,31 @@ EXPORT void tfhe_blindRotate_FFT(TLweSample *accum,
     delete_TLweSample(temp);
     //delete_TGswSampleFFT(temp);
 }
+
+/**
+ * same as tfhe_blindRotate_FFT, the temporaries are taken from ws
+ */
+EXPORT void tfhe_blindRotate_FFT_ws(TLweSample *accum,
+                                    const TGswSampleFFT *bkFFT,
+                                    const int32_t *bara,
+                                    const int32_t n,
+                                    const TGswParams *bk_params,
+                                    TfheBootstrapWorkspace *ws) {
+
+    TLweSample *temp2 = ws->temp;
+    TLweSample *temp3 = accum;
+
+    for (int32_t i = 0; i < n; i++) {
+        const int32_t barai = bara[i];
+        if (barai == 0) continue; //indeed, this is an easy case!
+
+        tfhe_MuxRotate_FFT_ws(temp2, temp3, bkFFT + i, barai, bk_params, ws);
+        swap(temp2, temp3);
+    }
+    if (temp3 != accum) {
+        tLweCopy(accum, temp3, bk_params->tlwe_params);
+    }
+}
 #endif
 
 
@@ -154,6 +187,36 @@ EXPORT void tfhe_blindRotateAndExtract_FFT(LweSample *result,
     delete_TLweSample(acc);
     delete_TorusPolynomial(testvectbis);
 }
+
+/**
+ * same as tfhe_blindRotateAndExtract_FFT, the temporaries are taken from ws
+ */
+EXPORT void tfhe_blindRotateAndExtract_FFT_ws(LweSample *result,
+                                              const TorusPolynomial *v,
+                                              const TGswSampleFFT *bk,
+                                              const int32_t barb,
+                                              const int32_t *bara,
+                                              const int32_t n,
+                                              const TGswParams *bk_params,
+                                              TfheBootstrapWorkspace *ws) {
+
+    const TLweParams *accum_params = bk_params->tlwe_params;
+    const LweParams *extract_params = &accum_params->extracted_lweparams;
+    const int32_t N = accum_params->N;
+    const int32_t _2N = 2 * N;
+
+    TorusPolynomial *testvectbis = ws->testvectbis;
+    TLweSample *acc = ws->acc;
+
+    // testvector = X^{2N-barb}*v
+    if (barb != 0) torusPolynomialMulByXai(testvectbis, _2N - barb, v);
+    else torusPolynomialCopy(testvectbis, v);
+    tLweNoiselessTrivial(acc, testvectbis, accum_params);
+    // Blind rotation
+    tfhe_blindRotate_FFT_ws(acc, bk, bara, n, bk_params, ws);
+    // Extraction
+    tLweExtractLweSample(result, acc, extract_params, accum_params);
+}
 #endif
 
 
@@ -171,6 +234,18 @@ EXPORT void tfhe_bootstrap_woKS_FFT(LweSample *result,
                                     Torus32 mu,
                                     const LweSample *x) {
 
+    tfhe_bootstrap_woKS_FFT_ws(result, bk, mu, x, tfhe_local_bootstrap_workspace(bk));
+}
+
+/**
+ * same as tfhe_bootstrap_woKS_FFT, the temporaries are taken from ws
+ */
+EXPORT void tfhe_bootstrap_woKS_FFT_ws(LweSample *result,
+                                       const LweBootstrappingKeyFFT *bk,
+                                       Torus32 mu,
+                                       const LweSample *x,
+                                       TfheBootstrapWorkspace *ws) {
+
     const TGswParams *bk_params = bk->bk_params;
     const TLweParams *accum_params = bk->accum_params;
     const LweParams *in_params = bk->in_out_params;
@@ -178,8 +253,8 @@ EXPORT void tfhe_bootstrap_woKS_FFT(LweSample *result,
     const int32_t Nx2 = 2 * N;
     const int32_t n = in_params->n;
 
-    TorusPolynomial *testvect = new_TorusPolynomial(N);
-    int32_t *bara = new int32_t[N];
+    TorusPolynomial *testvect = ws->testvect;
+    int32_t *bara = ws->bara;
 
 
     // Modulus switching
@@ -192,11 +267,7 @@ EXPORT void tfhe_bootstrap_woKS_FFT(LweSample *result,
     for (int32_t i = 0; i < N; i++) testvect->coefsT[i] = mu;
 
     // Bootstrapping rotation and extraction
-    tfhe_blindRotateAndExtract_FFT(result, testvect, bk->bkFFT, barb, bara, n, bk_params);
-
-
-    delete[] bara;
-    delete_TorusPolynomial(testvect);
+    tfhe_blindRotateAndExtract_FFT_ws(result, testvect, bk->bkFFT, barb, bara, n, bk_params, ws);
 }
 #endif
 
@@ -215,13 +286,233 @@ EXPORT void tfhe_bootstrap_FFT(LweSample *result,
                                Torus32 mu,
                                const LweSample *x) {
 
-    LweSample *u = new_LweSample(&bk->accum_params->extracted_lweparams);
+    tfhe_bootstrap_FFT_ws(result, bk, mu, x, tfhe_local_bootstrap_workspace(bk));
+}
+
+/**
+ * same as tfhe_bootstrap_FFT, the temporaries are taken from ws
+ */
+EXPORT void tfhe_bootstrap_FFT_ws(LweSample *result,
+                                  const LweBootstrappingKeyFFT *bk,
+                                  Torus32 mu,
+                                  const LweSample *x,
+                                  TfheBootstrapWorkspace *ws) {
 
-    tfhe_bootstrap_woKS_FFT(u, bk, mu, x);
+    LweSample *u = ws->u;
+
+    tfhe_bootstrap_woKS_FFT_ws(u, bk, mu, x, ws);
     // Key switching
     lweKeySwitch(result, bk->ks, u);
+}
+#endif
+
+
+#if defined INCLUDE_ALL || defined INCLUDE_TFHE_BOOTSTRAP_FFT_BATCH
+#undef INCLUDE_TFHE_BOOTSTRAP_FFT_BATCH
+/**
+ * result[s] = LWE(v_p) where p=barb[s]-sum(bara[s*n+i].s_i) mod 2N, for s < count
+ * The loop over the key is the outer one: each bk_i is loaded once for the whole batch.
+ * @param result count output LWE samples
+ * @param v a 2N-elt anticyclic function (represented by a TorusPolynomial)
+ * @param bk An array of n TGSW FFT samples where bk_i encodes s_i
+ * @param barb count coefficients between 0 and 2N-1
+ * @param bara count*n coefficients between 0 and 2N-1
+ * @param count number of samples (at most TFHE_BOOTSTRAP_BATCH_SIZE)
+ * @param bk_params The parameters of bk
+ * @param ws a workspace whose batch buffers are allocated
+ */
+EXPORT void tfhe_blindRotateAndExtract_FFT_batch_ws(LweSample *result,
+                                                    const TorusPolynomial *v,
+                                                    const TGswSampleFFT *bk,
+                                                    const int32_t *barb,
+                                                    const int32_t *bara,
+                                                    const int32_t n,
+                                                    const int32_t count,
+                                                    const TGswParams *bk_params,
+                                                    TfheBootstrapWorkspace *ws) {
+
+    const TLweParams *accum_params = bk_params->tlwe_params;
+    const LweParams *extract_params = &accum_params->extracted_lweparams;
+    const int32_t N = accum_params->N;
+    const int32_t _2N = 2 * N;
+    assert(count <= TFHE_BOOTSTRAP_BATCH_SIZE);
+
+    TLweSample **cur = ws->batch_rot;
+    TLweSample **spare = ws->batch_rot + TFHE_BOOTSTRAP_BATCH_SIZE;
+    for (int32_t s = 0; s < count; s++) {
+        cur[s] = ws->batch_acc + s;
+        spare[s] = ws->batch_temp + s;
+        // testvector = X^{2N-barb}*v
+        if (barb[s] != 0) torusPolynomialMulByXai(ws->testvectbis, _2N - barb[s], v);
+        else torusPolynomialCopy(ws->testvectbis, v);
+        tLweNoiselessTrivial(cur[s], ws->testvectbis, accum_params);
+    }
+    // Blind rotation
+    for (int32_t i = 0; i < n; i++) {
+        const TGswSampleFFT *bki = bk + i;
+        for (int32_t s = 0; s < count; s++) {
+            const int32_t barai = bara[s * n + i];
+            if (barai == 0) continue;
+
+            tfhe_MuxRotate_FFT_ws(spare[s], cur[s], bki, barai, bk_params, ws);
+            swap(spare[s], cur[s]);
+        }
+    }
+    // Extraction
+    for (int32_t s = 0; s < count; s++)
+        tLweExtractLweSample(result + s, cur[s], extract_params, accum_params);
+}
+
+/**
+ * result[s] = LWE(mu) iff phase(x[s])>0, LWE(-mu) iff phase(x[s])<0, for s < count
+ * (without key switching: result holds extracted samples)
+ */
+EXPORT void tfhe_bootstrap_woKS_FFT_batch_ws(LweSample *result,
+                                             const LweBootstrappingKeyFFT *bk,
+                                             Torus32 mu,
+                                             const LweSample *x,
+                                             const int32_t count,
+                                             TfheBootstrapWorkspace *ws) {
+
+    const TGswParams *bk_params = bk->bk_params;
+    const TLweParams *accum_params = bk->accum_params;
+    const LweParams *in_params = bk->in_out_params;
+    const int32_t N = accum_params->N;
+    const int32_t Nx2 = 2 * N;
+    const int32_t n = in_params->n;
+
+    // Modulus switching
+    for (int32_t s = 0; s < count; s++) {
+        ws->batch_barb[s] = modSwitchFromTorus32(x[s].b, Nx2);
+        for (int32_t i = 0; i < n; i++) {
+            ws->batch_bara[s * n + i] = modSwitchFromTorus32(x[s].a[i], Nx2);
+        }
+    }
+
+    // the initial testvec = [mu,mu,mu,...,mu]
+    for (int32_t i = 0; i < N; i++) ws->testvect->coefsT[i] = mu;
+
+    // Bootstrapping rotation and extraction
+    tfhe_blindRotateAndExtract_FFT_batch_ws(result, ws->testvect, bk->bkFFT, ws->batch_barb, ws->batch_bara, n, count,
+                                            bk_params, ws);
+}
+
+/**
+ * result[s] = LWE(mu) iff phase(x[s])>0, LWE(-mu) iff phase(x[s])<0, for s < count
+ */
+EXPORT void tfhe_bootstrap_FFT_batch_ws(LweSample *result,
+                                        const LweBootstrappingKeyFFT *bk,
+                                        Torus32 mu,
+                                        const LweSample *x,
+                                        const int32_t count,
+                                        TfheBootstrapWorkspace *ws) {
+
+    tfhe_bootstrap_woKS_FFT_batch_ws(ws->batch_u, bk, mu, x, count, ws);
+    // Key switching
+    for (int32_t s = 0; s < count; s++)
+        lweKeySwitch(result + s, bk->ks, ws->batch_u + s);
+}
+#endif
+
+
+#if defined INCLUDE_ALL || defined INCLUDE_TFHE_BOOTSTRAP_WORKSPACE
+#undef INCLUDE_TFHE_BOOTSTRAP_WORKSPACE
+//allocates and initialize a TfheBootstrapWorkspace sized for bk
+//(equivalent of the C++ new)
+EXPORT TfheBootstrapWorkspace *new_TfheBootstrapWorkspace(const LweBootstrappingKeyFFT *bk) {
+    const LweParams *in_out_params = bk->in_out_params;
+    const TGswParams *bk_params = bk->bk_params;
+    const TLweParams *accum_params = bk->accum_params;
+    const LweParams *extract_params = &accum_params->extracted_lweparams;
+    const int32_t n = in_out_params->n;
+    const int32_t N = accum_params->N;
+    const int32_t kpl = bk_params->kpl;
+
+    return new TfheBootstrapWorkspace(n, N, accum_params->k, bk_params->l,
+                                      new_IntPolynomial_array(kpl, N),
+                                      new_LagrangeHalfCPolynomial_array(kpl, N),
+                                      new_TLweSampleFFT(accum_params),
+                                      new_TLweSample(accum_params),
+                                      new_TLweSample(accum_params),
+                                      new_TorusPolynomial(N),
+                                      new_TorusPolynomial(N),
+                                      new int32_t[n],
+                                      new_LweSample(extract_params),
+                                      new_LweSample(in_out_params),
+                                      new_LweSample(extract_params),
+                                      new_LweSample(extract_params),
+                                      new_LweSample(extract_params));
+}
+
+//destroys and frees the TfheBootstrapWorkspace structure
+//(equivalent of the C++ delete)
+EXPORT void delete_TfheBootstrapWorkspace(TfheBootstrapWorkspace *obj) {
+    const int32_t kpl = (obj->k + 1) * obj->l;
+    if (obj->batch_acc) {
+        delete_LweSample_array(TFHE_BOOTSTRAP_BATCH_SIZE, obj->batch_in);
+        delete_LweSample_array(TFHE_BOOTSTRAP_BATCH_SIZE, obj->batch_u2);
+        delete_LweSample_array(TFHE_BOOTSTRAP_BATCH_SIZE, obj->batch_u);
+        delete[] obj->batch_bara;
+        delete[] obj->batch_barb;
+        delete[] obj->batch_rot;
+        delete_TLweSample_array(TFHE_BOOTSTRAP_BATCH_SIZE, obj->batch_temp);
+        delete_TLweSample_array(TFHE_BOOTSTRAP_BATCH_SIZE, obj->batch_acc);
+    }
+    delete_LweSample(obj->gate_sum);
+    delete_LweSample(obj->gate_u2);
+    delete_LweSample(obj->gate_u1);
+    delete_LweSample(obj->gate_in);
+    delete_LweSample(obj->u);
+    delete[] obj->bara;
+    delete_TorusPolynomial(obj->testvectbis);
+    delete_TorusPolynomial(obj->testvect);
+    delete_TLweSample(obj->temp);
+    delete_TLweSample(obj->acc);
+    delete_TLweSampleFFT(obj->tmpa);
+    delete_LagrangeHalfCPolynomial_array(kpl, obj->decaFFT);
+    delete_IntPolynomial_array(kpl, obj->deca);
+    delete obj;
+}
+
+//workspace of the calling thread: allocated on the first bootstrapping, and
+//reallocated only when a key with other dimensions comes in
+EXPORT TfheBootstrapWorkspace *tfhe_local_bootstrap_workspace(const LweBootstrappingKeyFFT *bk) {
+    struct LocalWorkspace {
+        TfheBootstrapWorkspace *ws;
+
+        LocalWorkspace() : ws(0) {}
+
+        ~LocalWorkspace() { if (ws) delete_TfheBootstrapWorkspace(ws); }
+    };
+    static thread_local LocalWorkspace local;
+
+    TfheBootstrapWorkspace *ws = local.ws;
+    if (ws == 0 ||
+        ws->n != bk->in_out_params->n ||
+        ws->N != bk->accum_params->N ||
+        ws->k != bk->accum_params->k ||
+        ws->l != bk->bk_params->l) {
+        if (ws) delete_TfheBootstrapWorkspace(ws);
+        ws = local.ws = new_TfheBootstrapWorkspace(bk);
+    }
+    return ws;
+}
+
+//allocates the batch_* buffers of ws (does nothing if they already exist)
+EXPORT void tfhe_reserve_bootstrap_workspace_batch(TfheBootstrapWorkspace *ws, const LweBootstrappingKeyFFT *bk) {
+    if (ws->batch_acc) return;
+    const int32_t B = TFHE_BOOTSTRAP_BATCH_SIZE;
+    const TLweParams *accum_params = bk->accum_params;
+    const LweParams *extract_params = &accum_params->extracted_lweparams;
 
-    delete_LweSample(u);
+    ws->batch_acc = new_TLweSample_array(B, accum_params);
+    ws->batch_temp = new_TLweSample_array(B, accum_params);
+    ws->batch_rot = new TLweSample *[2 * B];
+    ws->batch_barb = new int32_t[B];
+    ws->batch_bara = new int32_t[B * ws->n];
+    ws->batch_u = new_LweSample_array(B, extract_params);
+    ws->batch_u2 = new_LweSample_array(B, extract_params);
+    ws->batch_in = new_LweSample_array(B, bk->in_out_params);
 }
 #endif
 
@@ -69,7 +69,19 @@ LweBootstrappingKeyFFT::~LweBootstrappingKeyFFT() {}
  
 
 
-
-
-
-
+TfheBootstrapWorkspace::TfheBootstrapWorkspace(int32_t n, int32_t N, int32_t k, int32_t l,
+    IntPolynomial* deca, LagrangeHalfCPolynomial* decaFFT, TLweSampleFFT* tmpa,
+    TLweSample* acc, TLweSample* temp,
+    TorusPolynomial* testvect, TorusPolynomial* testvectbis, int32_t* bara,
+    LweSample* u, LweSample* gate_in,
+    LweSample* gate_u1, LweSample* gate_u2, LweSample* gate_sum): n(n), N(N), k(k), l(l),
+    deca(deca), decaFFT(decaFFT), tmpa(tmpa),
+    acc(acc), temp(temp),
+    testvect(testvect), testvectbis(testvectbis), bara(bara),
+    u(u), gate_in(gate_in),
+    gate_u1(gate_u1), gate_u2(gate_u2), gate_sum(gate_sum),
+    batch_acc(0), batch_temp(0), batch_rot(0), batch_barb(0), batch_bara(0),
+    batch_u(0), batch_u2(0), batch_in(0) {}
+
+
+TfheBootstrapWorkspace::~TfheBootstrapWorkspace() {}
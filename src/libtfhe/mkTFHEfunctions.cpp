@@ -13,6 +13,7 @@
 #include "tlwe_functions.h"
 #include "polynomials_arithmetic.h"
 #include "lagrangehalfc_arithmetic.h"
+#include "tfhe_cpu_dispatch.h"
 
 
 
@@ -21,6 +22,8 @@
 #include "mkTFHEkeys.h"
 #include "mkTFHEsamples.h"
 #include "mkTFHEfunctions.h"
+#include "mkTFHEnoise.h"
+#include "mk_engine.h"
 
 
 using namespace std;
@@ -371,6 +374,7 @@ EXPORT void MKtLweMulByXaiMinusOne(MKTLweSample *result, int32_t ai, const MKTLw
     {
         torusPolynomialMulByXaiMinusOne(&result->a[i], ai, &ACC->a[i]);
     }
+    result->current_variance = 2 * ACC->current_variance;
 }
 
 
@@ -417,6 +421,7 @@ EXPORT void MKtLweExtractMKLweSampleIndex(MKLweSample* result, const MKTLweSampl
     }
 
     result->b = x->b->coefsT[index];
+    result->current_variance = x->current_variance;
 }
 // extract index 0
 EXPORT void MKtLweExtractMKLweSample(MKLweSample* result, const MKTLweSample* x, const MKTFHEParams* MKparams) {
@@ -522,122 +527,24 @@ EXPORT void MKtGswTorus32PolynomialDecompGassembly(IntPolynomial *result, const
     const int32_t Bgbit = params->Bgbit;
     uint32_t *buf = (uint32_t *) sample->coefsT;
 
-//#define __AVX2__ //(to test)
-#ifndef __AVX2__
-    const uint32_t maskMod = params->maskMod;
-    const int32_t halfBg = params->halfBg;
-    const uint32_t offset = params->offset;
-#else
-    const uint32_t* maskMod_addr = &params->maskMod;
-    const int32_t* halfBg_addr = &params->halfBg;
-    const uint32_t* offset_addr = &params->offset;
-#endif
-
-
-
-
-
-    //First, add offset to everyone
-#ifndef __AVX2__
-    for (int32_t j = 0; j < N; ++j) buf[j] += offset;
+    // same kernels as tGswTorus32PolynomialDecompH
+#if defined TFHE_CPU_DISPATCH
+    tfhe_cpu_kernels()->torus32PolynomialDecomp(result, buf, N, dg, Bgbit, params->maskMod, params->halfBg, params->offset);
+#elif defined __AVX2__
+    torus32PolynomialDecomp_avx2(result, buf, N, dg, Bgbit, params->maskMod, params->halfBg, params->offset);
 #else
-    {
-    const uint32_t* sit = buf;
-    const uint32_t* send = buf+N;
-    __asm__ __volatile__ (
-        "vpbroadcastd (%2),%%ymm0\n"
-        "0:\n"
-        "vmovdqu (%0),%%ymm3\n"
-        "vpaddd %%ymm0,%%ymm3,%%ymm3\n" // add offset
-        "vmovdqu %%ymm3,(%0)\n"
-        "addq $32,%0\n"
-        "cmpq %1,%0\n"
-        "jb 0b\n"
-        : "=r"(sit),"=r"(send),"=r"(offset_addr)
-        :  "0"(sit), "1"(send), "2"(offset_addr)
-        : "%ymm0","%ymm3","memory"
-        );
-    }
+    torus32PolynomialDecomp_portable(result, buf, N, dg, Bgbit, params->maskMod, params->halfBg, params->offset);
 #endif
+}
 
 
 
-
-
-    //then, do the decomposition (in parallel)
-    for (int32_t p = 0; p < dg; ++p) {
-        const int32_t decal = (32 - (p + 1) * Bgbit);
-
-#ifndef __AVX2__
-        int32_t *res_p = result[p].coefs;
-        for (int32_t j = 0; j < N; ++j) {
-            uint32_t temp1 = (buf[j] >> decal) & maskMod;
-            res_p[j] = temp1 - halfBg;
-        }
-#else
-        int32_t* dst = result[p].coefs;
-        const uint32_t* sit = buf;
-        const uint32_t* send = buf+N;
-        const int32_t* decal_addr = &decal;
-        __asm__ __volatile__ (
-            "vpbroadcastd (%4),%%ymm0\n"
-            "vpbroadcastd (%5),%%ymm1\n"
-            "vmovd (%3),%%xmm2\n"
-            "1:\n"
-            "vmovdqu (%1),%%ymm3\n"
-            "VPSRLD %%xmm2,%%ymm3,%%ymm3\n" // shift by decal
-            "VPAND %%ymm1,%%ymm3,%%ymm3\n"  // and maskMod
-            "VPSUBD %%ymm0,%%ymm3,%%ymm3\n" // sub halfBg
-            "vmovdqu %%ymm3,(%0)\n"
-            "addq $32,%0\n"
-            "addq $32,%1\n"
-            "cmpq %2,%1\n"
-            "jb 1b\n"
-            : "=r"(dst),"=r"(sit),"=r"(send),"=r"(decal_addr),"=r"(halfBg_addr),"=r"(maskMod_addr)
-            :  "0"(dst), "1"(sit), "2"(send), "3"(decal_addr), "4"(halfBg_addr) ,"5"(maskMod_addr)
-            : "%ymm0","%ymm1","%ymm2","%ymm3","memory"
-            );
-        /* // verify that the assembly block was ok
-        int32_t* res_p = result[p].coefs;
-        for (int32_t j = 0; j < N; ++j)
-        {
-            uint32_t temp1 = (buf[j] >> decal) & maskMod;
-            if (res_p[j] != int32_t(temp1 - halfBg)) {
-            fprintf(stderr, "j=%d,buf[j]=%u,decal=%u,mask=%u,halfbg=%d,res_p[j]=%d\n",j,buf[j],decal,maskMod,halfBg,res_p[j]);
-            abort();
-            }
-        }*/
-#endif
-    }
-
-
-
-
-
-
-    //finally, remove offset to everyone
-#ifndef __AVX2__
-    for (int32_t j = 0; j < N; ++j) buf[j] -= offset;
-#else
-    {
-    const uint32_t* sit = buf;
-    const uint32_t* send = buf+N;
-    __asm__ __volatile__ (
-        "vpbroadcastd (%2),%%ymm0\n"
-        "2:\n"
-        "vmovdqu (%0),%%ymm3\n"
-        "vpsubd %%ymm0,%%ymm3,%%ymm3\n" // add offset
-        "vmovdqu %%ymm3,(%0)\n"
-        "addq $32,%0\n"
-        "cmpq %1,%0\n"
-        "jb 2b\n"
-        "vzeroall\n"
-        : "=r"(sit),"=r"(send),"=r"(offset_addr)
-        :  "0"(sit), "1"(send), "2"(offset_addr)
-        : "%ymm0","%ymm3","memory"
-        );
-    }
-#endif
+// same digits as MKtGswTorus32PolynomialDecompGassembly, written directly in the Lagrange space
+EXPORT void MKtGswTorus32PolynomialDecompGFFT(LagrangeHalfCPolynomial *resultFFT, const TorusPolynomial *sample, 
+        const MKTFHEParams *params)
+{
+    TorusPolynomial_decomp_ifft(resultFFT, sample, params->dg, params->Bgbit, params->maskMod, params->halfBg, 
+            params->offset);
 }
 
 
@@ -752,6 +659,7 @@ EXPORT void MKlweKeySwitch(MKLweSample* result, const LweKeySwitchKey* ks, const
             result->a[p*n +i] = temp->a[i]; 
         }        
     }
+    result->current_variance = MKvarianceKeySwitch(sample->current_variance, MKparams);
 
     /*
     for (int p = 0; p < parties; ++p)
@@ -1124,6 +1032,14 @@ EXPORT void MKTGswExpand_v2(MKTGswExpSample_v2 *result, const MKTGswUESample_v2
     TorusPolynomial* X = new_TorusPolynomial(N);
     TorusPolynomial* Y = new_TorusPolynomial(N);
     IntPolynomial* u = new_IntPolynomial_array(dg, N);
+    // f0 and f1 are multiplied (parties+1)*dg times each: transform them once
+    PreparedTorusPolynomial* f0FFT = new_PreparedTorusPolynomial_array(dg, N);
+    PreparedTorusPolynomial* f1FFT = new_PreparedTorusPolynomial_array(dg, N);
+    for (int l = 0; l < dg; ++l)
+    {
+        torusPolynomialPrepare(&f0FFT[l], &sample->f0[l]);
+        torusPolynomialPrepare(&f1FFT[l], &sample->f1[l]);
+    }
 
     // i < parties 
     for (int i = 0; i < parties; ++i) 
@@ -1136,13 +1052,10 @@ EXPORT void MKTGswExpand_v2(MKTGswExpSample_v2 *result, const MKTGswUESample_v2
             // X=0 and Y=0
             torusPolynomialClearN(X, N);
             torusPolynomialClearN(Y, N);
-            for (int l = 0; l < dg; ++l)
-            {
-                // X = x_i[j] = <g^{-1}(b_i[j]), f0>
-                torusPolynomialAddMulRFFTN(X, &u[l], &sample->f0[l], N);
-                // Y = y_i[j] = <g^{-1}(b_i[j]), f1> 
-                torusPolynomialAddMulRFFTN(Y, &u[l], &sample->f1[l], N);          
-            }
+            // X = x_i[j] = <g^{-1}(b_i[j]), f0>
+            torusPolynomialAddMulPreparedN(X, u, f0FFT, dg);
+            // Y = y_i[j] = <g^{-1}(b_i[j]), f1> 
+            torusPolynomialAddMulPreparedN(Y, u, f1FFT, dg);
             
             // x_i
             torusPolynomialAddTo1(&result->x[i*dg + j], X); // N = X->N
@@ -1160,13 +1073,10 @@ EXPORT void MKTGswExpand_v2(MKTGswExpSample_v2 *result, const MKTGswUESample_v2
         // X=0 and Y=0
         torusPolynomialClearN(X, N);
         torusPolynomialClearN(Y, N);
-        for (int l = 0; l < dg; ++l)
-        {
-            // X = x_i[j] = <g^{-1}(a[j]), f0>
-            torusPolynomialAddMulRFFTN(X, &u[l], &sample->f0[l], N);
-            // Y = y_i[j] = <g^{-1}(a[j]), f1> 
-            torusPolynomialAddMulRFFTN(Y, &u[l], &sample->f1[l], N);          
-        }
+        // X = x_i[j] = <g^{-1}(a[j]), f0>
+        torusPolynomialAddMulPreparedN(X, u, f0FFT, dg);
+        // Y = y_i[j] = <g^{-1}(a[j]), f1> 
+        torusPolynomialAddMulPreparedN(Y, u, f1FFT, dg);
         
         // x_i
         torusPolynomialSubTo1(&result->x[parties*dg + j], X); // N = X->N
@@ -1176,9 +1086,10 @@ EXPORT void MKTGswExpand_v2(MKTGswExpSample_v2 *result, const MKTGswUESample_v2
 
 
     result->party = sample->party;
-    // TODO: fix this
-    result->current_variance = sample->current_variance;
+    result->current_variance = MKvarianceExpand_v2(sample->current_variance, MKparams);
     
+    delete_PreparedTorusPolynomial_array(dg, f1FFT);
+    delete_PreparedTorusPolynomial_array(dg, f0FFT);
     delete_TorusPolynomial(X);
     delete_TorusPolynomial(Y);
     delete_IntPolynomial_array(dg, u);
@@ -1235,7 +1146,6 @@ EXPORT void MKTGswExpandFFT_v2(MKTGswExpSampleFFT_v2 *resultFFT, const MKTGswUES
 
     LagrangeHalfCPolynomial* X = new_LagrangeHalfCPolynomial(N);
     LagrangeHalfCPolynomial* Y = new_LagrangeHalfCPolynomial(N);
-    IntPolynomial* u = new_IntPolynomial_array(dg, N);
     LagrangeHalfCPolynomial *uFFT = new_LagrangeHalfCPolynomial_array(dg, N); //fft version
 
 
@@ -1245,10 +1155,7 @@ EXPORT void MKTGswExpandFFT_v2(MKTGswExpSampleFFT_v2 *resultFFT, const MKTGswUES
         for (int j = 0; j < dg; ++j)
         {
             // g^{-1}(b_i[j]) = [u_0, ...,u_dg-1] intPolynomials
-            MKtGswTorus32PolynomialDecompGassembly(u, &key->Pkey[i*dg + j], MKparams);
-            for (int p = 0; p < dg; ++p){
-                IntPolynomial_ifft(&uFFT[p], &u[p]); // FFT
-            }
+            MKtGswTorus32PolynomialDecompGFFT(uFFT, &key->Pkey[i*dg + j], MKparams); // FFT
 
             // X=0 and Y=0
             LagrangeHalfCPolynomialClear(X);
@@ -1274,10 +1181,7 @@ EXPORT void MKTGswExpandFFT_v2(MKTGswExpSampleFFT_v2 *resultFFT, const MKTGswUES
     for (int j = 0; j < dg; ++j)
     {
         // g^{-1}(a[j]) = [u_0, ...,u_dg-1] intPolynomials
-        MKtGswTorus32PolynomialDecompGassembly(u, &key->Pkey[parties*dg + j], MKparams);
-        for (int p = 0; p < dg; ++p){
-            IntPolynomial_ifft(&uFFT[p], &u[p]); // FFT
-        }
+        MKtGswTorus32PolynomialDecompGFFT(uFFT, &key->Pkey[parties*dg + j], MKparams); // FFT
 
         // X=0 and Y=0
         LagrangeHalfCPolynomialClear(X);
@@ -1304,14 +1208,12 @@ EXPORT void MKTGswExpandFFT_v2(MKTGswExpSampleFFT_v2 *resultFFT, const MKTGswUES
 
 
     resultFFT->party = sampleFFT->party;
-    // TODO: fix this
-    resultFFT->current_variance = sampleFFT->current_variance;
+    resultFFT->current_variance = MKvarianceExpand_v2(sampleFFT->current_variance, MKparams);
     
 
 
     // delete 
     delete_LagrangeHalfCPolynomial_array(dg, uFFT);
-    delete_IntPolynomial_array(dg, u);
     delete_LagrangeHalfCPolynomial(Y);
     delete_LagrangeHalfCPolynomial(X);
     delete_LagrangeHalfCPolynomial(tempFFT);
@@ -1365,15 +1267,20 @@ EXPORT void MKtGswUEExternMulToMKtLwe_v2m2(MKTLweSample* result, MKTLweSample* s
 
 
 
+    // d, f0, f1 are each multiplied parties+1 times: transform them once
+    // dFFT[0..dg) = d, dFFT[dg..2dg) = f0, dFFT[2dg..3dg) = f1
+    PreparedTorusPolynomial* dFFT = new_PreparedTorusPolynomial_array(3*dg, N);
+    for (int j = 0; j < 3*dg; ++j)
+    {
+        torusPolynomialPrepare(&dFFT[j], &sampleUE->d[j]);
+    }
+
     // u[i] = uDec[i] * d 
     TorusPolynomial* u = new_TorusPolynomial_array(parties+1, N);
     for (int i = 0; i <= parties; ++i)
     {
         torusPolynomialClearN(&u[i], N);
-        for (int j = 0; j < dg; ++j)
-        {
-            torusPolynomialAddMulRFFTN(&u[i], &uDec[i*dg+j], &sampleUE->d[j], N);
-        }
+        torusPolynomialAddMulPreparedN(&u[i], &uDec[i*dg], dFFT, dg);
     }
 
     // v[i] = uDec[i] * b_i, for i < parties  
@@ -1381,17 +1288,11 @@ EXPORT void MKtGswUEExternMulToMKtLwe_v2m2(MKTLweSample* result, MKTLweSample* s
     for (int i = 0; i < parties; ++i)
     {
         torusPolynomialClearN(&v[i], N);
-        for (int j = 0; j < dg; ++j)
-        {
-            torusPolynomialAddMulRFFTN(&v[i], &uDec[i*dg+j], &RLWEkey->Pkey[i*dg + j], N);
-        }
+        torusPolynomialAddMulPreparedN(&v[i], &uDec[i*dg], &RLWEkey->PkeyFFT[i*dg], dg);
     }
     // v[parties] = - uDec[parties] * a
     torusPolynomialClearN(&v[parties], N);
-    for (int j = 0; j < dg; ++j)
-    {
-        torusPolynomialSubMulRFFTN(&v[parties], &uDec[parties*dg+j], &RLWEkey->Pkey[parties*dg + j], N);
-    }
+    torusPolynomialSubMulPreparedN(&v[parties], &uDec[parties*dg], &RLWEkey->PkeyFFT[parties*dg], dg);
     
 
 
@@ -1409,20 +1310,14 @@ EXPORT void MKtGswUEExternMulToMKtLwe_v2m2(MKTLweSample* result, MKTLweSample* s
     for (int i = 0; i <= parties; ++i)
     {
         torusPolynomialClearN(&w0[i], N);
-        for (int j = 0; j < dg; ++j)
-        {
-            torusPolynomialAddMulRFFTN(&w0[i], &vDec[i*dg+j], &sampleUE->f0[j], N);
-        }
+        torusPolynomialAddMulPreparedN(&w0[i], &vDec[i*dg], &dFFT[dg], dg);
     }
     // w1[i] = vDec[i] * f1 
     TorusPolynomial* w1 = new_TorusPolynomial_array(parties+1, N);
     for (int i = 0; i <= parties; ++i)
     {
         torusPolynomialClearN(&w1[i], N);
-        for (int j = 0; j < dg; ++j)
-        {
-            torusPolynomialAddMulRFFTN(&w1[i], &vDec[i*dg+j], &sampleUE->f1[j], N);
-        }
+        torusPolynomialAddMulPreparedN(&w1[i], &vDec[i*dg], &dFFT[2*dg], dg);
     }
 
 
@@ -1457,12 +1352,14 @@ EXPORT void MKtGswUEExternMulToMKtLwe_v2m2(MKTLweSample* result, MKTLweSample* s
     }
 
 
-    // TODO current_variance
+    result->current_variance = MKvarianceExternMul_v2m2(sample->current_variance, sampleUE->current_variance, MKparams);
+
     delete_TorusPolynomial_array(parties+1, w1);
     delete_TorusPolynomial_array(parties+1, w0);
     delete_IntPolynomial_array((parties+1)*dg, vDec);
     delete_TorusPolynomial_array(parties+1, v);
     delete_TorusPolynomial_array(parties+1, u);
+    delete_PreparedTorusPolynomial_array(3*dg, dFFT);
     delete_IntPolynomial_array((parties+1)*dg, uDec);
 }
 
@@ -1482,6 +1379,16 @@ EXPORT void MKtGswUEExternMulToMKtLwe_FFT_v2m2(MKTLweSample* result, MKTLweSampl
         const MKTFHEParams* MKparams,
         const MKRLweKey *RLWEkey)
 {
+    const double variance = MKvarianceExternMul_v2m2(sample->current_variance, sampleUEFFT->current_variance, MKparams);
+
+    // kernel specialized for (parties, dg, N) when this configuration is instantiated
+    const MKEngineExternMul engine = MKEngine_externMul(MKparams);
+    if (engine) {
+        engine(result, sample, sampleUEFFT, MKparams, RLWEkey);
+        result->current_variance = variance;
+        return;
+    }
+
     const int32_t N = MKparams->N;
     const int32_t dg = MKparams->dg;
     const int32_t party = sampleUEFFT->party;
@@ -1496,9 +1403,7 @@ EXPORT void MKtGswUEExternMulToMKtLwe_FFT_v2m2(MKTLweSample* result, MKTLweSampl
     for (int i = 0; i <= parties; ++i){
         MKtGswTorus32PolynomialDecompGassembly(&uDec[i*dg], &sample->a[i], MKparams);
     }
-    for (int p = 0; p < parties1dg; ++p){
-        IntPolynomial_ifft(&uDecFFT[p], &uDec[p]); // FFT
-    }
+    IntPolynomial_ifft_batch(uDecFFT, uDec, parties1dg); // FFT
 
 
     
@@ -1529,28 +1434,18 @@ EXPORT void MKtGswUEExternMulToMKtLwe_FFT_v2m2(MKTLweSample* result, MKTLweSampl
     for (int i = 0; i < parties; ++i)
     {
         torusPolynomialClearN(&v[i], N);
-        for (int j = 0; j < dg; ++j)
-        {
-            torusPolynomialAddMulRFFTN(&v[i], &uDec[i*dg+j], &RLWEkey->Pkey[i*dg + j], N);
-        }
+        torusPolynomialAddMulPreparedN(&v[i], &uDec[i*dg], &RLWEkey->PkeyFFT[i*dg], dg);
     }
     // v[parties] = - uDec[parties] * a
     torusPolynomialClearN(&v[parties], N);
-    for (int j = 0; j < dg; ++j)
-    {
-        torusPolynomialSubMulRFFTN(&v[parties], &uDec[parties*dg+j], &RLWEkey->Pkey[parties*dg + j], N);
-    }
+    torusPolynomialSubMulPreparedN(&v[parties], &uDec[parties*dg], &RLWEkey->PkeyFFT[parties*dg], dg);
     // Decompose v and convert it in FFT
     // vDec[i] = g^{-1}(v[i]) 
-    IntPolynomial* vDec = new_IntPolynomial_array(parties1dg, N);
     LagrangeHalfCPolynomial *vDecFFT = new_LagrangeHalfCPolynomial_array(parties1dg, N); //fft version
     for (int i = 0; i <= parties; ++i)
     {
-        MKtGswTorus32PolynomialDecompGassembly(&vDec[i*dg], &v[i], MKparams);
+        MKtGswTorus32PolynomialDecompGFFT(&vDecFFT[i*dg], &v[i], MKparams); // FFT
     }
-    for (int p = 0; p < parties1dg; ++p){
-        IntPolynomial_ifft(&vDecFFT[p], &vDec[p]); // FFT
-    } 
 
 
     // w0FFT[i] = vDecFFT[i] * f0FFT
@@ -1631,13 +1526,13 @@ EXPORT void MKtGswUEExternMulToMKtLwe_FFT_v2m2(MKTLweSample* result, MKTLweSampl
 
 
 
-    // TODO current_variance   
+    result->current_variance = variance;
+
     // delete_LagrangeHalfCPolynomial_array(parties+1, w1FFT); 
     // delete_LagrangeHalfCPolynomial_array(parties+1, w0FFT); 
     delete_TorusPolynomial_array(parties+1, w1); 
     delete_TorusPolynomial_array(parties+1, w0); 
     delete_LagrangeHalfCPolynomial_array(parties1dg, vDecFFT); 
-    delete_IntPolynomial_array(parties1dg, vDec);
     delete_TorusPolynomial_array(parties+1, v);
     delete_TorusPolynomial_array(parties+1, u);
     // delete_LagrangeHalfCPolynomial(tempFFT);
@@ -1747,6 +1642,8 @@ void MKtfhe_MuxRotate_v2m2(MKTLweSample *result, MKTLweSample *accum, const MKTG
     MKtGswUEExternMulToMKtLwe_v2m2(result, temp_result, bki, RLWEparams, MKparams, RLWEkey);
     // ACC += temp
     MKtLweAddTo(result, accum, MKparams);
+    // the noise of temp is only kept when the bit is 1, and then it replaces the one of ACC
+    result->current_variance = MKvarianceMuxRotate_v2m2(accum->current_variance, bki->current_variance, MKparams);
 
     delete_MKTLweSample(temp_result);
 }
@@ -1768,6 +1665,8 @@ void MKtfhe_MuxRotateFFT_v2m2(MKTLweSample *result, MKTLweSample *accum, const M
     MKtGswUEExternMulToMKtLwe_FFT_v2m2(result, temp_result,bkiFFT, RLWEparams, MKparams, RLWEkey);
     // ACC += temp
     MKtLweAddTo(result, accum, MKparams);
+    // the noise of temp is only kept when the bit is 1, and then it replaces the one of ACC
+    result->current_variance = MKvarianceMuxRotate_v2m2(accum->current_variance, bkiFFT->current_variance, MKparams);
 
     delete_MKTLweSample(temp_result);
 }
@@ -55,6 +55,7 @@ EXPORT void MKRLweKeyGen(MKRLweKey *result) {
     for (int j = 0; j < dg; ++j)
     {
         torusPolynomialUniform(&result->Pkey[parties*dg + j]);
+        torusPolynomialPrepare(&result->PkeyFFT[parties*dg + j], &result->Pkey[parties*dg + j]);
     }
     // b_i = +a*s_i + e_i
     for (int i = 0; i < parties; ++i)
@@ -67,7 +68,8 @@ EXPORT void MKRLweKeyGen(MKRLweKey *result) {
                 result->Pkey[i*dg + j].coefsT[l] = gaussian32(0, stdevRLWEkey);
             }      
             // b_i = e_i + a*s_i
-            torusPolynomialAddMulRFFT1(&result->Pkey[i*dg + j], result->key[i].key, &result->Pkey[parties*dg + j]); 
+            torusPolynomialAddMulPrepared(&result->Pkey[i*dg + j], result->key[i].key, &result->PkeyFFT[parties*dg + j]); 
+            torusPolynomialPrepare(&result->PkeyFFT[i*dg + j], &result->Pkey[i*dg + j]);
         }
     }
     
@@ -330,6 +332,7 @@ EXPORT void init_MKLweBootstrappingKeyFFT_v2(MKLweBootstrappingKeyFFT_v2 *obj,
                 TorusPolynomial_ifft(&bkFFT[p*n+i].d[j], &bk->bk[p*n+i].d[j]);
             }
             bkFFT[p*n+i].party = bk->bk[p*n+i].party; 
+            bkFFT[p*n+i].current_variance = bk->bk[p*n+i].current_variance; 
         }
     }
     clock_t end = clock();
@@ -121,10 +121,12 @@ MKRLweKey::MKRLweKey(const TLweParams* RLWEparams, const MKTFHEParams* MKparams)
     // Pkey_{parties*d} is a=U(T^d) equal for all the parties
     // Pkey_{i*d} is the b_i = key_i*a + e_i \in T^d (i=0, ..., parties-1)
     Pkey = new_TorusPolynomial_array((1 + MKparams->parties)*MKparams->dg, RLWEparams->N);
+    PkeyFFT = new_PreparedTorusPolynomial_array((1 + MKparams->parties)*MKparams->dg, RLWEparams->N);
 }
 
 MKRLweKey::~MKRLweKey() {
     delete_TLweKey_array(MKparams->parties, key);
+    delete_PreparedTorusPolynomial_array((1 + MKparams->parties)*MKparams->dg, PkeyFFT);
     delete_TorusPolynomial_array((1 + MKparams->parties)*MKparams->dg, Pkey);
 }
 
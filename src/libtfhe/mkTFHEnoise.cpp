@@ -0,0 +1,132 @@
+#include <cmath>
+#include "mkTFHEparams.h"
+#include "mkTFHEnoise.h"
+
+
+using namespace std;
+
+
+
+/* ****************************************************
+********** NOISE MODEL (version 2, method 2) **********
+**************************************************** */
+
+
+EXPORT double MKvarianceDigitG(const MKTFHEParams* MKparams) {
+    const double Bg = ldexp(1.0, MKparams->Bgbit);
+    return Bg * Bg / 12.0;
+}
+
+
+EXPORT double MKvarianceDecompG(const MKTFHEParams* MKparams) {
+    // uniform in [-Bg^{-dg}/2, Bg^{-dg}/2)
+    return ldexp(1.0, -2 * MKparams->Bgbit * MKparams->dg) / 12.0;
+}
+
+
+// The decomposition truncates (the offset has no rounding half-bit), so its error also has
+// a mean Bg^{-dg}/2. Multiplied by a binary polynomial, the means of N coefficients add up
+// with the signs of the negacyclic product: variance (mean*N)^2/12 over the coefficients.
+EXPORT double MKvarianceDecompBiasG(int32_t nb_decomp, const MKTFHEParams* MKparams) {
+    const double mean = ldexp(1.0, -MKparams->Bgbit * MKparams->dg - 1);
+    const double sum = nb_decomp * mean * MKparams->N;
+    return sum * sum / 12.0;
+}
+
+
+
+// x_i[j] = <g^{-1}(b_i[j]), f0> = r*b_i[j] + <g^{-1}(b_i[j]), e_f> + r*eps
+// and r*b_i[j] carries the error r*e_i of the public key (r binary)
+EXPORT double MKvarianceExpand_v2(double var_ue, const MKTFHEParams* MKparams) {
+    const int32_t N = MKparams->N;
+    const int32_t dg = MKparams->dg;
+    const double var_pk = MKparams->stdevRLWEkey * MKparams->stdevRLWEkey;
+
+    return var_ue
+        + dg * N * MKvarianceDigitG(MKparams) * var_ue
+        + 0.5 * N * (MKvarianceDecompG(MKparams) + var_pk)
+        + MKvarianceDecompBiasG(1, MKparams);
+}
+
+
+
+// c' = G^{-1}(c)*C, with C = (d, F) = (d, f0, f1):
+// - u = G^{-1}(c)*d brings the error of d on each of the parties+1 components,
+//   the parties mask components being multiplied by the secret keys
+// - w = G^{-1}(v)*F brings the error of f0 on each of the parties+1 components,
+//   and r*v brings the rounding of v and the errors e_i of the public keys (r binary)
+// - the rounding of c is multiplied by the message and by the secret keys
+// - the means of the parties+1 roundings of v add up in r*v (the worst case, for a message 0)
+EXPORT double MKvarianceExternMul_v2m2(double var_in, double var_ue, const MKTFHEParams* MKparams) {
+    const int32_t N = MKparams->N;
+    const int32_t dg = MKparams->dg;
+    const int32_t parties = MKparams->parties;
+    const double var_digit = MKvarianceDigitG(MKparams);
+    const double var_decomp = MKvarianceDecompG(MKparams);
+    const double var_pk = MKparams->stdevRLWEkey * MKparams->stdevRLWEkey;
+
+    const double var_d = (1.0 + 0.5 * parties * N) * dg * N * var_digit * var_ue;
+    const double var_f = (parties + 1) * dg * N * var_digit * var_ue;
+    const double var_r = 0.5 * N * (parties * dg * N * var_digit * var_pk + (parties + 1) * var_decomp);
+    const double var_round = (1.0 + 0.5 * parties * N) * var_decomp;
+    const double var_bias = MKvarianceDecompBiasG(parties + 1, MKparams);
+
+    return var_in + var_d + var_f + var_r + var_round + var_bias;
+}
+
+
+EXPORT double MKvarianceMuxRotate_v2m2(double var_acc, double var_ue, const MKTFHEParams* MKparams) {
+    return MKvarianceExternMul_v2m2(var_acc, var_ue, MKparams);
+}
+
+
+EXPORT double MKvarianceBlindRotate_v2m2(double var_ue, const MKTFHEParams* MKparams) {
+    const int32_t rotations = MKparams->parties * MKparams->n;
+    return rotations * MKvarianceMuxRotate_v2m2(0.0, var_ue, MKparams);
+}
+
+
+
+// each of the parties*n_extract coefficients is rounded to Bks^{-dks}
+// (uniform error times a binary key) and decomposed into dks rows of variance stdevKS^2
+EXPORT double MKvarianceKeySwitch(double var_in, const MKTFHEParams* MKparams) {
+    const int32_t dks = MKparams->dks;
+    const double var_ks = MKparams->stdevKS * MKparams->stdevKS;
+    const double var_round = ldexp(1.0, -2 * MKparams->Bksbit * dks) / 24.0;
+
+    return var_in + MKparams->parties * MKparams->n_extract * (dks * var_ks + var_round);
+}
+
+
+// b and the parties*n coefficients of a are rounded to multiples of 1/2N (a times a binary key)
+EXPORT double MKvarianceModSwitch(const MKTFHEParams* MKparams) {
+    const double _2N = 2.0 * MKparams->N;
+    return (1.0 + 0.5 * MKparams->parties * MKparams->n) / (12.0 * _2N * _2N);
+}
+
+
+EXPORT double MKvarianceBootstrap_v2m2(const MKTFHEParams* MKparams) {
+    const double var_bk = MKparams->stdevBK * MKparams->stdevBK;
+    return MKvarianceKeySwitch(MKvarianceBlindRotate_v2m2(var_bk, MKparams), MKparams);
+}
+
+
+EXPORT double MKfailureProbabilityNAND_v2m2(const MKTFHEParams* MKparams) {
+    const double var = 2.0 * MKvarianceBootstrap_v2m2(MKparams) + MKvarianceModSwitch(MKparams);
+    return erfc(0.125 / sqrt(2.0 * var));
+}
+
+
+
+// per rotation: (parties+1)*dg products for u and for v, 2*(parties+1)*dg for w0 and w1
+// key switching: parties*n_extract*dks additions of a sample of size n+1
+EXPORT double MKcostBootstrap_v2m2(const MKTFHEParams* MKparams) {
+    const int32_t N = MKparams->N;
+    const int32_t parties = MKparams->parties;
+    const double poly_mult = N * log2(double(N));
+
+    const double rotate = 4.0 * (parties + 1) * MKparams->dg * poly_mult;
+    const double keyswitch = double(parties) * MKparams->n_extract * MKparams->dks * (MKparams->n + 1);
+
+    return double(parties) * MKparams->n * rotate + keyswitch;
+}
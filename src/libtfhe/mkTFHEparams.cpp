@@ -2,6 +2,9 @@
 #include "mkTFHEparams.h"
 #include <new>
 #include <stdlib.h>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 
 using namespace std;
@@ -126,6 +129,22 @@ EXPORT void delete_MKTFHEParams_array(int32_t nbelts, MKTFHEParams* obj) {
     free_MKTFHEParams_array(nbelts,obj);
 }
 
-
-
-
+// shared = interned by value
+EXPORT const MKTFHEParams* shared_MKTFHEParams(int32_t n, int32_t n_extract, int32_t hLWE, double stdevLWE, 
+		int32_t Bksbit, int32_t dks, double stdevKS, int32_t N, int32_t hRLWE, double stdevRLWEkey, 
+		double stdevRLWE, double stdevRGSW, int32_t Bgbit, int32_t dg, double stdevBK, int32_t parties) 
+{
+    typedef tuple<int32_t, int32_t, int32_t, double, int32_t, int32_t, double, int32_t, int32_t, double,
+                  double, double, int32_t, int32_t, double, int32_t> Key;
+    static mutex registry_mutex;
+    static map<Key, MKTFHEParams*> registry; // never freed: the handles are shared with the callers
+
+    const Key key(n, n_extract, hLWE, stdevLWE, Bksbit, dks, stdevKS, N, hRLWE, stdevRLWEkey,
+                  stdevRLWE, stdevRGSW, Bgbit, dg, stdevBK, parties);
+    lock_guard<mutex> lock(registry_mutex);
+    MKTFHEParams*& params = registry[key];
+    if (!params) 
+        params = new MKTFHEParams(n, n_extract, hLWE, stdevLWE, Bksbit, dks, stdevKS, N, hRLWE, stdevRLWEkey, 
+		    stdevRLWE, stdevRGSW, Bgbit, dg, stdevBK, parties);
+    return params;
+}
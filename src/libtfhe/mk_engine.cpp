@@ -0,0 +1,134 @@
+#include <cassert>
+#include "tfhe_core.h"
+#include "polynomials.h"
+#include "lagrangehalfc_arithmetic.h"
+#include "mkTFHEparams.h"
+#include "mkTFHEkeys.h"
+#include "mkTFHEsamples.h"
+#include "mkTFHEfunctions.h"
+#include "mk_engine.h"
+
+using namespace std;
+
+
+namespace {
+
+    // per-thread buffers of one instantiation, allocated on first use
+    template<int32_t Parties, int32_t Dg, int32_t N>
+    struct MKEngineScratch {
+        static const int32_t Parties1 = Parties + 1;
+        static const int32_t Parties1Dg = (Parties + 1) * Dg;
+
+        LagrangeHalfCPolynomial *uDecFFT; // g^{-1}(sample->a[i]), Parties1Dg
+        LagrangeHalfCPolynomial *vDecFFT; // g^{-1}(v[i]), Parties1Dg
+        LagrangeHalfCPolynomial *acc;     // Parties1 accumulators
+        TorusPolynomial *v;               // Parties1
+
+        MKEngineScratch() {
+            uDecFFT = new_LagrangeHalfCPolynomial_array(Parties1Dg, N);
+            vDecFFT = new_LagrangeHalfCPolynomial_array(Parties1Dg, N);
+            acc = new_LagrangeHalfCPolynomial_array(Parties1, N);
+            v = new_TorusPolynomial_array(Parties1, N);
+        }
+
+        ~MKEngineScratch() {
+            delete_TorusPolynomial_array(Parties1, v);
+            delete_LagrangeHalfCPolynomial_array(Parties1, acc);
+            delete_LagrangeHalfCPolynomial_array(Parties1Dg, vDecFFT);
+            delete_LagrangeHalfCPolynomial_array(Parties1Dg, uDecFFT);
+        }
+
+        MKEngineScratch(const MKEngineScratch &) = delete;
+        void operator=(const MKEngineScratch &) = delete;
+    };
+
+    // acc = \sum_{j<Dg} a[j]*b[j]
+    template<int32_t Dg>
+    inline void dotFFT(LagrangeHalfCPolynomial *acc, const LagrangeHalfCPolynomial *a,
+            const LagrangeHalfCPolynomial *b)
+    {
+        LagrangeHalfCPolynomialMul(acc, a, b);
+        for (int32_t j = 1; j < Dg; ++j) LagrangeHalfCPolynomialAddMul(acc, a + j, b + j);
+    }
+
+    // acc += \sum_{j<Dg} a[j]*b[j]
+    template<int32_t Dg>
+    inline void addDotFFT(LagrangeHalfCPolynomial *acc, const LagrangeHalfCPolynomial *a,
+            const LagrangeHalfCPolynomial *b)
+    {
+        for (int32_t j = 0; j < Dg; ++j) LagrangeHalfCPolynomialAddMul(acc, a + j, b + j);
+    }
+
+}
+
+
+/*
+ * Same steps as MKtGswUEExternMulToMKtLwe_FFT_v2m2, with every sum in the Lagrange space:
+ * u_i = g^{-1}(c_i)*d, v_i = g^{-1}(c_i)*b_i (v_parties = -g^{-1}(c_parties)*a),
+ * w0 = \sum_i g^{-1}(v_i)*f0, w1 = \sum_i g^{-1}(v_i)*f1,
+ * c'_i = u_i (i != party), c'_party = u_party + w1, c'_parties = u_parties + w0
+ */
+template<int32_t Parties, int32_t Dg, int32_t N>
+void MKEngine<Parties, Dg, N>::externMulToMKtLwe(MKTLweSample* result, const MKTLweSample* sample,
+        const MKTGswUESampleFFT_v2* sampleUEFFT, const MKTFHEParams* MKparams, const MKRLweKey* RLWEkey)
+{
+    assert(MKparams->parties == Parties && MKparams->dg == Dg && MKparams->N == N);
+    static thread_local MKEngineScratch<Parties, Dg, N> scratch;
+    LagrangeHalfCPolynomial *uDecFFT = scratch.uDecFFT;
+    LagrangeHalfCPolynomial *vDecFFT = scratch.vDecFFT;
+    LagrangeHalfCPolynomial *acc = scratch.acc;
+    TorusPolynomial *v = scratch.v;
+    const int32_t party = sampleUEFFT->party;
+    const LagrangeHalfCPolynomial *d = sampleUEFFT->d;
+    const LagrangeHalfCPolynomial *f0 = sampleUEFFT->f0;
+    const LagrangeHalfCPolynomial *f1 = sampleUEFFT->f1;
+    const PreparedTorusPolynomial *PkeyFFT = RLWEkey->PkeyFFT;
+
+    // decompose the sample, directly in the Lagrange space
+    for (int32_t i = 0; i <= Parties; ++i)
+        MKtGswTorus32PolynomialDecompGFFT(uDecFFT + i*Dg, sample->a + i, MKparams);
+
+    // v[i] = g^{-1}(c_i) * b_i, for i < parties, and v[parties] = g^{-1}(c_parties) * a
+    for (int32_t i = 0; i <= Parties; ++i)
+    {
+        LagrangeHalfCPolynomialMul(acc + i, uDecFFT + i*Dg, PkeyFFT[i*Dg].fft);
+        for (int32_t j = 1; j < Dg; ++j)
+            LagrangeHalfCPolynomialAddMul(acc + i, uDecFFT + i*Dg + j, PkeyFFT[i*Dg + j].fft);
+    }
+    TorusPolynomial_fft_batch(v, acc, Parties + 1);
+    // v[parties] = - g^{-1}(c_parties) * a (negated after the FFT, to round as the generic code)
+    for (int32_t k = 0; k < N; ++k) v[Parties].coefsT[k] = -v[Parties].coefsT[k];
+
+    // decompose v
+    for (int32_t i = 0; i <= Parties; ++i)
+        MKtGswTorus32PolynomialDecompGFFT(vDecFFT + i*Dg, v + i, MKparams);
+
+    // u_i, plus w1 for the party and w0 for the last component
+    for (int32_t i = 0; i <= Parties; ++i)
+        dotFFT<Dg>(acc + i, uDecFFT + i*Dg, d);
+    for (int32_t i = 0; i <= Parties; ++i)
+    {
+        addDotFFT<Dg>(acc + party, vDecFFT + i*Dg, f1);
+        addDotFFT<Dg>(acc + Parties, vDecFFT + i*Dg, f0);
+    }
+    TorusPolynomial_fft_batch(result->a, acc, Parties + 1);
+}
+
+
+// the configurations of testMKbootNAND_FFT_v2 (2 parties d=3, 4 parties d=4, 8 parties d=5)
+template struct MKEngine<2, 3, 1024>;
+template struct MKEngine<4, 4, 1024>;
+template struct MKEngine<8, 5, 1024>;
+
+EXPORT MKEngineExternMul MKEngine_externMul(const MKTFHEParams* MKparams)
+{
+    const int32_t parties = MKparams->parties;
+    const int32_t dg = MKparams->dg;
+    const int32_t N = MKparams->N;
+
+    if (N != 1024) return 0;
+    if (parties == 2 && dg == 3) return MKEngine<2, 3, 1024>::externMulToMKtLwe;
+    if (parties == 4 && dg == 4) return MKEngine<4, 4, 1024>::externMulToMKtLwe;
+    if (parties == 8 && dg == 5) return MKEngine<8, 5, 1024>::externMulToMKtLwe;
+    return 0;
+}
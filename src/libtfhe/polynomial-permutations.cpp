@@ -0,0 +1,101 @@
+/*
+ * Permutations of the coefficients of polynomials mod X^N+1:
+ * the rotations by X^a and the ring automorphisms X -> X^e, in place or not
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <vector>
+#include "tfhe_core.h"
+#include "polynomials.h"
+
+using namespace std;
+
+
+namespace {
+
+    /**
+     * gather form of X -> X^e, for one (N, e): the coefficient j of the result is
+     * the coefficient table[j] of the source, negated when table[N+j] = -1 (0 otherwise).
+     * The tables are built on first use, one cache per thread (no locking).
+     */
+    const int32_t *automorphism_table(int32_t N, int32_t e) {
+        static thread_local map<int64_t, vector<int32_t> > tables;
+        vector<int32_t> &table = tables[(int64_t(N) << 32) | e];
+        if (table.empty()) {
+            table.resize(2 * N);
+            const int32_t _2Nm1 = 2 * N - 1;
+            for (int32_t i = 0, j = 0; i < N; i++, j = (j + e) & _2Nm1) {
+                const int32_t jj = j < N ? j : j - N;
+                table[jj] = i;
+                table[N + jj] = j < N ? 0 : -1;
+            }
+        }
+        return table.data();
+    }
+
+    // out[j] = +-in[table[j]]: (x ^ m) - m is x for m = 0, and -x for m = -1
+    inline void apply_automorphism(int32_t *out, const int32_t *in, const int32_t *table, int32_t N) {
+        const int32_t *neg = table + N;
+        for (int32_t j = 0; j < N; j++) out[j] = (in[table[j]] ^ neg[j]) - neg[j];
+    }
+
+    // per-thread copy of the source, for the in place automorphisms
+    int32_t *scratch_buffer(int32_t N) {
+        static thread_local vector<int32_t> buffer;
+        if (int32_t(buffer.size()) < N) buffer.resize(N);
+        return buffer.data();
+    }
+
+}
+
+
+//poly = X^{a}*poly
+EXPORT void torusPolynomialMulByXaiInPlace(TorusPolynomial *poly, int32_t a) {
+    const int32_t N = poly->N;
+    Torus32 *p = poly->coefsT;
+
+    assert(a >= 0 && a < 2 * N);
+
+    // X^a = +-X^aa: rotate by aa, then the coefficients that wrapped around (a < N)
+    // or the others (a >= N) change sign
+    const int32_t aa = a < N ? a : a - N;
+    rotate(p, p + N - aa, p + N);
+    if (a < N) {
+        for (int32_t i = 0; i < aa; i++) p[i] = -p[i];
+    } else {
+        for (int32_t i = aa; i < N; i++) p[i] = -p[i];
+    }
+}
+
+// result(X) = source(X^e)
+EXPORT void torusPolynomialAutomorphism(TorusPolynomial *result, const TorusPolynomial *source, int32_t e) {
+    const int32_t N = source->N;
+
+    assert((e & 1) == 1 && e > 0 && e < 2 * N);
+    assert(result != source);
+
+    apply_automorphism(result->coefsT, source->coefsT, automorphism_table(N, e), N);
+}
+
+// poly(X) = poly(X^e)
+EXPORT void torusPolynomialAutomorphismInPlace(TorusPolynomial *poly, int32_t e) {
+    const int32_t N = poly->N;
+
+    assert((e & 1) == 1 && e > 0 && e < 2 * N);
+
+    int32_t *tmp = scratch_buffer(N);
+    copy(poly->coefsT, poly->coefsT + N, tmp);
+    apply_automorphism(poly->coefsT, tmp, automorphism_table(N, e), N);
+}
+
+// result(X) = source(X^e)
+EXPORT void intPolynomialAutomorphism(IntPolynomial *result, const IntPolynomial *source, int32_t e) {
+    const int32_t N = source->N;
+
+    assert((e & 1) == 1 && e > 0 && e < 2 * N);
+    assert(result != source);
+
+    apply_automorphism(result->coefs, source->coefs, automorphism_table(N, e), N);
+}
@@ -1,6 +1,7 @@
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <new>
 #include "tfhe_core.h"
 #include "polynomials_arithmetic.h"
 #include "lagrangehalfc_arithmetic.h"
@@ -150,3 +151,94 @@ EXPORT void torusPolynomialSubMulRFFTN(TorusPolynomial* result, IntPolynomial* p
     delete_LagrangeHalfCPolynomial_array(3,tmp);
 }
 
+PreparedTorusPolynomial::PreparedTorusPolynomial(const int32_t N): N(N) {
+    fft = new_LagrangeHalfCPolynomial(N);
+}
+
+PreparedTorusPolynomial::~PreparedTorusPolynomial() {
+    delete_LagrangeHalfCPolynomial(fft);
+}
+
+EXPORT PreparedTorusPolynomial* new_PreparedTorusPolynomial(const int32_t N) {
+    return new PreparedTorusPolynomial(N);
+}
+EXPORT PreparedTorusPolynomial* new_PreparedTorusPolynomial_array(int32_t nbelts, const int32_t N) {
+    PreparedTorusPolynomial* obj = (PreparedTorusPolynomial*) malloc(nbelts*sizeof(PreparedTorusPolynomial));
+    for (int32_t i=0; i<nbelts; i++) new(obj+i) PreparedTorusPolynomial(N);
+    return obj;
+}
+
+EXPORT void delete_PreparedTorusPolynomial(PreparedTorusPolynomial* obj) {
+    delete obj;
+}
+EXPORT void delete_PreparedTorusPolynomial_array(int32_t nbelts, PreparedTorusPolynomial* obj) {
+    for (int32_t i=0; i<nbelts; i++) (obj+i)->~PreparedTorusPolynomial();
+    free(obj);
+}
+
+EXPORT void torusPolynomialPrepare(PreparedTorusPolynomial* result, const TorusPolynomial* poly) {
+    assert(result->N == poly->N);
+    TorusPolynomial_ifft(result->fft, poly);
+}
+
+namespace {
+// per-thread scratch of the prepared multiplications, reallocated only when N changes
+struct PreparedMulScratch {
+    int32_t N;
+    LagrangeHalfCPolynomial* tmp; // 0: FFT(poly1), 1: accumulator
+    TorusPolynomial* tmpr;
+
+    PreparedMulScratch(): N(0), tmp(0), tmpr(0) {}
+    ~PreparedMulScratch() { release(); }
+
+    void release() {
+        if (!tmp) return;
+        delete_TorusPolynomial(tmpr);
+        delete_LagrangeHalfCPolynomial_array(2, tmp);
+        tmp = 0; tmpr = 0;
+    }
+
+    void ensure(const int32_t n) {
+        if (n == N) return;
+        release();
+        tmp = new_LagrangeHalfCPolynomial_array(2, n);
+        tmpr = new_TorusPolynomial(n);
+        N = n;
+    }
+};
+
+// tmpr = sum_{j<count} poly1[j]*poly2[j]
+const TorusPolynomial* mulPreparedN(const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2, const int32_t count) {
+    static thread_local PreparedMulScratch scratch;
+    const int32_t N = poly1->N;
+    scratch.ensure(N);
+    LagrangeHalfCPolynomial* fft1 = scratch.tmp+0;
+    LagrangeHalfCPolynomial* acc = scratch.tmp+1;
+    for (int32_t j=0; j<count; j++) {
+        assert(poly1[j].N == N && poly2[j].N == N);
+        IntPolynomial_ifft(fft1, poly1+j);
+        if (j == 0) LagrangeHalfCPolynomialMul(acc, fft1, poly2[j].fft);
+        else LagrangeHalfCPolynomialAddMul(acc, fft1, poly2[j].fft);
+    }
+    TorusPolynomial_fft(scratch.tmpr, acc);
+    return scratch.tmpr;
+}
+}
+
+EXPORT void torusPolynomialAddMulPrepared(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2) {
+    torusPolynomialAddTo(result, mulPreparedN(poly1, poly2, 1));
+}
+
+EXPORT void torusPolynomialSubMulPrepared(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2) {
+    torusPolynomialSubTo(result, mulPreparedN(poly1, poly2, 1));
+}
+
+EXPORT void torusPolynomialAddMulPreparedN(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2, const int32_t count) {
+    if (count <= 0) return;
+    torusPolynomialAddTo(result, mulPreparedN(poly1, poly2, count));
+}
+
+EXPORT void torusPolynomialSubMulPreparedN(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2, const int32_t count) {
+    if (count <= 0) return;
+    torusPolynomialSubTo(result, mulPreparedN(poly1, poly2, count));
+}
@@ -0,0 +1,175 @@
+#include <cstdlib>
+#include <cstring>
+#include "tfhe_core.h"
+#include "polynomials.h"
+#include "tfhe_cpu_dispatch.h"
+
+using namespace std;
+
+
+EXPORT void torus32PolynomialDecomp_portable(IntPolynomial *result, uint32_t *buf, int32_t N, int32_t l,
+                                             int32_t Bgbit, uint32_t maskMod, int32_t halfBg, uint32_t offset) {
+    //First, add offset to everyone
+    for (int32_t j = 0; j < N; ++j) buf[j] += offset;
+
+    //then, do the decomposition (in parallel)
+    for (int32_t p = 0; p < l; ++p) {
+        const int32_t decal = (32 - (p + 1) * Bgbit);
+        int32_t *res_p = result[p].coefs;
+        for (int32_t j = 0; j < N; ++j) {
+            uint32_t temp1 = (buf[j] >> decal) & maskMod;
+            res_p[j] = temp1 - halfBg;
+        }
+    }
+
+    //finally, remove offset to everyone
+    for (int32_t j = 0; j < N; ++j) buf[j] -= offset;
+}
+
+// the inline assembly does not depend on the compilation flags: this kernel is always
+// available, and must only be called when the CPU supports AVX2 (N multiple of 8)
+EXPORT void torus32PolynomialDecomp_avx2(IntPolynomial *result, uint32_t *buf, int32_t N, int32_t l,
+                                         int32_t Bgbit, uint32_t maskMod, int32_t halfBg, uint32_t offset) {
+    const uint32_t *maskMod_addr = &maskMod;
+    const int32_t *halfBg_addr = &halfBg;
+    const uint32_t *offset_addr = &offset;
+
+    //First, add offset to everyone
+    {
+    const uint32_t* sit = buf;
+    const uint32_t* send = buf+N;
+    __asm__ __volatile__ (
+        "vpbroadcastd (%2),%%ymm0\n"
+        "0:\n"
+        "vmovdqu (%0),%%ymm3\n"
+        "vpaddd %%ymm0,%%ymm3,%%ymm3\n" // add offset
+        "vmovdqu %%ymm3,(%0)\n"
+        "addq $32,%0\n"
+        "cmpq %1,%0\n"
+        "jb 0b\n"
+        : "=r"(sit),"=r"(send),"=r"(offset_addr)
+        :  "0"(sit), "1"(send), "2"(offset_addr)
+        : "%ymm0","%ymm3","memory"
+        );
+    }
+
+    //then, do the decomposition (in parallel)
+    for (int32_t p = 0; p < l; ++p) {
+        const int32_t decal = (32 - (p + 1) * Bgbit);
+        int32_t* dst = result[p].coefs;
+        const uint32_t* sit = buf;
+        const uint32_t* send = buf+N;
+        const int32_t* decal_addr = &decal;
+        __asm__ __volatile__ (
+            "vpbroadcastd (%4),%%ymm0\n"
+            "vpbroadcastd (%5),%%ymm1\n"
+            "vmovd (%3),%%xmm2\n"
+            "1:\n"
+            "vmovdqu (%1),%%ymm3\n"
+            "VPSRLD %%xmm2,%%ymm3,%%ymm3\n" // shift by decal
+            "VPAND %%ymm1,%%ymm3,%%ymm3\n"  // and maskMod
+            "VPSUBD %%ymm0,%%ymm3,%%ymm3\n" // sub halfBg
+            "vmovdqu %%ymm3,(%0)\n"
+            "addq $32,%0\n"
+            "addq $32,%1\n"
+            "cmpq %2,%1\n"
+            "jb 1b\n"
+            : "=r"(dst),"=r"(sit),"=r"(send),"=r"(decal_addr),"=r"(halfBg_addr),"=r"(maskMod_addr)
+            :  "0"(dst), "1"(sit), "2"(send), "3"(decal_addr), "4"(halfBg_addr) ,"5"(maskMod_addr)
+            : "%ymm0","%ymm1","%ymm2","%ymm3","memory"
+            );
+    }
+
+    //finally, remove offset to everyone
+    {
+    const uint32_t* sit = buf;
+    const uint32_t* send = buf+N;
+    __asm__ __volatile__ (
+        "vpbroadcastd (%2),%%ymm0\n"
+        "2:\n"
+        "vmovdqu (%0),%%ymm3\n"
+        "vpsubd %%ymm0,%%ymm3,%%ymm3\n" // add offset
+        "vmovdqu %%ymm3,(%0)\n"
+        "addq $32,%0\n"
+        "cmpq %1,%0\n"
+        "jb 2b\n"
+        "vzeroall\n"
+        : "=r"(sit),"=r"(send),"=r"(offset_addr)
+        :  "0"(sit), "1"(send), "2"(offset_addr)
+        : "%ymm0","%ymm3","memory"
+        );
+    }
+}
+
+
+static TfheCpuFeatures probe_cpu_features() {
+    TfheCpuFeatures reps;
+    // __builtin_cpu_supports also checks that the OS saves the ymm/zmm registers
+    __builtin_cpu_init();
+    reps.avx = __builtin_cpu_supports("avx") ? 1 : 0;
+    reps.avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    reps.fma = __builtin_cpu_supports("fma") ? 1 : 0;
+    reps.avx512f = __builtin_cpu_supports("avx512f") ? 1 : 0;
+    return reps;
+}
+
+EXPORT const TfheCpuFeatures *tfhe_cpu_features() {
+    static const TfheCpuFeatures features = probe_cpu_features();
+    return &features;
+}
+
+static TfheCpuBackend select_cpu_backend() {
+    const TfheCpuFeatures *features = tfhe_cpu_features();
+    TfheCpuBackend reps = TFHE_CPU_PORTABLE;
+    if (features->avx) reps = TFHE_CPU_AVX;
+    if (features->avx && features->fma) reps = TFHE_CPU_FMA;
+    if (features->avx && features->fma && features->avx512f) reps = TFHE_CPU_AVX512;
+
+    // the environment can only lower the choice
+    const char *forced = getenv("TFHE_CPU_BACKEND");
+    if (forced != 0) {
+        TfheCpuBackend wanted = reps;
+        if (strcmp(forced, "portable") == 0) wanted = TFHE_CPU_PORTABLE;
+        else if (strcmp(forced, "avx") == 0) wanted = TFHE_CPU_AVX;
+        else if (strcmp(forced, "fma") == 0) wanted = TFHE_CPU_FMA;
+        else if (strcmp(forced, "avx512") == 0) wanted = TFHE_CPU_AVX512;
+        if (wanted < reps) reps = wanted;
+    }
+    return reps;
+}
+
+EXPORT TfheCpuBackend tfhe_cpu_backend() {
+    static const TfheCpuBackend backend = select_cpu_backend();
+    return backend;
+}
+
+EXPORT const char *tfhe_cpu_backend_name(TfheCpuBackend backend) {
+    switch (backend) {
+        case TFHE_CPU_PORTABLE:
+            return "portable";
+        case TFHE_CPU_AVX:
+            return "avx";
+        case TFHE_CPU_FMA:
+            return "fma";
+        case TFHE_CPU_AVX512:
+            return "avx512";
+    }
+    return "unknown";
+}
+
+static TfheCpuKernels select_cpu_kernels() {
+    TfheCpuKernels reps;
+    reps.backend = tfhe_cpu_backend();
+    reps.torus32PolynomialDecomp = torus32PolynomialDecomp_portable;
+    if (reps.backend != TFHE_CPU_PORTABLE && tfhe_cpu_features()->avx2)
+        reps.torus32PolynomialDecomp = torus32PolynomialDecomp_avx2;
+    return reps;
+}
+
+EXPORT const TfheCpuKernels *tfhe_cpu_kernels() {
+    static const TfheCpuKernels kernels = select_cpu_kernels();
+    return &kernels;
+}
+
+// probe the CPU once, when the library is loaded
+static const TfheCpuKernels *const loaded_cpu_kernels __attribute__((unused)) = tfhe_cpu_kernels();
@@ -0,0 +1,110 @@
+#include "tfhe_thread_pool.h"
+#include "tfhe_core.h"
+#include "tfhe_gate_bootstrapping_functions.h"
+
+using namespace std;
+
+namespace {
+    // true in the threads that are currently running a task of some pool
+    thread_local bool in_pool_task = false;
+}
+
+TfheThreadPool &TfheThreadPool::global() {
+    static TfheThreadPool pool(1);
+    return pool;
+}
+
+TfheThreadPool::TfheThreadPool(int32_t nb_threads) :
+        generation(0), stopping(false), running(0), task(0), arg(0), nb_tasks(0), next_task(0) {
+    start(nb_threads);
+}
+
+TfheThreadPool::~TfheThreadPool() {
+    stop();
+}
+
+int32_t TfheThreadPool::nb_threads() const {
+    return int32_t(workers.size()) + 1;
+}
+
+void TfheThreadPool::start(int32_t nb_threads) {
+    stopping = false;
+    for (int32_t i = 1; i < nb_threads; i++)
+        workers.emplace_back(&TfheThreadPool::worker_loop, this, generation);
+}
+
+void TfheThreadPool::stop() {
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    job_ready.notify_all();
+    for (thread &t: workers) t.join();
+    workers.clear();
+}
+
+void TfheThreadPool::resize(int32_t nb_threads) {
+    lock_guard<std::mutex> run_lock(run_mutex);
+    if (nb_threads < 1) nb_threads = 1;
+    if (nb_threads == this->nb_threads()) return;
+    stop();
+    start(nb_threads);
+}
+
+// takes the tasks of the current job until there is none left
+void TfheThreadPool::work() {
+    in_pool_task = true;
+    for (int32_t i = next_task++; i < nb_tasks; i = next_task++)
+        task(i, arg);
+    in_pool_task = false;
+}
+
+// seen: the last job generation before this worker started
+void TfheThreadPool::worker_loop(uint64_t seen) {
+    for (;;) {
+        {
+            unique_lock<std::mutex> lock(mutex);
+            job_ready.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        work();
+        {
+            lock_guard<std::mutex> lock(mutex);
+            if (--running == 0) job_done.notify_one();
+        }
+    }
+}
+
+void TfheThreadPool::run(int32_t nb_tasks, Task task, void *arg) {
+    if (nb_tasks <= 0) return;
+    unique_lock<std::mutex> run_lock(run_mutex, defer_lock);
+    if (nb_tasks > 1 && !in_pool_task) run_lock.lock();
+    if (!run_lock.owns_lock() || workers.empty()) {
+        if (run_lock.owns_lock()) run_lock.unlock();
+        for (int32_t i = 0; i < nb_tasks; i++) task(i, arg);
+        return;
+    }
+    {
+        lock_guard<std::mutex> lock(mutex);
+        this->task = task;
+        this->arg = arg;
+        this->nb_tasks = nb_tasks;
+        next_task = 0;
+        running = int32_t(workers.size());
+        generation++;
+    }
+    job_ready.notify_all();
+    work();
+    unique_lock<std::mutex> lock(mutex);
+    job_done.wait(lock, [&] { return running == 0; });
+}
+
+
+EXPORT void tfhe_set_gate_batch_threads(int32_t nb_threads) {
+    TfheThreadPool::global().resize(nb_threads);
+}
+
+EXPORT int32_t tfhe_get_gate_batch_threads() {
+    return TfheThreadPool::global().nb_threads();
+}
@@ -0,0 +1,72 @@
+#ifndef TFHE_THREAD_POOL_H
+#define TFHE_THREAD_POOL_H
+
+///@file
+///@brief This file declares the thread pool used by the batched gates
+
+#ifndef __cplusplus
+#error This file should only be included in a C++ file, for internal use only
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * a fixed set of worker threads that run the tasks of one job at a time.
+ * The workers live as long as the pool, so that their thread-local
+ * bootstrapping workspaces are reused from one job to the next.
+ */
+class TfheThreadPool {
+public:
+    typedef void (*Task)(int32_t index, void *arg);
+
+    /** the pool of the batched gates (1 thread, i.e. no worker, by default) */
+    static TfheThreadPool &global();
+
+    /** number of threads running a job, including the calling thread */
+    int32_t nb_threads() const;
+
+    /** restarts the pool with nb_threads-1 workers (nb_threads < 1 means 1) */
+    void resize(int32_t nb_threads);
+
+    /** runs task(i, arg) for all i in [0, nb_tasks) and waits for all of them.
+     * The calling thread takes part in the job. Nested calls run sequentially. */
+    void run(int32_t nb_tasks, Task task, void *arg);
+
+    explicit TfheThreadPool(int32_t nb_threads);
+
+    TfheThreadPool(const TfheThreadPool &) = delete;
+
+    void operator=(const TfheThreadPool &)= delete;
+
+    ~TfheThreadPool();
+
+private:
+    void start(int32_t nb_threads);
+
+    void stop();
+
+    void worker_loop(uint64_t seen);
+
+    void work();
+
+    std::vector<std::thread> workers;
+    std::mutex run_mutex; // one job at a time
+    std::mutex mutex;
+    std::condition_variable job_ready;
+    std::condition_variable job_done;
+    uint64_t generation;
+    bool stopping;
+    int32_t running; // workers still in the current job
+
+    Task task;
+    void *arg;
+    int32_t nb_tasks;
+    std::atomic<int32_t> next_task;
+};
+
+#endif //TFHE_THREAD_POOL_H
@@ -85,34 +85,49 @@ EXPORT void tGswFFTClear(TGswSampleFFT *result, const TGswParams *params) {
         tLweFFTClear(result->all_samples + p, params->tlwe_params);
 }
 
-// External product (*): accum = gsw (*) accum 
-EXPORT void tGswFFTExternMulToTLwe(TLweSample *accum, const TGswSampleFFT *gsw, const TGswParams *params) {
+// External product (*): accum = gsw (*) accum, with caller provided buffers
+// deca and decaFFT hold kpl polynomials, tmpa is a TLweSampleFFT of params->tlwe_params
+void tGswFFTExternMulToTLwe_buffers(TLweSample *accum, const TGswSampleFFT *gsw, const TGswParams *params,
+                                    IntPolynomial *deca, LagrangeHalfCPolynomial *decaFFT, TLweSampleFFT *tmpa) {
     const TLweParams *tlwe_params = params->tlwe_params;
     const int32_t k = tlwe_params->k;
     const int32_t l = params->l;
     const int32_t kpl = params->kpl;
-    const int32_t N = tlwe_params->N;
-    //TODO attention, improve these new/delete...
-    IntPolynomial *deca = new_IntPolynomial_array(kpl, N); //decomposed accumulator
-    LagrangeHalfCPolynomial *decaFFT = new_LagrangeHalfCPolynomial_array(kpl, N); //fft version
-    TLweSampleFFT *tmpa = new_TLweSampleFFT(tlwe_params);
 
+    //the decomposition goes straight to the Lagrange space (deca is not used)
     for (int32_t i = 0; i <= k; i++)
-        tGswTorus32PolynomialDecompH(deca + i * l, accum->a + i, params);
-    for (int32_t p = 0; p < kpl; p++)
-        IntPolynomial_ifft(decaFFT + p, deca + p);
+        tGswTorus32PolynomialDecompHFFT(decaFFT + i * l, accum->a + i, params);
 
     tLweFFTClear(tmpa, tlwe_params);
     for (int32_t p = 0; p < kpl; p++) {
         tLweFFTAddMulRTo(tmpa, decaFFT + p, gsw->all_samples + p, tlwe_params);
     }
     tLweFromFFTConvert(accum, tmpa, tlwe_params);
+}
+
+// External product (*): accum = gsw (*) accum 
+EXPORT void tGswFFTExternMulToTLwe(TLweSample *accum, const TGswSampleFFT *gsw, const TGswParams *params) {
+    const TLweParams *tlwe_params = params->tlwe_params;
+    const int32_t kpl = params->kpl;
+    const int32_t N = tlwe_params->N;
+    IntPolynomial *deca = new_IntPolynomial_array(kpl, N); //decomposed accumulator
+    LagrangeHalfCPolynomial *decaFFT = new_LagrangeHalfCPolynomial_array(kpl, N); //fft version
+    TLweSampleFFT *tmpa = new_TLweSampleFFT(tlwe_params);
+
+    tGswFFTExternMulToTLwe_buffers(accum, gsw, params, deca, decaFFT, tmpa);
 
     delete_TLweSampleFFT(tmpa);
     delete_LagrangeHalfCPolynomial_array(kpl, decaFFT);
     delete_IntPolynomial_array(kpl, deca);
 }
 
+// External product (*): accum = gsw (*) accum, without allocation
+// (ws must have been allocated for the same N, k and l as params)
+EXPORT void tGswFFTExternMulToTLwe_ws(TLweSample *accum, const TGswSampleFFT *gsw, const TGswParams *params,
+                                      TfheBootstrapWorkspace *ws) {
+    tGswFFTExternMulToTLwe_buffers(accum, gsw, params, ws->deca, ws->decaFFT, ws->tmpa);
+}
+
 // result = (X^ai -1)*bki  
 /*
 //This function is not used, but may become handy in a future release
@@ -0,0 +1,138 @@
+/*
+ * Ring automorphisms X -> X^e of TRLWE samples, and their hoisted evaluation
+ */
+
+#include <cassert>
+#include "tfhe.h"
+#include "tlweautomorphism.h"
+
+using namespace std;
+
+
+TLweAutomorphismKey::TLweAutomorphismKey(int32_t e, const TGswParams *params, TLweSampleFFT *rows) :
+        e(e), params(params), rows(rows) {}
+
+TLweAutomorphismKey::~TLweAutomorphismKey() {}
+
+
+EXPORT TLweAutomorphismKey *new_TLweAutomorphismKey(int32_t e, const TGswKey *key, double alpha) {
+    const TGswParams *params = key->params;
+    const TLweParams *tlwe_params = params->tlwe_params;
+    const int32_t N = tlwe_params->N;
+    const int32_t k = tlwe_params->k;
+    const int32_t l = params->l;
+    const int32_t _2N = 2 * N;
+    e = ((e % _2N) + _2N) % _2N;
+    assert((e & 1) == 1);
+
+    TLweSampleFFT *rows = new_TLweSampleFFT_array(k * l, tlwe_params);
+    TorusPolynomial *si = new_TorusPolynomial(N);
+    TorusPolynomial *tau_si = new_TorusPolynomial(N);
+    TorusPolynomial *mu = new_TorusPolynomial(N);
+    TLweSample *row = new_TLweSample(tlwe_params);
+
+    for (int32_t i = 0; i < k; ++i) {
+        for (int32_t c = 0; c < N; ++c) si->coefsT[c] = key->key[i].coefs[c];
+        torusPolynomialAutomorphism(tau_si, si, e);
+        for (int32_t j = 0; j < l; ++j) {
+            for (int32_t c = 0; c < N; ++c) mu->coefsT[c] = tau_si->coefsT[c] * params->h[j];
+            tLweSymEncrypt(row, mu, alpha, &key->tlwe_key);
+            tLweToFFTConvert(rows + i * l + j, row, tlwe_params);
+        }
+    }
+
+    delete_TLweSample(row);
+    delete_TorusPolynomial(mu);
+    delete_TorusPolynomial(tau_si);
+    delete_TorusPolynomial(si);
+    return new TLweAutomorphismKey(e, params, rows);
+}
+
+EXPORT void delete_TLweAutomorphismKey(TLweAutomorphismKey *obj) {
+    const TGswParams *params = obj->params;
+    delete_TLweSampleFFT_array(params->tlwe_params->k * params->l, obj->rows);
+    delete obj;
+}
+
+
+// acc -= \sum_j dec[j].rows[j], over the l digits of one mask polynomial
+static void automorphism_subMulRows(TLweSampleFFT *acc, const LagrangeHalfCPolynomial *dec,
+                                    const TLweSampleFFT *rows, const TGswParams *params) {
+    const int32_t k = params->tlwe_params->k;
+    for (int32_t j = 0; j < params->l; ++j) {
+        for (int32_t q = 0; q <= k; ++q)
+            LagrangeHalfCPolynomialSubMul(acc->a + q, dec + j, rows[j].a + q);
+    }
+}
+
+// result = acc + (0, tau_e(b))
+static void automorphism_finish(TLweSample *result, const TLweSampleFFT *acc, const TLweSample *sample,
+                                const TLweAutomorphismKey *ak, TorusPolynomial *tmp) {
+    const TLweParams *tlwe_params = ak->params->tlwe_params;
+    tLweFromFFTConvert(result, acc, tlwe_params);
+    torusPolynomialAutomorphism(tmp, sample->b, ak->e);
+    torusPolynomialAddTo(result->b, tmp);
+    result->current_variance = sample->current_variance;
+}
+
+EXPORT void tLweAutomorphism(TLweSample *result, const TLweSample *sample, const TLweAutomorphismKey *ak) {
+    const TGswParams *params = ak->params;
+    const TLweParams *tlwe_params = params->tlwe_params;
+    const int32_t N = tlwe_params->N;
+    const int32_t k = tlwe_params->k;
+    const int32_t l = params->l;
+    assert(result != sample);
+
+    TorusPolynomial *tmp = new_TorusPolynomial(N);
+    LagrangeHalfCPolynomial *dec = new_LagrangeHalfCPolynomial_array(l, N);
+    TLweSampleFFT *acc = new_TLweSampleFFT(tlwe_params);
+
+    tLweFFTClear(acc, tlwe_params);
+    for (int32_t i = 0; i < k; ++i) {
+        torusPolynomialAutomorphism(tmp, sample->a + i, ak->e);
+        tGswTorus32PolynomialDecompHFFT(dec, tmp, params);
+        automorphism_subMulRows(acc, dec, ak->rows + i * l, params);
+    }
+    automorphism_finish(result, acc, sample, ak, tmp);
+
+    delete_TLweSampleFFT(acc);
+    delete_LagrangeHalfCPolynomial_array(l, dec);
+    delete_TorusPolynomial(tmp);
+}
+
+EXPORT void tLweHoistedAutomorphisms(TLweSample *results, const TLweSample *sample,
+                                     const TLweAutomorphismKey *const *aks, int32_t count) {
+    if (count <= 0) return;
+    const TGswParams *params = aks[0]->params;
+    const TLweParams *tlwe_params = params->tlwe_params;
+    const int32_t N = tlwe_params->N;
+    const int32_t k = tlwe_params->k;
+    const int32_t l = params->l;
+
+    TorusPolynomial *tmp = new_TorusPolynomial(N);
+    LagrangeHalfCPolynomial *dec = new_LagrangeHalfCPolynomial_array(k * l, N);
+    LagrangeHalfCPolynomial *tau_dec = new_LagrangeHalfCPolynomial_array(l, N);
+    TLweSampleFFT *acc = new_TLweSampleFFT(tlwe_params);
+
+    // the only decomposition and forward FFTs
+    for (int32_t i = 0; i < k; ++i)
+        tGswTorus32PolynomialDecompHFFT(dec + i * l, sample->a + i, params);
+
+    for (int32_t c = 0; c < count; ++c) {
+        const TLweAutomorphismKey *ak = aks[c];
+        assert(ak->params == params);
+        assert(results + c != sample);
+        tLweFFTClear(acc, tlwe_params);
+        for (int32_t i = 0; i < k; ++i) {
+            for (int32_t j = 0; j < l; ++j)
+                LagrangeHalfCPolynomialAutomorphism(tau_dec + j, dec + i * l + j, ak->e);
+            automorphism_subMulRows(acc, tau_dec, ak->rows + i * l, params);
+        }
+        automorphism_finish(results + c, acc, sample, ak, tmp);
+    }
+
+    delete_TLweSampleFFT(acc);
+    delete_LagrangeHalfCPolynomial_array(l, tau_dec);
+    delete_LagrangeHalfCPolynomial_array(k * l, dec);
+    delete_TorusPolynomial(tmp);
+}
@@ -52,8 +52,7 @@ EXPORT void destroy_TLweSampleFFT(TLweSampleFFT *obj) {
 EXPORT void tLweToFFTConvert(TLweSampleFFT *result, const TLweSample *source, const TLweParams *params) {
     const int32_t k = params->k;
 
-    for (int32_t i = 0; i <= k; ++i)
-        TorusPolynomial_ifft(result->a + i, source->a + i);
+    TorusPolynomial_ifft_batch(result->a, source->a, k + 1);
     result->current_variance = source->current_variance;
 }
 #endif
@@ -65,8 +64,7 @@ EXPORT void tLweToFFTConvert(TLweSampleFFT *result, const TLweSample *source, co
 EXPORT void tLweFromFFTConvert(TLweSample *result, const TLweSampleFFT *source, const TLweParams *params) {
     const int32_t k = params->k;
 
-    for (int32_t i = 0; i <= k; ++i)
-        TorusPolynomial_fft(result->a + i, source->a + i);
+    TorusPolynomial_fft_batch(result->a, source->a, k + 1);
     result->current_variance = source->current_variance;
 }
 #endif
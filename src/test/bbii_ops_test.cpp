@@ -0,0 +1,193 @@
+/*
+ * bbii_ops_test.cpp
+ * Tests the MK-RLWE operations of src/libbbii (mk_ops.h, mk_methods.h)
+ * against the straightforward TLWE-based computations (N=1024, k=2 parties)
+ */
+
+#include <gtest/gtest.h>
+#include <tfhe.h>
+#include <polynomials.h>
+#include <polynomials_arithmetic.h>
+#include <tgsw_functions.h>
+#include <numeric_functions.h>
+// (the bb_params.h of this directory is not the one of src/libbbii: mk_ops.h brings the right one)
+#include "mk_ops.h"
+#include "mk_methods.h"
+
+using namespace std;
+
+namespace {
+
+    const int32_t NBTRIALS = 5;
+    const int32_t parties = 2;
+    /* the Lagrange-space sums are done in another order than the reference: only the rounding differs */
+    const double toler = 1e-6;
+    /* over a whole blind rotation, the rounding differences can move a decomposition digit. With noiseless
+     * keys this changes the result by at most the precision Bg^-l of the decomposition (1e-6) per CMux */
+    const double toler_rotate = 1e-4;
+
+    class BBIIOpsTest : public ::testing::Test {
+    public:
+        const TFheGateBootstrappingParameterSet *params;
+        MKSecretKey *sk;
+        TGswSampleFFT *bk[2];
+
+        void SetUp() override {
+            params = get_shared_bbii_params(2, 2, 1024)->tfhe_params;
+            sk = new MKSecretKey(params);
+            TGswSample *tmp = new_TGswSample(params->tgsw_params);
+            for (int32_t bit = 0; bit < 2; ++bit) {
+                bk[bit] = new_TGswSampleFFT(params->tgsw_params);
+                tGswSymEncryptInt(tmp, bit, params->tgsw_params->tlwe_params->alpha_min, sk->rlwe_key);
+                tGswToFFTConvert(bk[bit], tmp, params->tgsw_params);
+            }
+            delete_TGswSample(tmp);
+        }
+
+        void TearDown() override {
+            for (int32_t bit = 0; bit < 2; ++bit) delete_TGswSampleFFT(bk[bit]);
+            delete sk;
+        }
+
+        void uniform(MKRLweSample *r) {
+            for (int32_t i = 0; i <= r->k; ++i) torusPolynomialUniform(r->parts[i]);
+        }
+
+        double dist(const MKRLweSample *a, const MKRLweSample *b) {
+            double d = 0;
+            for (int32_t i = 0; i <= a->k; ++i) d = max(d, torusPolynomialNormInftyDist(a->parts[i], b->parts[i]));
+            return d;
+        }
+
+        void mul_by_xai(MKRLweSample *res, int32_t a, const MKRLweSample *src) {
+            for (int32_t i = 0; i <= src->k; ++i) torusPolynomialMulByXai(res->parts[i], a, src->parts[i]);
+        }
+
+        // each component as the TLWE sample (0, acc_i), multiplied by the whole TGSW sample
+        void external_product_reference(MKRLweSample *res, const TGswSampleFFT *gsw, const MKRLweSample *acc, int32_t pid) {
+            TLweSample *tmp = new_TLweSample(params->tgsw_params->tlwe_params);
+            mk_rlwe_clear(res);
+            for (int32_t i = 0; i <= acc->k; ++i) {
+                torusPolynomialClear(&tmp->a[0]);
+                torusPolynomialCopy(tmp->b, acc->parts[i]);
+                tGswFFTExternMulToTLwe(tmp, gsw, params->tgsw_params);
+                torusPolynomialAddTo(res->parts[i], tmp->b);
+                torusPolynomialAddTo(res->parts[pid], &tmp->a[0]);
+            }
+            delete_TLweSample(tmp);
+        }
+    };
+
+
+    //void mk_external_product(MKRLweSample* res, const TGswSampleFFT* bk, const MKRLweSample* acc, int32_t pid, const TFheGateBootstrappingParameterSet* p);
+    TEST_F(BBIIOpsTest, externalProductMatchesFullTLweProduct) {
+        MKRLweSample acc(parties, params), res(parties, params), expected(parties, params);
+        for (int32_t trial = 0; trial < NBTRIALS; ++trial) {
+            for (int32_t pid = 0; pid < parties; ++pid) {
+                for (int32_t bit = 0; bit < 2; ++bit) {
+                    uniform(&acc);
+                    mk_external_product(&res, bk[bit], &acc, pid, params);
+                    external_product_reference(&expected, bk[bit], &acc, pid);
+                    ASSERT_LE(dist(&res, &expected), toler);
+                }
+            }
+        }
+    }
+
+    // res may alias acc
+    TEST_F(BBIIOpsTest, externalProductInPlace) {
+        MKRLweSample acc(parties, params), expected(parties, params);
+        for (int32_t trial = 0; trial < NBTRIALS; ++trial) {
+            uniform(&acc);
+            external_product_reference(&expected, bk[1], &acc, 1);
+            mk_external_product(&acc, bk[1], &acc, 1, params);
+            ASSERT_LE(dist(&acc, &expected), toler);
+        }
+    }
+
+
+    //void mk_cmux_rotate(MKRLweSample* acc, const TGswSampleFFT* bk, int32_t bar_ai, int32_t pid, const TFheGateBootstrappingParameterSet* p, MKBlindRotateWorkspace* ws);
+    TEST_F(BBIIOpsTest, cmuxRotateMatchesCmux) {
+        MKBlindRotateWorkspace ws(parties, params);
+        MKRLweSample acc(parties, params), rotated(parties, params), expected(parties, params);
+        const int32_t _2N = 2 * acc.N;
+        for (int32_t trial = 0; trial < NBTRIALS; ++trial) {
+            for (int32_t pid = 0; pid < parties; ++pid) {
+                for (int32_t bit = 0; bit < 2; ++bit) {
+                    const int32_t bar_ai = modSwitchFromTorus32(uniformTorus32_distrib(generator), _2N);
+                    uniform(&acc);
+                    mul_by_xai(&rotated, bar_ai, &acc);
+                    mk_cmux(&expected, bk[bit], &acc, &rotated, pid, params, &ws);
+                    mk_cmux_rotate(&acc, bk[bit], bar_ai, pid, params, &ws);
+                    ASSERT_LE(dist(&acc, &expected), toler);
+                }
+            }
+        }
+    }
+
+    //void mk_blind_rotate_cmux(MKRLweSample* acc, const MKRLweSample* bk_input, const MKBootstrappingKey* mk_bk, const TFheGateBootstrappingParameterSet* params, MKBlindRotateWorkspace* ws);
+    // X^{-bar_b} followed by one mk_cmux per (party, coefficient), with noiseless keys
+    // (with real keys, a moved digit changes the masks completely: the products are compared above)
+    TEST_F(BBIIOpsTest, blindRotateCmuxMatchesCmuxSequence) {
+        const int32_t n = params->in_out_params->n;
+        MKBootstrappingKey mk_bk(parties, n, params);
+        TGswSample *tmp = new_TGswSample(params->tgsw_params);
+        for (int32_t u = 0; u < parties; ++u) {
+            for (int32_t i = 0; i < n; ++i) {
+                tGswClear(tmp, params->tgsw_params);
+                tGswAddMuIntH(tmp, (u + i * i) % 2, params->tgsw_params);
+                tGswToFFTConvert(mk_bk.bk_fft[u][i], tmp, params->tgsw_params);
+            }
+        }
+        delete_TGswSample(tmp);
+        MKBlindRotateWorkspace ws(parties, params);
+        MKRLweSample input(parties, params), acc(parties, params), rotated(parties, params), expected(parties, params);
+        const int32_t _2N = 2 * acc.N;
+        for (int32_t trial = 0; trial < NBTRIALS; ++trial) {
+            uniform(&input);
+            uniform(&acc);
+            const int32_t bar_b = modSwitchFromTorus32(input.parts[parties]->coefsT[0], _2N);
+            mul_by_xai(&expected, (_2N - bar_b) % _2N, &acc);
+            for (int32_t u = 0; u < parties; ++u) {
+                for (int32_t i = 0; i < n; ++i) {
+                    const int32_t bar_ai = modSwitchFromTorus32(input.parts[u]->coefsT[i], _2N);
+                    mul_by_xai(&rotated, bar_ai, &expected);
+                    mk_cmux(&expected, mk_bk.bk_fft[u][i], &expected, &rotated, u, params, &ws);
+                }
+            }
+            mk_blind_rotate_cmux(&acc, &input, &mk_bk, params, &ws);
+            ASSERT_LE(dist(&acc, &expected), toler_rotate);
+        }
+    }
+
+    // current_variance: the input variance plus mk_external_product_variance per product,
+    // and only the largest of the two branches for a CMux
+    TEST_F(BBIIOpsTest, varianceTracking) {
+        MKBlindRotateWorkspace ws(parties, params);
+        MKRLweSample in0(parties, params), in1(parties, params), res(parties, params);
+        const double var_prod = mk_external_product_variance(parties, params);
+        ASSERT_GT(var_prod, 0.);
+        ASSERT_EQ(0., res.current_variance);
+
+        uniform(&in0);
+        uniform(&in1);
+        in0.current_variance = 0.01;
+        in1.current_variance = 0.02;
+        mk_external_product(&res, bk[1], &in0, 0, params);
+        ASSERT_DOUBLE_EQ(0.01 + var_prod, res.current_variance);
+        mk_cmux(&res, bk[1], &in0, &in1, 1, params, &ws);
+        ASSERT_DOUBLE_EQ(0.02 + var_prod, res.current_variance);
+        mk_cmux(&in1, bk[0], &in0, &in1, 0, params, &ws);
+        ASSERT_DOUBLE_EQ(0.02 + var_prod, in1.current_variance);
+        mk_cmux_rotate(&in0, bk[1], 3, 1, params, &ws);
+        ASSERT_DOUBLE_EQ(0.01 + var_prod, in0.current_variance);
+
+        mk_rlwe_copy(&res, &in0);
+        ASSERT_EQ(in0.current_variance, res.current_variance);
+        mk_rlwe_addTo(&res, &in1);
+        ASSERT_DOUBLE_EQ(0.03 + 2 * var_prod, res.current_variance);
+        mk_rlwe_clear(&res);
+        ASSERT_EQ(0., res.current_variance);
+    }
+
+}
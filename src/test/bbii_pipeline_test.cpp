@@ -0,0 +1,395 @@
+/*
+ * bbii_pipeline_test.cpp
+ * Tests the batch bootstrapping pipeline of the top-level directory (namespace bbii)
+ * at N=1024, the only size of the FFT processors of libtfhe
+ */
+
+#include <gtest/gtest.h>
+#include <tfhe.h>
+#include <polynomials.h>
+#include <polynomials_arithmetic.h>
+#include <tgsw_functions.h>
+#include <numeric_functions.h>
+// the top-level headers (the test target puts their directory before include/)
+#include "batch_framework.h"
+#include "batch_ops.h"
+#include "hom_dft.h"
+
+using namespace std;
+using namespace bbii;
+
+namespace {
+
+    const int32_t NBTRIALS = 3;
+    /* the Lagrange-space operations only differ from the coefficient ones by the rounding */
+    const double toler = 1e-6;
+    /* small enough for the products of TGSW samples to decrypt exactly (the noise of a product
+     * is about sqrt(kpl*N)*Bg/sqrt(12)*alpha, times the digit of 1/Msize in tGswSymDecrypt) */
+    const double alpha = 1e-9;
+
+    class BBIIPipelineTest : public ::testing::Test {
+    public:
+        const BBIIParams *params;
+        const TGswParams *tgsw_params;
+
+        void SetUp() override {
+            params = &get_bbii_params(2, 3, kLagrangeN);
+            tgsw_params = params->tfhe_params->tgsw_params;
+        }
+
+        // all the rows of the sample are uniform (not a valid encryption, only the linear maps are tested)
+        PackedTRGSW uniform_packed(BatchMode mode = BatchMode::R12) {
+            PackedTRGSW c = acquire_packed<TGswSample>(*params, mode);
+            const int32_t k = tgsw_params->tlwe_params->k;
+            for (int32_t i = 0; i < tgsw_params->kpl; ++i) {
+                for (int32_t j = 0; j <= k; ++j) torusPolynomialUniform(&c.cipher->all_sample[i].a[j]);
+                c.cipher->all_sample[i].current_variance = 0.;
+            }
+            return c;
+        }
+
+        PackedTRGSW copy_packed(const PackedTRGSW &src) {
+            PackedTRGSW c = acquire_packed<TGswSample>(*params, src.mode);
+            for (int32_t i = 0; i < tgsw_params->kpl; ++i)
+                tLweCopy(&c.cipher->all_sample[i], &src.cipher->all_sample[i], tgsw_params->tlwe_params);
+            return c;
+        }
+
+        // message: the sign of each coefficient, or 0 (values in {-1, 0, 1})
+        void random_message(IntPolynomial *m, int32_t nonzero) {
+            const int32_t N = m->N;
+            intPolynomialClear(m);
+            for (int32_t t = 0; t < nonzero; ++t) m->coefs[rand() % N] = (rand() % 2) ? 1 : -1;
+        }
+
+        PackedTRGSW encrypt(const IntPolynomial *m, BatchMode mode, const TGswKey *key) {
+            PackedTRGSW c = acquire_packed<TGswSample>(*params, mode);
+            tGswSymEncrypt(c.cipher, m, alpha, key);
+            return c;
+        }
+
+        // res = a * b mod X^N + 1
+        static void negacyclic_mult(IntPolynomial *res, const IntPolynomial *a, const IntPolynomial *b) {
+            const int32_t N = res->N;
+            intPolynomialClear(res);
+            for (int32_t i = 0; i < N; ++i) {
+                if (a->coefs[i] == 0) continue;
+                for (int32_t j = 0; j < N; ++j) {
+                    if (i + j < N) res->coefs[i + j] += a->coefs[i] * b->coefs[j];
+                    else res->coefs[i + j - N] -= a->coefs[i] * b->coefs[j];
+                }
+            }
+        }
+
+        // the decrypted message is the one expected, mod Msize
+        void expect_decrypts_to(const TGswSample *c, const TGswKey *key, const IntPolynomial *expected, int32_t Msize) {
+            IntPolynomial *dec = new_IntPolynomial(params->N);
+            tGswSymDecrypt(dec, c, key, Msize);
+            for (int32_t i = 0; i < params->N; ++i)
+                ASSERT_EQ(0, ((dec->coefs[i] - expected->coefs[i]) % Msize + Msize) % Msize) << "coefficient " << i;
+            delete_IntPolynomial(dec);
+        }
+
+        double dist(const TGswSample *a, const TGswSample *b) {
+            const int32_t k = tgsw_params->tlwe_params->k;
+            double d = 0;
+            for (int32_t i = 0; i < tgsw_params->kpl; ++i) {
+                for (int32_t j = 0; j <= k; ++j)
+                    d = max(d, torusPolynomialNormInftyDist(&a->all_sample[i].a[j], &b->all_sample[i].a[j]));
+            }
+            return d;
+        }
+    };
+
+
+    //void trgsw_add_to(TGswSampleFFT* res, const TGswSampleFFT* A, const BBIIParams& params);
+    TEST_F(BBIIPipelineTest, fftAddToMatchesCoefficients) {
+        for (int32_t trial = 0; trial < NBTRIALS; ++trial) {
+            PackedTRGSW a = uniform_packed();
+            PackedTRGSW b = uniform_packed();
+            PackedTRGSWFFT a_fft = to_fft(a, *params);
+            PackedTRGSWFFT b_fft = to_fft(b, *params);
+
+            trgsw_add_to(a.cipher, b.cipher, *params);
+            trgsw_add_to(a_fft.cipher, b_fft.cipher, *params);
+            PackedTRGSW back = from_fft(a_fft, *params);
+            ASSERT_LE(dist(back.cipher, a.cipher), toler);
+        }
+    }
+
+    //void trgsw_mul_by_xai(TGswSampleFFT* res, const TGswSampleFFT* input, int32_t delta, const BBIIParams& params);
+    // delta is taken mod 2N, negative or not; res may alias input
+    TEST_F(BBIIPipelineTest, fftMulByXaiMatchesCoefficients) {
+        const int32_t N = params->N;
+        const int32_t deltas[] = {0, 1, 37, N - 1, N, N + 5, 2 * N - 1, 2 * N + 3, -1, -N - 7};
+        PackedTRGSW a = uniform_packed();
+        PackedTRGSWFFT a_fft = to_fft(a, *params);
+        PackedTRGSW expected = acquire_packed<TGswSample>(*params, BatchMode::R12);
+        PackedTRGSWFFT rotated_fft = acquire_packed<TGswSampleFFT>(*params, BatchMode::R12);
+        for (int32_t delta : deltas) {
+            trgsw_mul_by_xai(expected.cipher, a.cipher, delta, *params);
+            trgsw_mul_by_xai(rotated_fft.cipher, a_fft.cipher, delta, *params);
+            PackedTRGSW back = from_fft(rotated_fft, *params);
+            ASSERT_LE(dist(back.cipher, expected.cipher), toler) << "delta = " << delta;
+
+            trgsw_mul_by_xai(rotated_fft.cipher, rotated_fft.cipher, -delta, *params);
+            back = from_fft(rotated_fft, *params);
+            ASSERT_LE(dist(back.cipher, a.cipher), toler) << "delta = " << delta;
+        }
+    }
+
+    //std::vector<PackedTRGSWFFT> hom_dft_inverse(std::vector<PackedTRGSWFFT> inputs, int32_t current_rho, const BBIIParams& params);
+    // (2d)^(rho-1) = 16 inputs, d^(rho-1) = 4 outputs
+    TEST_F(BBIIPipelineTest, fftHomDftInverseMatchesCoefficients) {
+        const int32_t two_d = 2 * params->d;
+        const size_t m = two_d * two_d;
+        vector<PackedTRGSW> inputs, inputs_copy;
+        vector<PackedTRGSWFFT> inputs_fft;
+        for (size_t i = 0; i < m; ++i) {
+            inputs.push_back(uniform_packed());
+            inputs_copy.push_back(copy_packed(inputs.back()));
+            inputs_fft.push_back(to_fft(inputs.back(), *params));
+        }
+
+        vector<PackedTRGSW> expected = hom_dft_inverse(move(inputs_copy), params->rho, *params);
+        vector<PackedTRGSWFFT> result_fft = hom_dft_inverse(move(inputs_fft), params->rho, *params);
+        ASSERT_EQ(size_t(params->d * params->d), expected.size());
+        ASSERT_EQ(expected.size(), result_fft.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_EQ(expected[i].mode, result_fft[i].mode);
+            PackedTRGSW back = from_fft(result_fft[i], *params);
+            ASSERT_LE(dist(back.cipher, expected[i].cipher), toler) << "output " << i;
+        }
+    }
+
+
+    //PackedTRGSW batch_mult(const PackedTRGSW& A, const PackedTRGSW& B, const BBIIParams& params);
+    // each rule of batch_mult_mode, decrypted under the key of the mode of the result:
+    // the data times a transition key carries sigma(m_A) (sigma: X -> X^{-1}) under the key of the transition
+    TEST_F(BBIIPipelineTest, batchMultFollowsTheModes) {
+        const int32_t N = params->N;
+        const int32_t Msize = 8;
+        TGswKey *key = new_TGswKey(tgsw_params);
+        tGswKeyGen(key);
+        TGswKey *r13_key = new_r13_key(key, *params);
+        IntPolynomial *mA = new_IntPolynomial(N), *mB = new_IntPolynomial(N);
+        IntPolynomial *sigma_mA = new_IntPolynomial(N), *expected = new_IntPolynomial(N);
+
+        struct Rule { BatchMode a, b, res; bool sigma; };
+        const Rule rules[] = {
+                {BatchMode::R12, BatchMode::R12, BatchMode::R12, false},
+                {BatchMode::R13, BatchMode::R13, BatchMode::R13, false},
+                {BatchMode::R12, BatchMode::R12_to_R13, BatchMode::R13, true},
+                {BatchMode::R13, BatchMode::R13_to_R12, BatchMode::R12, true},
+                {BatchMode::R12_to_R13, BatchMode::R13, BatchMode::R12_to_R13, false},
+                {BatchMode::R13_to_R12, BatchMode::R12, BatchMode::R13_to_R12, false},
+        };
+        // the key of the samples of each mode (the transitions are under the key of their target)
+        auto key_of = [&](BatchMode m) -> const TGswKey * {
+            return (m == BatchMode::R12 || m == BatchMode::R13_to_R12) ? key : r13_key;
+        };
+        for (const Rule &rule : rules) {
+            random_message(mA, 1);
+            random_message(mB, 20);
+            PackedTRGSW A = encrypt(mA, rule.a, key_of(rule.a));
+            PackedTRGSW B = encrypt(mB, rule.b, key_of(rule.b));
+            if (rule.sigma) intPolynomialAutomorphism(sigma_mA, mA, 2 * N - 1);
+            else intPolynomialCopy(sigma_mA, mA);
+            negacyclic_mult(expected, sigma_mA, mB);
+
+            PackedTRGSW res = batch_mult(A, B, *params);
+            ASSERT_EQ(rule.res, res.mode);
+            expect_decrypts_to(res.cipher, key_of(rule.res), expected, Msize);
+
+            PackedTRGSWFFT A_fft = to_fft(A, *params);
+            PackedTRGSWFFT B_fft = to_fft(B, *params);
+            PackedTRGSWFFT res_fft = batch_mult(A_fft, B_fft, *params);
+            ASSERT_EQ(rule.res, res_fft.mode);
+            PackedTRGSW back = from_fft(res_fft, *params);
+            expect_decrypts_to(back.cipher, key_of(rule.res), expected, Msize);
+        }
+        PackedTRGSW A = encrypt(mA, BatchMode::R12, key);
+        PackedTRGSW B = encrypt(mB, BatchMode::R13_to_R12, key);
+        ASSERT_THROW(batch_mult(A, B, *params), std::invalid_argument);
+
+        delete_IntPolynomial(expected);
+        delete_IntPolynomial(sigma_mA);
+        delete_IntPolynomial(mB);
+        delete_IntPolynomial(mA);
+        delete_TGswKey(r13_key);
+        delete_TGswKey(key);
+    }
+
+    //std::vector<PackedTRGSW> hom_dft_inverse(inputs, current_rho, params, const PackedTRGSW* to_r13, const PackedTRGSW* to_r12);
+    // switching the tensor ring after each level does not change the decrypted outputs,
+    // with an odd (rho = 2) or an even (rho = 3) number of levels
+    TEST_F(BBIIPipelineTest, homDftModeSwitchKeepsTheMessages) {
+        const int32_t N = params->N;
+        const int32_t Msize = 64; // the outputs are sums of 16 monomials
+        const int32_t two_d = 2 * params->d;
+        TGswKey *key = new_TGswKey(tgsw_params);
+        tGswKeyGen(key);
+        PackedTRGSW to_r13 = create_mode_switch_key(BatchMode::R12_to_R13, key, alpha, *params);
+        PackedTRGSW to_r12 = create_mode_switch_key(BatchMode::R13_to_R12, key, alpha, *params);
+        PackedTRGSWFFT to_r13_fft = to_fft(to_r13, *params);
+        PackedTRGSWFFT to_r12_fft = to_fft(to_r12, *params);
+        IntPolynomial *m = new_IntPolynomial(N), *expected = new_IntPolynomial(N);
+
+        for (int32_t rho = 2; rho <= 3; ++rho) {
+            const size_t count = (rho == 2) ? two_d : two_d * two_d;
+            vector<PackedTRGSW> plain, switched;
+            vector<PackedTRGSWFFT> switched_fft;
+            for (size_t i = 0; i < count; ++i) {
+                random_message(m, 1);
+                plain.push_back(encrypt(m, BatchMode::R12, key));
+                switched.push_back(copy_packed(plain.back()));
+                switched_fft.push_back(to_fft(plain.back(), *params));
+            }
+            vector<PackedTRGSW> out_plain = hom_dft_inverse(move(plain), rho, *params);
+            vector<PackedTRGSW> out = hom_dft_inverse(move(switched), rho, *params, &to_r13, &to_r12);
+            vector<PackedTRGSWFFT> out_fft = hom_dft_inverse(move(switched_fft), rho, *params, &to_r13_fft, &to_r12_fft);
+            ASSERT_EQ(out_plain.size(), out.size());
+            ASSERT_EQ(out_plain.size(), out_fft.size());
+            for (size_t i = 0; i < out.size(); ++i) {
+                tGswSymDecrypt(expected, out_plain[i].cipher, key, Msize);
+                ASSERT_EQ(BatchMode::R12, out[i].mode);
+                expect_decrypts_to(out[i].cipher, key, expected, Msize);
+                ASSERT_EQ(BatchMode::R12, out_fft[i].mode);
+                PackedTRGSW back = from_fft(out_fft[i], *params);
+                expect_decrypts_to(back.cipher, key, expected, Msize);
+            }
+        }
+        ASSERT_THROW(hom_dft_inverse(vector<PackedTRGSW>(), 2, *params, &to_r13, nullptr), std::invalid_argument);
+        ASSERT_THROW(hom_dft_inverse(vector<PackedTRGSW>(), 2, *params, &to_r12, &to_r13), std::invalid_argument);
+
+        delete_IntPolynomial(expected);
+        delete_IntPolynomial(m);
+        delete_TGswKey(key);
+    }
+
+
+    //void pack_input_exponents(std::vector<int32_t>& exps, const LweSample* const* inputs, size_t count, int32_t dim, const BBIIParams& params);
+    // against modSwitchFromTorus32 for every coefficient, with a count that is not a multiple of the 16 samples
+    // of a tile and a dim that is not a multiple of its 256 coefficients (then a smaller reuse of the buffer)
+    TEST_F(BBIIPipelineTest, packInputExponentsMatchesModSwitch) {
+        const int32_t _2N = 2 * params->N;
+        const uint32_t offset = params->ms_offset;
+        const Torus32 edges[] = {0, 1, -1, INT32_MIN, INT32_MAX, Torus32(offset - 1), Torus32(offset), Torus32(3 * offset),
+                                 Torus32(uint32_t(0) - offset), Torus32(uint32_t(0) - offset - 1)};
+        const size_t counts[] = {37, 5};
+        const int32_t dims[] = {300, 17};
+        vector<int32_t> exps;
+        for (int32_t trial = 0; trial < 2; ++trial) {
+            const size_t count = counts[trial];
+            const int32_t dim = dims[trial];
+            LweParams *lwe_params = new_LweParams(dim, 0., 0.5);
+            LweSample *samples = new_LweSample_array(count, lwe_params);
+            vector<const LweSample *> inputs(count);
+            for (size_t i = 0; i < count; ++i) {
+                for (int32_t j = 0; j < dim; ++j) samples[i].a[j] = uniformTorus32_distrib(generator);
+                inputs[i] = samples + i;
+            }
+            for (size_t e = 0; e < sizeof(edges) / sizeof(edges[0]); ++e) samples[count - 1].a[e] = edges[e];
+
+            pack_input_exponents(exps, inputs.data(), count, dim, *params);
+            ASSERT_EQ(size_t(dim) * count, exps.size());
+            for (int32_t j = 0; j < dim; ++j) {
+                for (size_t i = 0; i < count; ++i)
+                    ASSERT_EQ(modSwitchFromTorus32(inputs[i]->a[j], _2N), exps[j * count + i]) << "sample " << i << ", coefficient " << j;
+            }
+            delete_LweSample_array(count, samples);
+            delete_LweParams(lwe_params);
+        }
+    }
+
+    //std::vector<PackedTRGSW> batch_vec_mat_mult(const std::vector<int32_t>& exps, size_t count, const std::vector<std::vector<PackedTRGSW>>& keys, const BBIIParams& params);
+    // block b sums the rows i * bits + t of the bits t of the exponents of coefficient b
+    TEST_F(BBIIPipelineTest, batchVecMatMultSelectsTheExponentBits) {
+        const int32_t bits = exponent_bits(*params);
+        const size_t count = 3;
+        const size_t blocks = 2;
+        ASSERT_EQ(2 * params->N, 1 << bits);
+        // coefficient b of the inputs i (exps[b * count + i]), and one more coefficient that no block reads
+        const vector<int32_t> exps = {0, 1, 2 * params->N - 1,
+                                      0x155, 0, 0x2aa,
+                                      7, 7, 7};
+        vector<vector<PackedTRGSW>> keys(blocks);
+        vector<vector<PackedTRGSWFFT>> keys_fft(blocks);
+        for (size_t b = 0; b < blocks; ++b) {
+            for (size_t r = 0; r < count * bits; ++r) {
+                keys[b].push_back(uniform_packed());
+                keys_fft[b].push_back(to_fft(keys[b].back(), *params));
+            }
+        }
+
+        vector<PackedTRGSW> res = batch_vec_mat_mult(exps, count, keys, *params);
+        vector<PackedTRGSWFFT> res_fft = batch_vec_mat_mult(exps, count, keys_fft, *params);
+        ASSERT_EQ(blocks, res.size());
+        ASSERT_EQ(blocks, res_fft.size());
+        for (size_t b = 0; b < blocks; ++b) {
+            PackedTRGSW expected = create_zero_packed(*params, BatchMode::R12);
+            for (size_t i = 0; i < count; ++i) {
+                for (int32_t t = 0; t < bits; ++t) {
+                    if ((exps[b * count + i] >> t) & 1) trgsw_add_to(expected.cipher, keys[b][i * bits + t].cipher, *params);
+                }
+            }
+            ASSERT_LE(dist(res[b].cipher, expected.cipher), toler) << "block " << b;
+            PackedTRGSW back = from_fft(res_fft[b], *params);
+            ASSERT_LE(dist(back.cipher, expected.cipher), toler) << "block " << b;
+        }
+
+        // a block for each coefficient at most, count * bits rows in each block at least
+        vector<vector<PackedTRGSW>> too_many(4);
+        ASSERT_THROW(batch_vec_mat_mult(exps, count, too_many, *params), std::invalid_argument);
+        keys[1].pop_back();
+        ASSERT_THROW(batch_vec_mat_mult(exps, count, keys, *params), std::invalid_argument);
+    }
+
+
+    //void batch_sample_extract(LweSample* const* out, size_t count, const std::vector<PackedTRGSW>& C, const BBIIParams& params);
+    //void batch_key_switch(LweSample* const* out, const LweKeySwitchKey* ks, const LweSample* const* in, size_t count);
+    // the bits at the slot positions of TGSW samples under the key of a gate keyset,
+    // extracted then key-switched: bootsSymDecrypt gives the bits back (both domains)
+    TEST_F(BBIIPipelineTest, sampleExtractKeySwitchRoundTrip) {
+        const int32_t N = params->N;
+        const size_t outputs = 2;
+        const size_t count = 10; // 5 slots per output, at the coefficients 0, 204, 408, 612 and 816
+        const size_t slots = (count + outputs - 1) / outputs;
+        const TLweParams *tlwe_params = tgsw_params->tlwe_params;
+        TFheGateBootstrappingSecretKeySet *keyset = new_random_gate_bootstrapping_secret_keyset(params->tfhe_params);
+        IntPolynomial *m = new_IntPolynomial(N);
+
+        vector<int32_t> bits(count);
+        for (size_t i = 0; i < count; ++i) bits[i] = rand() % 2;
+        vector<PackedTRGSW> C;
+        vector<PackedTRGSWFFT> C_fft;
+        for (size_t w = 0; w < outputs; ++w) {
+            // the other coefficients are not read
+            for (int32_t j = 0; j < N; ++j) m->coefs[j] = rand() % 2;
+            for (size_t s = 0; s < slots && w * slots + s < count; ++s) m->coefs[s * (N / slots)] = bits[w * slots + s];
+            C.push_back(encrypt(m, BatchMode::R12, keyset->tgsw_key));
+            C_fft.push_back(to_fft(C.back(), *params));
+        }
+
+        LweSample *extracted = new_LweSample_array(count, &tlwe_params->extracted_lweparams);
+        LweSample *results = new_LweSample_array(count, params->tfhe_params->in_out_params);
+        vector<LweSample *> extracted_ptrs(count), result_ptrs(count);
+        for (size_t i = 0; i < count; ++i) {
+            extracted_ptrs[i] = extracted + i;
+            result_ptrs[i] = results + i;
+        }
+        for (int32_t domain = 0; domain < 2; ++domain) {
+            if (domain == 0) batch_sample_extract(extracted_ptrs.data(), count, C, *params);
+            else batch_sample_extract(extracted_ptrs.data(), count, C_fft, *params);
+            batch_key_switch(result_ptrs.data(), keyset->cloud.bk->ks, extracted_ptrs.data(), count);
+            for (size_t i = 0; i < count; ++i)
+                ASSERT_EQ(bits[i], bootsSymDecrypt(results + i, keyset)) << "sample " << i << ", domain " << domain;
+        }
+
+        delete_LweSample_array(count, results);
+        delete_LweSample_array(count, extracted);
+        delete_IntPolynomial(m);
+        delete_gate_bootstrapping_secret_keyset(keyset);
+    }
+
+}
@@ -3,6 +3,7 @@
 #define TFHE_TEST_ENVIRONMENT
 
 #include "tfhe.h"
+#include "../libtfhe/tfhe_thread_pool.h"
 #include "fakes/lwe.h"
 #include "fakes/lwe-bootstrapping-fft.h"
 
@@ -48,6 +49,12 @@ namespace {
         USE_FAKE_lweKeySwitch;
         USE_FAKE_tfhe_bootstrap_woKS_FFT;
         USE_FAKE_tfhe_bootstrap_FFT;
+        USE_FAKE_tfhe_bootstrap_woKS_FFT_ws;
+        USE_FAKE_tfhe_bootstrap_FFT_ws;
+        USE_FAKE_tfhe_local_bootstrap_workspace;
+        USE_FAKE_tfhe_reserve_bootstrap_workspace_batch;
+        USE_FAKE_tfhe_bootstrap_woKS_FFT_batch_ws;
+        USE_FAKE_tfhe_bootstrap_FFT_batch_ws;
 
 #include "../libtfhe/boot-gates.cpp"
 
@@ -161,6 +168,78 @@ namespace {
             fake_delete_LweSample(res);
         }
 
+        /**
+         * test template for a batched binary gate: the truth table is
+         * repeated over more gates than one batch holds
+         */
+        void binary_gate_batch_test(
+                bool (*model_gate)(bool, bool), //the ideal gate
+                void (*boots_gate)(LweSample *, const LweSample *, const LweSample *, int32_t,
+                                   const TFheGateBootstrappingCloudKeySet *)
+        ) {
+            const int32_t count = 2 * TFHE_BOOTSTRAP_BATCH_SIZE + 3;
+            LweSample *a = fake_new_LweSample_array(count, LWE_PARAMS);
+            LweSample *b = fake_new_LweSample_array(count, LWE_PARAMS);
+            LweSample *c = fake_new_LweSample_array(count, LWE_PARAMS);
+
+            for (int32_t i = 0; i < count; i++) {
+                fake(a + i)->message = (i % 2) ? ENC_TRUE : ENC_FALSE;
+                fake(b + i)->message = ((i / 2) % 2) ? ENC_TRUE : ENC_FALSE;
+                fake(a + i)->current_variance = 0.01;
+                fake(b + i)->current_variance = 0.01;
+            }
+
+            boots_gate(c, a, b, count, CLOUD_KEY); //bootstrapped
+
+            for (int32_t i = 0; i < count; i++) {
+                bool bc = model_gate(i % 2, (i / 2) % 2);  //model
+                ASSERT_EQ(fake(c + i)->message, bc ? ENC_TRUE : ENC_FALSE);
+                ASSERT_LE(fake(c + i)->current_variance, 1. / 1024.);
+            }
+
+            fake_delete_LweSample_array(count, a);
+            fake_delete_LweSample_array(count, b);
+            fake_delete_LweSample_array(count, c);
+        }
+
+        /**
+         * test template for the batched mux: the truth table is
+         * repeated over more gates than one batch holds
+         */
+        void ternary_gate_batch_test(
+                bool (*model_gate)(bool, bool, bool), //the ideal gate
+                void (*boots_gate)(LweSample *, const LweSample *, const LweSample *, const LweSample *, int32_t,
+                                   const TFheGateBootstrappingCloudKeySet *)
+        ) {
+            const int32_t count = 3 * TFHE_BOOTSTRAP_BATCH_SIZE + 5;
+            LweSample *res = fake_new_LweSample_array(count, LWE_PARAMS);
+            LweSample *a = fake_new_LweSample_array(count, LWE_PARAMS);
+            LweSample *b = fake_new_LweSample_array(count, LWE_PARAMS);
+            LweSample *c = fake_new_LweSample_array(count, LWE_PARAMS);
+
+            for (int32_t i = 0; i < count; i++) {
+                fake(a + i)->message = ((i >> 0) & 1) ? ENC_TRUE : ENC_FALSE;
+                fake(b + i)->message = ((i >> 1) & 1) ? ENC_TRUE : ENC_FALSE;
+                fake(c + i)->message = ((i >> 2) & 1) ? ENC_TRUE : ENC_FALSE;
+                fake(a + i)->current_variance = 0.01;
+                fake(b + i)->current_variance = 0.01;
+                fake(c + i)->current_variance = 0.01;
+            }
+
+            boots_gate(res, a, b, c, count, CLOUD_KEY); //bootstrapped
+
+            for (int32_t i = 0; i < count; i++) {
+                bool bres = model_gate((i >> 0) & 1, (i >> 1) & 1, (i >> 2) & 1);  //model
+                ASSERT_EQ(fake(res + i)->message, bres ? ENC_TRUE : ENC_FALSE);
+                ASSERT_LE(fake(res + i)->current_variance, 1. / 1024.);
+            }
+
+            fake_delete_LweSample_array(count, a);
+            fake_delete_LweSample_array(count, b);
+            fake_delete_LweSample_array(count, c);
+            fake_delete_LweSample_array(count, res);
+        }
+
 
     };
 
@@ -215,4 +294,26 @@ namespace {
     TEST_F(BootsGateTest, CopyTest) { unary_gate_test(bool_copy, bootsCOPY); }
 
     TEST_F(BootsGateTest, MuxTest) { ternary_gate_test(bool_mux, bootsMUX); }
+
+    TEST_F(BootsGateTest, NandBatchTest) { binary_gate_batch_test(bool_nand, bootsNAND_batch); }
+
+    TEST_F(BootsGateTest, AndBatchTest) { binary_gate_batch_test(bool_and, bootsAND_batch); }
+
+    TEST_F(BootsGateTest, AndNYBatchTest) { binary_gate_batch_test(bool_andny, bootsANDNY_batch); }
+
+    TEST_F(BootsGateTest, AndYNBatchTest) { binary_gate_batch_test(bool_andyn, bootsANDYN_batch); }
+
+    TEST_F(BootsGateTest, NorBatchTest) { binary_gate_batch_test(bool_nor, bootsNOR_batch); }
+
+    TEST_F(BootsGateTest, OrBatchTest) { binary_gate_batch_test(bool_or, bootsOR_batch); }
+
+    TEST_F(BootsGateTest, OrNYBatchTest) { binary_gate_batch_test(bool_orny, bootsORNY_batch); }
+
+    TEST_F(BootsGateTest, OrYNBatchTest) { binary_gate_batch_test(bool_oryn, bootsORYN_batch); }
+
+    TEST_F(BootsGateTest, XorBatchTest) { binary_gate_batch_test(bool_xor, bootsXOR_batch); }
+
+    TEST_F(BootsGateTest, XnorBatchTest) { binary_gate_batch_test(bool_xnor, bootsXNOR_batch); }
+
+    TEST_F(BootsGateTest, MuxBatchTest) { ternary_gate_batch_test(bool_mux, bootsMUX_batch); }
 }
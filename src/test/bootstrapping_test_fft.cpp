@@ -72,6 +72,8 @@ namespace {
 
         USE_FAKE_tGswFFTExternMulToTLwe;
 
+        USE_FAKE_tGswFFTExternMulToTLwe_ws;
+
         USE_FAKE_tLweAddTo;
 
         USE_FAKE_tLweCopy;
@@ -143,6 +145,46 @@ namespace {
         fake_delete_TGswSampleFFT_array(n, bkFFT);
     }
 
+    //EXPORT void tfhe_blindRotate_FFT_ws(TLweSample* accum, const TGswSampleFFT* bk, const int32_t* bara,
+    //      const int32_t n, const TGswParams* bk_params, TfheBootstrapWorkspace* ws)
+    TEST_F(TfheBlindRotateFFTTest, tfheBlindRotateFFTWsTest) {
+
+        vector<bool> key = random_binary_key(n);
+        TGswSampleFFT *bkFFT = fake_new_TGswSampleFFT_array(n, bk_params);
+        FakeTGswFFT *fbkFFT = fake(bkFFT);
+        for (int32_t i = 0; i < n; i++) fbkFFT[i].setMessageVariance(key[i], alpha_bk * alpha_bk);
+
+        //only the temporary of the blind rotation is used (the external product is faked)
+        TfheBootstrapWorkspace ws(n, N, k, l_bk, 0, 0, 0, 0, fake_new_TLweSample(accum_params), 0, 0, 0, 0, 0, 0, 0, 0);
+
+        int32_t *bara = new int32_t[n];
+        for (int32_t i = 0; i < n; i++) bara[i] = rand() % (2 * N);
+        TorusPolynomial *initAccumMessage = new_TorusPolynomial(N);
+        torusPolynomialUniform(initAccumMessage);
+        int32_t expectedOffset = 0;
+        for (int32_t i = 0; i < n; i++) {
+            if (key[i] == 1) expectedOffset = (expectedOffset + bara[i]) % (2 * N);
+        }
+        TorusPolynomial *expectedAccumMessage = new_TorusPolynomial(N);
+        torusPolynomialMulByXai(expectedAccumMessage, expectedOffset, initAccumMessage);
+
+        TLweSample *accum = fake_new_TLweSample(accum_params);
+        FakeTLwe *faccum = fake(accum);
+        torusPolynomialCopy(faccum->message, initAccumMessage);
+        faccum->current_variance = 0.04;
+
+        tfhe_blindRotate_FFT_ws(accum, bkFFT, bara, n, bk_params, &ws);
+        for (int32_t j = 0; j < N; j++) ASSERT_EQ(expectedAccumMessage->coefsT[j], accum->b->coefsT[j]);
+
+        //cleanup everything
+        fake_delete_TLweSample(accum);
+        fake_delete_TLweSample(ws.temp);
+        delete_TorusPolynomial(expectedAccumMessage);
+        delete_TorusPolynomial(initAccumMessage);
+        delete[] bara;
+        fake_delete_TGswSampleFFT_array(n, bkFFT);
+    }
+
 
     class TfheBlindRotateAndExtractFFTTest : public ::testing::Test {
     public:
@@ -167,6 +209,8 @@ namespace {
 
         USE_FAKE_tfhe_blindRotate_FFT;
 
+        USE_FAKE_tfhe_blindRotate_FFT_ws;
+
 #define INCLUDE_TFHE_BLIND_ROTATE_AND_EXTRACT_FFT
 
 #include "../libtfhe/lwe-bootstrapping-functions-fft.cpp"
@@ -220,6 +264,45 @@ namespace {
         fake_delete_TGswSampleFFT_array(n, bkFFT);
     }
 
+    //EXPORT void tfhe_blindRotateAndExtract_FFT_ws(LweSample* result, const TorusPolynomial* v, const TGswSampleFFT* bk,
+    //      const int32_t barb, const int32_t* bara, const int32_t n, const TGswParams* bk_params, TfheBootstrapWorkspace* ws)
+    TEST_F(TfheBlindRotateAndExtractFFTTest, tfheBlindRotateAndExtractFFTWsTest) {
+        const int32_t NB_TRIALS = 30;
+
+        vector<bool> key = random_binary_key(n);
+        TGswSampleFFT *bkFFT = fake_new_TGswSampleFFT_array(n, bk_params);
+        FakeTGswFFT *fbkFFT = fake(bkFFT);
+        for (int32_t i = 0; i < n; i++) fbkFFT[i].setMessageVariance(key[i], alpha_bk * alpha_bk);
+
+        //the accumulator and the rotated test vector come from the workspace
+        TfheBootstrapWorkspace ws(n, N, k, l_bk, 0, 0, 0, fake_new_TLweSample(accum_params), 0, 0,
+                                  new_TorusPolynomial(N), 0, 0, 0, 0, 0, 0);
+
+        int32_t *bara = new int32_t[n];
+        TorusPolynomial *v = new_TorusPolynomial(N);
+        LweSample *result = fake_new_LweSample(&accum_params->extracted_lweparams);
+        FakeLwe *fres = fake(result);
+
+        for (int32_t trial = 0; trial < NB_TRIALS; trial++) {
+            for (int32_t i = 0; i < n; i++) bara[i] = rand() % (2 * N);
+            int32_t barb = rand() % (2 * N);
+            torusPolynomialUniform(v);
+
+            tfhe_blindRotateAndExtract_FFT_ws(result, v, bkFFT, barb, bara, n, bk_params, &ws);
+
+            int32_t offset = barb;
+            for (int32_t i = 0; i < n; i++) offset = (offset + 2 * N - key[i] * bara[i]) % (2 * N);
+            ASSERT_EQ(fres->message, (offset < N) ? (v->coefsT[offset]) : (-v->coefsT[offset - N]));
+        }
+        //clean up
+        fake_delete_LweSample(result);
+        delete_TorusPolynomial(ws.testvectbis);
+        fake_delete_TLweSample(ws.acc);
+        delete_TorusPolynomial(v);
+        delete[] bara;
+        fake_delete_TGswSampleFFT_array(n, bkFFT);
+    }
+
 
     class TfheBootstrapWoKSFFTTest : public ::testing::Test {
     public:
@@ -245,6 +328,8 @@ namespace {
 
         USE_FAKE_tfhe_blindRotateAndExtract_FFT;
 
+        USE_FAKE_tfhe_blindRotateAndExtract_FFT_ws;
+
 #define INCLUDE_TFHE_BOOTSTRAP_WO_KS_FFT
 
 #include "../libtfhe/lwe-bootstrapping-functions-fft.cpp"
@@ -344,6 +429,10 @@ namespace {
 
         USE_FAKE_tfhe_bootstrap_woKS_FFT;
 
+        USE_FAKE_tfhe_bootstrap_woKS_FFT_ws;
+
+        USE_FAKE_tfhe_local_bootstrap_workspace;
+
 #define INCLUDE_TFHE_BOOTSTRAP_FFT
 
 #include "../libtfhe/lwe-bootstrapping-functions-fft.cpp"
@@ -171,6 +171,33 @@ namespace {
     fake_TorusPolynomial_fft(result, p); \
     }
 
+    inline void fake_IntPolynomial_ifft_batch(LagrangeHalfCPolynomial *result, const IntPolynomial *p, const int32_t count) {
+        for (int32_t i = 0; i < count; i++) fake_IntPolynomial_ifft(result + i, p + i);
+    }
+
+#define USE_FAKE_IntPolynomial_ifft_batch \
+    inline void IntPolynomial_ifft_batch(LagrangeHalfCPolynomial* result, const IntPolynomial* p, const int32_t count) { \
+    fake_IntPolynomial_ifft_batch(result, p, count); \
+    }
+
+    inline void fake_TorusPolynomial_ifft_batch(LagrangeHalfCPolynomial *result, const TorusPolynomial *p, const int32_t count) {
+        for (int32_t i = 0; i < count; i++) fake_TorusPolynomial_ifft(result + i, p + i);
+    }
+
+#define USE_FAKE_TorusPolynomial_ifft_batch \
+    inline void TorusPolynomial_ifft_batch(LagrangeHalfCPolynomial* result, const TorusPolynomial* p, const int32_t count) { \
+    fake_TorusPolynomial_ifft_batch(result, p, count); \
+    }
+
+    inline void fake_TorusPolynomial_fft_batch(TorusPolynomial *result, const LagrangeHalfCPolynomial *p, const int32_t count) {
+        for (int32_t i = 0; i < count; i++) fake_TorusPolynomial_fft(result + i, p + i);
+    }
+
+#define USE_FAKE_TorusPolynomial_fft_batch \
+    inline void TorusPolynomial_fft_batch(TorusPolynomial* result, const LagrangeHalfCPolynomial* p, const int32_t count) { \
+    fake_TorusPolynomial_fft_batch(result, p, count); \
+    }
+
 //MISC OPERATIONS
 /** sets to zero */
     inline void fake_LagrangeHalfCPolynomialClear(LagrangeHalfCPolynomial *result) {
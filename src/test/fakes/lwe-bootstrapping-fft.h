@@ -135,6 +135,16 @@ inline void fake_tfhe_createLweBootstrappingKeyFFT(LweBootstrappingKeyFFT* bkFFT
     fake_tfhe_blindRotate_FFT(accum,bkFFT,bara,n,bk_params); \
     }
 
+#define USE_FAKE_tfhe_blindRotate_FFT_ws \
+    inline void tfhe_blindRotate_FFT_ws(TLweSample* accum, \
+        const TGswSampleFFT* bkFFT, \
+        const int32_t* bara, \
+        const int32_t n, \
+        const TGswParams* bk_params, \
+        TfheBootstrapWorkspace* ws) { \
+    fake_tfhe_blindRotate_FFT(accum,bkFFT,bara,n,bk_params); \
+    }
+
 /**
  * result = LWE(v_p) where p=barb-sum(bara_i.s_i) mod 2N
  * @param result the output LWE sample
@@ -179,6 +189,18 @@ inline void fake_tfhe_createLweBootstrappingKeyFFT(LweBootstrappingKeyFFT* bkFFT
     fake_tfhe_blindRotateAndExtract_FFT(result,v,bkFFT,barb,bara,n,bk_params); \
     }
 
+#define USE_FAKE_tfhe_blindRotateAndExtract_FFT_ws \
+    inline void tfhe_blindRotateAndExtract_FFT_ws(LweSample* result, \
+        const TorusPolynomial* v, \
+        const TGswSampleFFT* bkFFT, \
+        const int32_t barb, \
+        const int32_t* bara, \
+        const int32_t n, \
+        const TGswParams* bk_params, \
+        TfheBootstrapWorkspace* ws) { \
+    fake_tfhe_blindRotateAndExtract_FFT(result,v,bkFFT,barb,bara,n,bk_params); \
+    }
+
 
 /**
  * result = LWE(mu) iff phase(x)>0, LWE(-mu) iff phase(x)<0
@@ -204,6 +226,11 @@ inline void fake_tfhe_createLweBootstrappingKeyFFT(LweBootstrappingKeyFFT* bkFFT
     fake_tfhe_bootstrap_woKS_FFT(result, bkFFT, mu, x); \
     }
 
+#define USE_FAKE_tfhe_bootstrap_woKS_FFT_ws \
+    static inline void tfhe_bootstrap_woKS_FFT_ws(LweSample *result, const LweBootstrappingKeyFFT *bkFFT, Torus32 mu, const LweSample *x, TfheBootstrapWorkspace *ws) {\
+    fake_tfhe_bootstrap_woKS_FFT(result, bkFFT, mu, x); \
+    }
+
 
 /**
  * result = LWE(mu) iff phase(x)>0, LWE(-mu) iff phase(x)<0
@@ -230,6 +257,48 @@ inline void fake_tfhe_createLweBootstrappingKeyFFT(LweBootstrappingKeyFFT* bkFFT
         fake_tfhe_bootstrap_FFT(result, bkFFT, mu, x); \
     }
 
+#define USE_FAKE_tfhe_bootstrap_FFT_ws \
+    static inline void tfhe_bootstrap_FFT_ws(LweSample *result, const LweBootstrappingKeyFFT *bkFFT, Torus32 mu, const LweSample *x, TfheBootstrapWorkspace *ws) {\
+        fake_tfhe_bootstrap_FFT(result, bkFFT, mu, x); \
+    }
+
+
+/**
+ * workspace whose gate temporaries are fake LWE samples (the other buffers are not allocated)
+ */
+    inline TfheBootstrapWorkspace *fake_tfhe_local_bootstrap_workspace(const LweBootstrappingKeyFFT *bkFFT) {
+        static TfheBootstrapWorkspace *ws = 0;
+        if (!ws) {
+            ws = new TfheBootstrapWorkspace(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                            fake_new_LweSample(0), fake_new_LweSample(0),
+                                            fake_new_LweSample(0), fake_new_LweSample(0),
+                                            fake_new_LweSample(0));
+            ws->batch_u = fake_new_LweSample_array(TFHE_BOOTSTRAP_BATCH_SIZE, 0);
+            ws->batch_u2 = fake_new_LweSample_array(TFHE_BOOTSTRAP_BATCH_SIZE, 0);
+            ws->batch_in = fake_new_LweSample_array(TFHE_BOOTSTRAP_BATCH_SIZE, 0);
+        }
+        return ws;
+    }
+
+#define USE_FAKE_tfhe_local_bootstrap_workspace \
+    static inline TfheBootstrapWorkspace *tfhe_local_bootstrap_workspace(const LweBootstrappingKeyFFT *bkFFT) {\
+        return fake_tfhe_local_bootstrap_workspace(bkFFT); \
+    }
+
+// the batch buffers of the fake workspace are allocated upfront
+#define USE_FAKE_tfhe_reserve_bootstrap_workspace_batch \
+    static inline void tfhe_reserve_bootstrap_workspace_batch(TfheBootstrapWorkspace *ws, const LweBootstrappingKeyFFT *bkFFT) {}
+
+#define USE_FAKE_tfhe_bootstrap_woKS_FFT_batch_ws \
+    static inline void tfhe_bootstrap_woKS_FFT_batch_ws(LweSample *result, const LweBootstrappingKeyFFT *bkFFT, Torus32 mu, const LweSample *x, const int32_t count, TfheBootstrapWorkspace *ws) {\
+        for (int32_t s = 0; s < count; s++) fake_tfhe_bootstrap_woKS_FFT(result + s, bkFFT, mu, x + s); \
+    }
+
+#define USE_FAKE_tfhe_bootstrap_FFT_batch_ws \
+    static inline void tfhe_bootstrap_FFT_batch_ws(LweSample *result, const LweBootstrappingKeyFFT *bkFFT, Torus32 mu, const LweSample *x, const int32_t count, TfheBootstrapWorkspace *ws) {\
+        for (int32_t s = 0; s < count; s++) fake_tfhe_bootstrap_FFT(result + s, bkFFT, mu, x + s); \
+    }
+
 
 /**
  * result = LWE(mu) iff phase(x)>0, LWE(-mu) iff phase(x)<0
@@ -205,6 +205,12 @@ namespace {
     fake_tGswFFTExternMulToTLwe(accum, gsw, params); \
     }
 
+    // the workspace is not used by the fake
+#define USE_FAKE_tGswFFTExternMulToTLwe_ws \
+    inline void tGswFFTExternMulToTLwe_ws(TLweSample* accum, const TGswSampleFFT* gsw, const TGswParams* params, TfheBootstrapWorkspace* ws) { \
+    fake_tGswFFTExternMulToTLwe(accum, gsw, params); \
+    }
+
     // result = (X^ai -1)*bki  
     inline void fake_tGswFFTMulByXaiMinusOne(TGswSampleFFT *result, const int32_t ai, const TGswSampleFFT *bki,
                                              const TGswParams *params) {
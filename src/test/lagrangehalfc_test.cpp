@@ -217,6 +217,82 @@ TEST(LagrangeHalfcTest, torusPolynomialSubMulRFFT) {
     }
 }
 
+//EXPORT void torusPolynomialAddMulPrepared(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2);
+//EXPORT void torusPolynomialSubMulPrepared(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2);
+TEST(LagrangeHalfcTest, torusPolynomialAddSubMulPrepared) {
+    const int32_t NBTRIALS = 10;
+    const double toler = 1e-9;
+    const int32_t N = 1024;
+    PreparedTorusPolynomial *bfft = new_PreparedTorusPolynomial(N);
+    for (int32_t trials = 0; trials < NBTRIALS; ++trials) {
+        IntPolynomial *a = new_IntPolynomial(N);
+        TorusPolynomial *b = new_TorusPolynomial(N);
+        TorusPolynomial *aB = new_TorusPolynomial(N);
+        TorusPolynomial *aBref = new_TorusPolynomial(N);
+
+        for (int32_t i = 0; i < N; i++) a->coefs[i] = uniformTorus32_distrib(generator) % 1000 - 500;
+        torusPolynomialUniform(b);
+        torusPolynomialPrepare(bfft, b);
+        torusPolynomialUniform(aB);
+        torusPolynomialCopy(aBref, aB);
+
+        torusPolynomialAddMulRKaratsuba(aBref, a, b);
+        torusPolynomialAddMulPrepared(aB, a, bfft);
+        ASSERT_LE(torusPolynomialNormInftyDist(aB, aBref), toler);
+
+        // the prepared operand is unchanged and can be reused
+        torusPolynomialSubMulRKaratsuba(aBref, a, b);
+        torusPolynomialSubMulRKaratsuba(aBref, a, b);
+        torusPolynomialSubMulPrepared(aB, a, bfft);
+        torusPolynomialSubMulPrepared(aB, a, bfft);
+        ASSERT_LE(torusPolynomialNormInftyDist(aB, aBref), toler);
+
+        delete_TorusPolynomial(aBref);
+        delete_TorusPolynomial(aB);
+        delete_TorusPolynomial(b);
+        delete_IntPolynomial(a);
+    }
+    delete_PreparedTorusPolynomial(bfft);
+}
+
+//EXPORT void torusPolynomialAddMulPreparedN(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2, const int32_t count);
+//EXPORT void torusPolynomialSubMulPreparedN(TorusPolynomial* result, const IntPolynomial* poly1, const PreparedTorusPolynomial* poly2, const int32_t count);
+TEST(LagrangeHalfcTest, torusPolynomialAddSubMulPreparedN) {
+    const int32_t NBTRIALS = 10;
+    const double toler = 1e-9;
+    const int32_t N = 1024;
+    const int32_t COUNT = 3;
+    for (int32_t trials = 0; trials < NBTRIALS; ++trials) {
+        IntPolynomial *a = new_IntPolynomial_array(COUNT, N);
+        TorusPolynomial *b = new_TorusPolynomial_array(COUNT, N);
+        PreparedTorusPolynomial *bfft = new_PreparedTorusPolynomial_array(COUNT, N);
+        TorusPolynomial *aB = new_TorusPolynomial(N);
+        TorusPolynomial *aBref = new_TorusPolynomial(N);
+
+        for (int32_t j = 0; j < COUNT; j++) {
+            for (int32_t i = 0; i < N; i++) a[j].coefs[i] = uniformTorus32_distrib(generator) % 1000 - 500;
+            torusPolynomialUniform(&b[j]);
+            torusPolynomialPrepare(&bfft[j], &b[j]);
+        }
+        torusPolynomialUniform(aB);
+        torusPolynomialCopy(aBref, aB);
+
+        for (int32_t j = 0; j < COUNT; j++) torusPolynomialAddMulRKaratsuba(aBref, &a[j], &b[j]);
+        torusPolynomialAddMulPreparedN(aB, a, bfft, COUNT);
+        ASSERT_LE(torusPolynomialNormInftyDist(aB, aBref), toler);
+
+        for (int32_t j = 0; j < COUNT - 1; j++) torusPolynomialSubMulRKaratsuba(aBref, &a[j], &b[j]);
+        torusPolynomialSubMulPreparedN(aB, a, bfft, COUNT - 1);
+        ASSERT_LE(torusPolynomialNormInftyDist(aB, aBref), toler);
+
+        delete_TorusPolynomial(aBref);
+        delete_TorusPolynomial(aB);
+        delete_PreparedTorusPolynomial_array(COUNT, bfft);
+        delete_TorusPolynomial_array(COUNT, b);
+        delete_IntPolynomial_array(COUNT, a);
+    }
+}
+
 /** termwise addTo in Lagrange space */
 //EXPORT void LagrangeHalfCPolynomialAddTo(
 //	LagrangeHalfCPolynomial* accum, 
@@ -255,6 +331,40 @@ TEST(LagrangeHalfcTest, LagrangeHalfCPolynomialAddTo) {
     }
 }
 
+/** result(X) = a(X^e) in Lagrange space */
+//EXPORT void LagrangeHalfCPolynomialAutomorphism(
+//	LagrangeHalfCPolynomial* result,
+//	const LagrangeHalfCPolynomial* a,
+//	const int32_t e);
+TEST(LagrangeHalfcTest, LagrangeHalfCPolynomialAutomorphism) {
+    const double toler = 1e-9;
+    const int32_t N = 1024;
+    const int32_t exponents[] = {1, 3, 5, 1023, 1025, 2047};
+    for (int32_t e : exponents) {
+        TorusPolynomial *a = new_TorusPolynomial(N);
+        TorusPolynomial *tauA = new_TorusPolynomial(N);
+        TorusPolynomial *tauAbis = new_TorusPolynomial(N);
+
+        LagrangeHalfCPolynomial *afft = new_LagrangeHalfCPolynomial(N);
+        LagrangeHalfCPolynomial *tauAfft = new_LagrangeHalfCPolynomial(N);
+
+        torusPolynomialUniform(a);
+        TorusPolynomial_ifft(afft, a);
+        LagrangeHalfCPolynomialAutomorphism(tauAfft, afft, e);
+        TorusPolynomial_fft(tauAbis, tauAfft);
+
+        torusPolynomialAutomorphism(tauA, a, e);
+
+        ASSERT_LE(torusPolynomialNormInftyDist(tauAbis, tauA), toler);
+
+        delete_LagrangeHalfCPolynomial(tauAfft);
+        delete_LagrangeHalfCPolynomial(afft);
+        delete_TorusPolynomial(tauAbis);
+        delete_TorusPolynomial(tauA);
+        delete_TorusPolynomial(a);
+    }
+}
+
 /** termwise multiplication in Lagrange space */
 //NICOLAS: do not test this function (implem dependent)
 //EXPORT void LagrangeHalfCPolynomialMul(
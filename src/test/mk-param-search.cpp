@@ -0,0 +1,82 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include "tfhe.h"
+#include "mkTFHEparams.h"
+#include "mkTFHEnoise.h"
+
+using namespace std;
+
+
+// **********************************************************************************
+// ********************************* MAIN *******************************************
+// **********************************************************************************
+
+// Searches the cheapest (Bgbit, dg, Bksbit, dks, N) for the MK bootstrapped NAND v2m2,
+// according to the noise model of mkTFHEnoise.h and to the benchmark cost model.
+// usage: mk-param-search [parties] [target failure probability]
+
+// LWE side, as in testMKbootNAND_FFT_v2
+static const int32_t n = 560;
+static const double stdevLWE = 0.012467;
+static const double stdevKS = 3.05e-5;
+// RLWE side: the noise for N = 1024, and the same security (log2(1/stdev)/N) for the other N,
+// without going under the precision of Torus32
+static const double bk_stdev_1024 = 3.72e-9;
+
+double bk_stdev(int32_t N) {
+    const double log2_stdev = log2(bk_stdev_1024) * N / 1024.0;
+    return pow(2., max(log2_stdev, -32.));
+}
+
+int32_t main(int32_t argc, char **argv) {
+    const int32_t parties = argc > 1 ? atoi(argv[1]) : 2;
+    const double target = argc > 2 ? atof(argv[2]) : pow(2., -32);
+    const int32_t Ns[] = {512, 1024, 2048};
+
+    if (parties <= 0 || !(target > 0 && target < 1)) {
+        cerr << "usage: " << argv[0] << " [parties] [target failure probability]" << endl;
+        return 1;
+    }
+
+    // the candidates are interned (shared_MKTFHEParams): none of them is deleted
+    const MKTFHEParams *best = 0;
+    double best_cost = 0;
+    int32_t nb_candidates = 0;
+    for (int32_t N : Ns) {
+        const double stdevBK = bk_stdev(N);
+        for (int32_t Bgbit = 1; Bgbit <= 16; ++Bgbit) {
+            for (int32_t dg = 1; Bgbit * dg <= 32; ++dg) {
+                for (int32_t Bksbit = 1; Bksbit <= 8; ++Bksbit) {
+                    for (int32_t dks = 1; Bksbit * dks <= 32; ++dks) {
+                        const MKTFHEParams *params = shared_MKTFHEParams(n, N, 0, stdevLWE, Bksbit, dks, stdevKS,
+                                N, 0, stdevBK, stdevBK, stdevBK, Bgbit, dg, stdevBK, parties);
+                        ++nb_candidates;
+                        const double cost = MKcostBootstrap_v2m2(params);
+                        if (MKfailureProbabilityNAND_v2m2(params) <= target && (!best || cost < best_cost)) {
+                            best = params;
+                            best_cost = cost;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    cout << "parties = " << parties << ", target failure probability = " << target
+         << " (" << nb_candidates << " candidates)" << endl;
+    if (!best) {
+        cout << "no parameter set reaches the target" << endl;
+        return 1;
+    }
+    cout << "N = " << best->N << ", Bgbit = " << best->Bgbit << ", dg = " << best->dg
+         << ", Bksbit = " << best->Bksbit << ", dks = " << best->dks << endl;
+    cout << "stdevBK = " << best->stdevBK << endl;
+    cout << "predicted stdev after bootstrapping... " << sqrt(MKvarianceBootstrap_v2m2(best)) << endl;
+    cout << "predicted failure probability of a NAND... " << MKfailureProbabilityNAND_v2m2(best) << endl;
+    cout << "cost per bootstrapping (multiply-adds)... " << best_cost << endl;
+    if (best->N != 1024)
+        cout << "warning: the FFT processors of this build only multiply polynomials of size 1024" << endl;
+    return 0;
+}
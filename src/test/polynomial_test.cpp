@@ -327,6 +327,63 @@ namespace {
         }
     }
 
+    //  TorusPolynomial = X^a * TorusPolynomial, in place
+    //EXPORT void torusPolynomialMulByXaiInPlace(TorusPolynomial* poly, int32_t a)
+    TEST_F(PolynomialTest, torusPolynomialMulByXaiInPlace) {
+        static const int32_t NB_TRIALS = 50;
+        for (int32_t N: dimensions) {
+            for (int32_t trial = 0; trial < NB_TRIALS; trial++) {
+                const int32_t ai = (uniformTorus32_distrib(generator) & 0x7FFFFFFF) % (2 * N);
+                TorusPolynomial *pols = new_TorusPolynomial_array(2, N);
+                TorusPolynomial *pola = pols + 0;
+                TorusPolynomial *polacopy = pols + 1;
+                torusPolynomialUniform(pola);
+                torusPolynomialCopy(polacopy, pola);
+                torusPolynomialMulByXaiInPlace(pola, ai);
+                //check equality
+                for (int32_t j = 0; j < N; j++) {
+                    ASSERT_EQ(pola->coefsT[j], anticyclic_get(polacopy->coefsT, j - ai, N));
+                }
+                delete_TorusPolynomial_array(2, pols);
+            }
+        }
+    }
+
+    //  TorusPolynomial(X) = TorusPolynomial(X^e), in place or not
+    //EXPORT void torusPolynomialAutomorphism(TorusPolynomial* result, const TorusPolynomial* source, int32_t e)
+    //EXPORT void torusPolynomialAutomorphismInPlace(TorusPolynomial* poly, int32_t e)
+    //EXPORT void intPolynomialAutomorphism(IntPolynomial* result, const IntPolynomial* source, int32_t e)
+    TEST_F(PolynomialTest, polynomialAutomorphism) {
+        static const int32_t NB_TRIALS = 20;
+        for (int32_t N: powers_of_two_dimensions) {
+            for (int32_t trial = 0; trial < NB_TRIALS; trial++) {
+                const int32_t e = (uniformTorus32_distrib(generator) & 0x7FFFFFFF) % (2 * N) | 1;
+                TorusPolynomial *pols = new_TorusPolynomial_array(3, N);
+                TorusPolynomial *pola = pols + 0;
+                TorusPolynomial *polb = pols + 1;
+                TorusPolynomial *polc = pols + 2;
+                IntPolynomial *ipols = new_IntPolynomial_array(2, N);
+                torusPolynomialUniform(pola);
+                torusPolynomialUniform(polb);
+                torusPolynomialCopy(polc, pola);
+                for (int32_t j = 0; j < N; j++) ipols[0].coefs[j] = pola->coefsT[j];
+                torusPolynomialAutomorphism(polb, pola, e);
+                torusPolynomialAutomorphismInPlace(polc, e);
+                intPolynomialAutomorphism(ipols + 1, ipols + 0, e);
+                //the coefficient i goes to i.e mod 2N, negated beyond N
+                for (int32_t i = 0; i < N; i++) {
+                    const int32_t j = int32_t((int64_t(i) * e) % (2 * N));
+                    const Torus32 expected = j < N ? pola->coefsT[i] : -pola->coefsT[i];
+                    ASSERT_EQ(polb->coefsT[j % N], expected);
+                    ASSERT_EQ(polc->coefsT[j % N], expected);
+                    ASSERT_EQ(ipols[1].coefs[j % N], expected);
+                }
+                delete_IntPolynomial_array(2, ipols);
+                delete_TorusPolynomial_array(3, pols);
+            }
+        }
+    }
+
     //  intPolynomial = (X^ai-1) * intPolynomial 
     //EXPORT void intPolynomialMulByXaiMinusOne(IntPolynomial* result, int32_t a, const IntPolynomial* bk)
     TEST_F(PolynomialTest, intPolynomialMulByXaiMinusOne) {
@@ -0,0 +1,94 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include "tfhe.h"
+#include "tlweautomorphism.h"
+
+using namespace std;
+
+
+// **********************************************************************************
+// ********************************* MAIN *******************************************
+// **********************************************************************************
+
+// number of coefficients of phase that do not decrypt to tau_e(m)
+int32_t check_automorphism(const char *name, int32_t e, const TLweSample *result, const TorusPolynomial *tau_mu,
+                           const TLweKey *key, int32_t Msize) {
+    const int32_t N = key->params->N;
+    TorusPolynomial *dechif = new_TorusPolynomial(N);
+    tLweSymDecrypt(dechif, result, key, Msize);
+    int32_t errors = 0;
+    for (int32_t i = 0; i < N; ++i)
+        if (dechif->coefsT[i] != tau_mu->coefsT[i]) ++errors;
+    if (errors) cout << "ERROR!!! " << name << " e=" << e << ": " << errors << " wrong coefficients" << endl;
+    delete_TorusPolynomial(dechif);
+    return errors;
+}
+
+int32_t main(int32_t argc, char **argv) {
+    const int32_t N = 1024;
+    const int32_t k = 1;
+    const int32_t l = 3;
+    const int32_t Bgbit = 10;
+    const int32_t Msize = 8;
+    const double alpha = pow(2., -30);
+    const int32_t nb_autos = 8;
+    const int32_t nb_trials = 4;
+
+    TLweParams *params = new_TLweParams(N, k, alpha, 0.2);
+    TGswParams *gsw_params = new_TGswParams(l, Bgbit, params);
+    TGswKey *key = new_TGswKey(gsw_params);
+    tGswKeyGen(key);
+
+    // the Galois elements 5^j mod 2N, and the conjugation
+    int32_t exponents[nb_autos];
+    exponents[0] = 2 * N - 1;
+    for (int32_t j = 1, g = 5; j < nb_autos; ++j, g = (g * 5) % (2 * N)) exponents[j] = g;
+
+    cout << "generating the automorphism keys..." << endl;
+    TLweAutomorphismKey *aks[nb_autos];
+    for (int32_t c = 0; c < nb_autos; ++c) aks[c] = new_TLweAutomorphismKey(exponents[c], key, alpha);
+
+    TorusPolynomial *mu = new_TorusPolynomial(N);
+    TorusPolynomial *tau_mu = new_TorusPolynomial(N);
+    TLweSample *sample = new_TLweSample(params);
+    TLweSample *direct = new_TLweSample(params);
+    TLweSample *hoisted = new_TLweSample_array(nb_autos, params);
+
+    int32_t errors = 0;
+    for (int32_t trial = 0; trial < nb_trials; ++trial) {
+        for (int32_t i = 0; i < N; ++i) mu->coefsT[i] = modSwitchToTorus32(rand() % Msize, Msize);
+        tLweSymEncrypt(sample, mu, alpha, &key->tlwe_key);
+
+        clock_t begin = clock();
+        for (int32_t c = 0; c < nb_autos; ++c) tLweAutomorphism(direct, sample, aks[c]);
+        clock_t end = clock();
+        cout << "time per direct automorphism (microsecs)... " << (end - begin) / double(nb_autos) << endl;
+
+        begin = clock();
+        tLweHoistedAutomorphisms(hoisted, sample, aks, nb_autos);
+        end = clock();
+        cout << "time per hoisted automorphism (microsecs)... " << (end - begin) / double(nb_autos) << endl;
+
+        for (int32_t c = 0; c < nb_autos; ++c) {
+            torusPolynomialAutomorphism(tau_mu, mu, exponents[c]);
+            tLweAutomorphism(direct, sample, aks[c]);
+            errors += check_automorphism("direct", exponents[c], direct, tau_mu, &key->tlwe_key, Msize);
+            errors += check_automorphism("hoisted", exponents[c], hoisted + c, tau_mu, &key->tlwe_key, Msize);
+        }
+    }
+    cout << (errors ? "FAILED" : "OK") << endl;
+
+    delete_TLweSample_array(nb_autos, hoisted);
+    delete_TLweSample(direct);
+    delete_TLweSample(sample);
+    delete_TorusPolynomial(tau_mu);
+    delete_TorusPolynomial(mu);
+    for (int32_t c = 0; c < nb_autos; ++c) delete_TLweAutomorphismKey(aks[c]);
+    delete_TGswKey(key);
+    delete_TGswParams(gsw_params);
+    delete_TLweParams(params);
+
+    return errors ? 1 : 0;
+}
@@ -0,0 +1,119 @@
+#include <iostream>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include "tfhe.h"
+#include "circuitbootstrapping.h"
+
+using namespace std;
+
+
+// **********************************************************************************
+// ********************************* MAIN *******************************************
+// **********************************************************************************
+
+/*
+ * The TRGSW produced by the circuit bootstrapping must be much less noisy than a gate
+ * bootstrapping output, and the FFT is fixed to N=1024: the parameters below have small
+ * noises to test the functionality, they are not meant to be secure.
+ */
+TFheGateBootstrappingParameterSet *new_test_circuit_bootstrapping_parameters() {
+    static const int32_t N = 1024;
+    static const int32_t k = 1;
+    static const int32_t n = 500;
+    static const int32_t bk_l = 4;
+    static const int32_t bk_Bgbit = 7;
+    static const int32_t ks_basebit = 2;
+    static const int32_t ks_length = 8;
+    static const double ks_stdev = pow(2., -20);
+    static const double bk_stdev = pow(2., -40);
+    static const double max_stdev = 0.012467;
+
+    LweParams *params_in = new_LweParams(n, ks_stdev, max_stdev);
+    TLweParams *params_accum = new_TLweParams(N, k, bk_stdev, max_stdev);
+    TGswParams *params_bk = new_TGswParams(bk_l, bk_Bgbit, params_accum);
+
+    return new TFheGateBootstrappingParameterSet(ks_length, ks_basebit, params_in, params_bk);
+}
+
+int32_t check_lut(const char *name, const LweSample *result, const int32_t *table, int32_t nb_outputs, int32_t x,
+                  const TFheGateBootstrappingSecretKeySet *keyset) {
+    int32_t errors = 0;
+    for (int32_t o = 0; o < nb_outputs; ++o) {
+        int32_t out = bootsSymDecrypt(result + o, keyset);
+        if (out != table[x * nb_outputs + o]) {
+            cout << "ERROR!!! " << name << " x=" << x << " output " << o << " - ";
+            cout << t32tod(lwePhase(result + o, keyset->lwe_key)) << endl;
+            ++errors;
+        }
+    }
+    return errors;
+}
+
+int32_t main(int32_t argc, char **argv) {
+    const int32_t nb_inputs = 8;
+    const int32_t nb_outputs = 6;
+    const int32_t nb_trials = 4;
+    // cb: output TRGSW, private keyswitch: 24 bits of precision
+    const int32_t cb_l = 4;
+    const int32_t cb_Bgbit = 4;
+    const int32_t pks_t = 8;
+    const int32_t pks_basebit = 3;
+    const double pks_stdev = pow(2., -35);
+
+    TFheGateBootstrappingParameterSet *params = new_test_circuit_bootstrapping_parameters();
+    TFheGateBootstrappingSecretKeySet *keyset = new_random_gate_bootstrapping_secret_keyset(params);
+    const LweBootstrappingKeyFFT *bk = keyset->cloud.bkFFT;
+    TGswParams *cb_params = new_TGswParams(cb_l, cb_Bgbit, bk->accum_params);
+
+    cout << "generating the circuit bootstrapping key..." << endl;
+    TfheCircuitBootstrappingKey *cbk = new_TfheCircuitBootstrappingKey(bk, keyset->tgsw_key, cb_params,
+                                                                       pks_t, pks_basebit, pks_stdev);
+
+    int32_t *table = new int32_t[(1 << nb_inputs) * nb_outputs];
+    LweSample *in = new_LweSample_array(nb_inputs, params->in_out_params);
+    LweSample *result = new_LweSample_array(nb_outputs, params->in_out_params);
+    TGswSampleFFT *bits = new_TGswSampleFFT_array(nb_inputs, cb_params);
+
+    int32_t errors = 0;
+    for (int32_t trial = 0; trial < nb_trials; ++trial) {
+        for (int32_t i = 0; i < (1 << nb_inputs) * nb_outputs; ++i) table[i] = rand() % 2;
+        const int32_t x = rand() % (1 << nb_inputs);
+        for (int32_t i = 0; i < nb_inputs; ++i) bootsSymEncrypt(in + i, (x >> i) & 1, keyset);
+
+        clock_t begin = clock();
+        for (int32_t i = 0; i < nb_inputs; ++i) tfhe_circuitBootstrap_FFT(bits + i, cbk, in + i);
+        clock_t end = clock();
+        cout << "time per circuit bootstrapping (microsecs)... " << (end - begin) / double(nb_inputs) << endl;
+
+        begin = clock();
+        tfhe_lutVertical_FFT(result, table, nb_outputs, bits, nb_inputs, cbk);
+        end = clock();
+        cout << "vertical packing LUT (microsecs)... " << (end - begin) / 1. << endl;
+        errors += check_lut("vertical", result, table, nb_outputs, x, keyset);
+
+        begin = clock();
+        tfhe_lutHorizontal_FFT(result, table, nb_outputs, bits, nb_inputs, cbk);
+        end = clock();
+        cout << "horizontal packing LUT (microsecs)... " << (end - begin) / 1. << endl;
+        errors += check_lut("horizontal", result, table, nb_outputs, x, keyset);
+    }
+    cout << (errors ? "FAILED" : "OK") << endl;
+
+    delete_TGswSampleFFT_array(nb_inputs, bits);
+    delete_LweSample_array(nb_outputs, result);
+    delete_LweSample_array(nb_inputs, in);
+    delete[] table;
+    delete_TfheCircuitBootstrappingKey(cbk);
+    delete_TGswParams(cb_params);
+    delete_gate_bootstrapping_secret_keyset(keyset);
+    const TGswParams *params_bk = params->tgsw_params;
+    const TLweParams *params_accum = params_bk->tlwe_params;
+    const LweParams *params_in = params->in_out_params;
+    delete_gate_bootstrapping_parameters(params);
+    delete_TGswParams((TGswParams *) params_bk);
+    delete_TLweParams((TLweParams *) params_accum);
+    delete_LweParams((LweParams *) params_in);
+
+    return errors ? 1 : 0;
+}
@@ -19,6 +19,7 @@
 #include "mkTFHEkeygen.h"
 #include "mkTFHEsamples.h"
 #include "mkTFHEfunctions.h"
+#include "mkTFHEnoise.h"
 
 
 
@@ -83,7 +84,7 @@ int32_t main(int32_t argc, char **argv) {
     LweParams *extractedLWEparams = new_LweParams(n_extract, ks_stdev, max_stdev);
     LweParams *LWEparams = new_LweParams(n, ks_stdev, max_stdev);
     TLweParams *RLWEparams = new_TLweParams(N, k, bk_stdev, max_stdev);
-    MKTFHEParams *MKparams = new_MKTFHEParams(n, n_extract, hLWE, stdevLWE, Bksbit, dks, stdevKS, N, 
+    const MKTFHEParams *MKparams = shared_MKTFHEParams(n, n_extract, hLWE, stdevLWE, Bksbit, dks, stdevKS, N, 
                             hRLWE, stdevRLWEkey, stdevRLWE, stdevRGSW, Bgbit, dg, stdevBK, parties);
 
 
@@ -232,6 +233,9 @@ int32_t main(int32_t argc, char **argv) {
     
     cout << "ERRORS v2m2: " << error_count_v2m2 << " over " << nb_trials << " tests!" << endl;
     cout << "Average time per bootNAND_FFT_v2m2: " << argv_time_NAND_v2m2/nb_trials << " seconds" << endl;
+    cout << "Predicted stdev after bootstrapping... " << sqrt(MKvarianceBootstrap_v2m2(MKparams)) << endl;
+    cout << "Predicted failure probability of a NAND of bootstrapped samples... " 
+         << MKfailureProbabilityNAND_v2m2(MKparams) << endl;
 
     cout << endl << "ERRORS Encrypt/Decrypt: " << error_count_EncDec << " over " << nb_trials << " tests!" << endl;
     
@@ -244,8 +248,7 @@ int32_t main(int32_t argc, char **argv) {
     delete_MKLweKey(MKextractedlwekey);
     delete_MKRLweKey(MKrlwekey);
     delete_MKLweKey(MKlwekey);
-    // delete params
-    delete_MKTFHEParams(MKparams);
+    // delete params (MKparams is shared)
     delete_TLweParams(RLWEparams);
     delete_LweParams(LWEparams);
     delete_LweParams(extractedLWEparams);
@@ -68,6 +68,8 @@ namespace {
 
         USE_FAKE_IntPolynomial_ifft;
 
+        USE_FAKE_IntPolynomial_ifft_batch;
+
         USE_FAKE_tLweFFTAddMulRTo;
 
         //this function generates a totally random fake integer decomposition, using just the address
@@ -86,6 +88,18 @@ namespace {
             fake_tGswTorus32PolynomialDecompH(result, bla, params);
         }
 
+        //the fused version: same fake decomposition, then the fake FFT
+        void tGswTorus32PolynomialDecompHFFT(LagrangeHalfCPolynomial *result, const TorusPolynomial *bla,
+                                             const TGswParams *params) {
+            const int32_t N = params->tlwe_params->N;
+            const int32_t l = params->l;
+            IntPolynomial *dec = new_IntPolynomial_array(l, N);
+            fake_tGswTorus32PolynomialDecompH(dec, bla, params);
+            for (int32_t p = 0; p < l; p++)
+                fake_IntPolynomial_ifft(result + p, dec + p);
+            delete_IntPolynomial_array(l, dec);
+        }
+
 
 #define INCLUDE_ALL
 
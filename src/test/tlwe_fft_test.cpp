@@ -43,6 +43,10 @@ namespace {
 
         USE_FAKE_TorusPolynomial_fft;
 
+        USE_FAKE_TorusPolynomial_ifft_batch;
+
+        USE_FAKE_TorusPolynomial_fft_batch;
+
         USE_FAKE_LagrangeHalfCPolynomialClear;
 
         USE_FAKE_LagrangeHalfCPolynomialAddMul;